@@ -0,0 +1,94 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cpp17/any.hpp>
+
+#include "bench.hpp"
+
+namespace {
+    struct large {
+        char data[128];
+    };
+
+    template <int N>
+    struct message {
+        int value;
+    };
+
+    struct handler {
+        template <int N>
+        int operator()(const message<N>& m) const {
+            return m.value + N;
+        }
+    };
+
+    template <int N>
+    int try_chain(const cpp17::any& a) {
+        if (auto p = cpp17::any_cast<message<N>>(&a)) return handler()(*p);
+        return try_chain<N + 1>(a);
+    }
+    template <>
+    int try_chain<24>(const cpp17::any&) {
+        return -1;
+    }
+} // namespace
+
+int main() {
+    constexpr std::size_t n = 10000000;
+
+    // int and void* are stored inline; large does not fit and takes the previous heap path.
+    bench::run("any<int> construct/destroy", n, [](std::size_t i) {
+        cpp17::any a(static_cast<int>(i));
+        bench::do_not_optimize(a);
+    });
+    bench::run("any<void*> construct/destroy", n, [](std::size_t i) {
+        cpp17::any a(reinterpret_cast<void*>(i));
+        bench::do_not_optimize(a);
+    });
+    bench::run("any<large> construct/destroy (heap)", n, [](std::size_t) {
+        cpp17::any a(large{});
+        bench::do_not_optimize(a);
+    });
+
+    cpp17::any small_src(42);
+    bench::run("any<int> copy", n, [&](std::size_t) {
+        cpp17::any a(small_src);
+        bench::do_not_optimize(a);
+    });
+    cpp17::any large_src(large{});
+    bench::run("any<large> copy (heap)", n, [&](std::size_t) {
+        cpp17::any a(large_src);
+        bench::do_not_optimize(a);
+    });
+
+    bench::run("any<int> move", n, [&](std::size_t) {
+        cpp17::any a(std::move(small_src));
+        small_src = std::move(a);
+        bench::do_not_optimize(small_src);
+    });
+
+    cpp17::any messages[] = {message<0>{1}, message<7>{1}, message<15>{1}, message<23>{1}};
+    bench::run("dispatch over 24 types: any_cast chain", n, [&](std::size_t i) {
+        bench::do_not_optimize(try_chain<0>(messages[i % 4]));
+    });
+    bench::run("dispatch over 24 types: visit_any", n, [&](std::size_t i) {
+        bench::do_not_optimize(cpp17::visit_any<
+                               message<0>, message<1>, message<2>, message<3>, message<4>, message<5>,
+                               message<6>, message<7>, message<8>, message<9>, message<10>, message<11>,
+                               message<12>, message<13>, message<14>, message<15>, message<16>, message<17>,
+                               message<18>, message<19>, message<20>, message<21>, message<22>, message<23>>(messages[i % 4], handler()));
+    });
+}
@@ -0,0 +1,77 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <cpp17/span.hpp>
+#include <cpp17/string_view.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace {
+    struct sample {
+        std::uint64_t timestamp;
+        std::uint32_t sensor;
+        float value;
+    };
+
+    // Fletcher-style checksum over raw bytes
+    std::uint32_t checksum(cpp17::span<const cpp17::byte> bytes) {
+        std::uint32_t a = 1, b = 0;
+        for (cpp17::byte x : bytes) {
+            a += cpp17::to_integer<std::uint32_t>(x);
+            b += a;
+        }
+        return (b << 16) ^ a;
+    }
+} // namespace
+
+int main() {
+    for (std::size_t n : {std::size_t(16), std::size_t(1) << 10, std::size_t(1) << 16}) {
+        std::vector<sample> samples(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            samples[i] = sample{i * 1000, static_cast<std::uint32_t>(i % 7), static_cast<float>(i) * 0.5f};
+        }
+        std::vector<unsigned char> staging;
+        std::size_t iters = (std::size_t(1) << 26) / (n * sizeof(sample));
+        std::string label = std::to_string(n) + " samples: ";
+        cpp17::span<const sample> typed(samples);
+
+        bench::run(label + "hash via memcpy staging", iters, [&](std::size_t) {
+            staging.resize(typed.size_bytes());
+            std::memcpy(staging.data(), typed.data(), typed.size_bytes());
+            bench::do_not_optimize(cpp17::detail::hash_bytes(staging.data(), staging.size()));
+        });
+        bench::run(label + "hash via as_bytes", iters, [&](std::size_t) {
+            auto bytes = cpp17::as_bytes(typed);
+            bench::do_not_optimize(cpp17::detail::hash_bytes(bytes.data(), bytes.size()));
+        });
+
+        bench::run(label + "checksum via memcpy staging", iters, [&](std::size_t) {
+            staging.resize(typed.size_bytes());
+            std::memcpy(staging.data(), typed.data(), typed.size_bytes());
+            bench::do_not_optimize(checksum(cpp17::as_bytes(cpp17::span<const unsigned char>(staging))));
+        });
+        bench::run(label + "checksum via as_bytes", iters, [&](std::size_t) {
+            bench::do_not_optimize(checksum(cpp17::as_bytes(typed)));
+        });
+    }
+}
@@ -0,0 +1,59 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_BENCH_HPP
+#define LIBCPP17_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace bench {
+    template <class T>
+    void do_not_optimize(const T& value) {
+        asm volatile(""
+                     :
+                     : "r,m"(value)
+                     : "memory");
+    }
+
+    inline void clobber() {
+        asm volatile(""
+                     :
+                     :
+                     : "memory");
+    }
+
+    inline void report(const std::string& name, double ns) {
+        std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << std::fixed << std::setprecision(2) << ns << " ns/op" << std::endl;
+    }
+
+    template <class F>
+    double run(const std::string& name, std::size_t iterations, F&& f) {
+        auto begin = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            f(i);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(iterations);
+        report(name, ns);
+        return ns;
+    }
+} // namespace bench
+
+#endif //LIBCPP17_BENCH_HPP
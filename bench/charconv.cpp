@@ -0,0 +1,110 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cpp17/charconv.hpp>
+#include <cpp17/split.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+int main() {
+    constexpr std::size_t count = 1000000;
+    std::mt19937_64 rng(5);
+
+    // CSV-shaped fields: integers and prices with a few decimals
+    std::string ints, prices;
+    std::vector<double> doubles;
+    for (std::size_t i = 0; i < count; ++i) {
+        ints += std::to_string(rng() % 100000000) + ',';
+        prices += std::to_string(rng() % 100000) + '.' + std::to_string(rng() % 100) + ',';
+        std::uint64_t bits = rng() % 0x7fe0000000000000ull;
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        doubles.push_back(d);
+    }
+    std::vector<cpp17::string_view> int_fields, price_fields;
+    for (auto f : cpp17::split(ints, ',').skip_empty()) int_fields.push_back(f);
+    for (auto f : cpp17::split(prices, ',').skip_empty()) price_fields.push_back(f);
+
+    bench::run("int: std::stol(std::string(field))", count, [&](std::size_t i) {
+        bench::do_not_optimize(std::stol(std::string(int_fields[i].data(), int_fields[i].size())));
+    });
+    bench::run("int: std::strtol (needs the terminator)", count, [&](std::size_t i) {
+        bench::do_not_optimize(std::strtol(int_fields[i].data(), nullptr, 10));
+    });
+    bench::run("int: cpp17::from_chars", count, [&](std::size_t i) {
+        long v = 0;
+        cpp17::from_chars(int_fields[i].data(), int_fields[i].data() + int_fields[i].size(), v);
+        bench::do_not_optimize(v);
+    });
+
+    bench::run("price: std::stod(std::string(field))", count, [&](std::size_t i) {
+        bench::do_not_optimize(std::stod(std::string(price_fields[i].data(), price_fields[i].size())));
+    });
+    bench::run("price: std::strtod", count, [&](std::size_t i) {
+        bench::do_not_optimize(std::strtod(price_fields[i].data(), nullptr));
+    });
+    bench::run("price: cpp17::from_chars", count, [&](std::size_t i) {
+        double v = 0;
+        cpp17::from_chars(price_fields[i].data(), price_fields[i].data() + price_fields[i].size(), v);
+        bench::do_not_optimize(v);
+    });
+
+    // 17 significant digits and extreme exponents take the exact path
+    std::vector<std::string> printed;
+    for (std::size_t i = 0; i < count / 10; ++i) {
+        char b[32];
+        std::snprintf(b, sizeof(b), "%.17g", doubles[i]);
+        printed.push_back(b);
+    }
+    bench::run("random double %.17g: std::strtod", printed.size(), [&](std::size_t i) {
+        bench::do_not_optimize(std::strtod(printed[i].c_str(), nullptr));
+    });
+    bench::run("random double %.17g: cpp17::from_chars", printed.size(), [&](std::size_t i) {
+        double v = 0;
+        cpp17::from_chars(printed[i].data(), printed[i].data() + printed[i].size(), v);
+        bench::do_not_optimize(v);
+    });
+
+    char buffer[64];
+    bench::run("int: snprintf %ld", count, [&](std::size_t i) {
+        bench::do_not_optimize(std::snprintf(buffer, sizeof(buffer), "%ld", static_cast<long>(i * 7919)));
+    });
+    bench::run("int: cpp17::to_chars", count, [&](std::size_t i) {
+        bench::do_not_optimize(cpp17::to_chars(buffer, buffer + sizeof(buffer), static_cast<long>(i * 7919)).ptr);
+        bench::clobber();
+    });
+    bench::run("random double: snprintf %.17g", count / 10, [&](std::size_t i) {
+        bench::do_not_optimize(std::snprintf(buffer, sizeof(buffer), "%.17g", doubles[i]));
+    });
+    bench::run("random double: cpp17::to_chars shortest", count / 10, [&](std::size_t i) {
+        bench::do_not_optimize(cpp17::to_chars(buffer, buffer + sizeof(buffer), doubles[i]).ptr);
+        bench::clobber();
+    });
+    bench::run("price: snprintf %.2f", count / 10, [&](std::size_t i) {
+        bench::do_not_optimize(std::snprintf(buffer, sizeof(buffer), "%.2f", static_cast<double>(i) / 100));
+    });
+    bench::run("price: cpp17::to_chars shortest", count / 10, [&](std::size_t i) {
+        bench::do_not_optimize(cpp17::to_chars(buffer, buffer + sizeof(buffer), static_cast<double>(i) / 100).ptr);
+        bench::clobber();
+    });
+}
@@ -0,0 +1,49 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cpp17/compact_optional.hpp>
+#include <cpp17/optional.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace {
+    template <class Optional>
+    void scan(const std::string& name, std::size_t n) {
+        std::vector<Optional> column(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % 8 != 0) column[i] = static_cast<double>(i);
+        }
+        std::cout << name << ": " << (sizeof(Optional) * n) / (1024 * 1024) << " MiB (" << sizeof(Optional) << " bytes/element)" << std::endl;
+
+        bench::run(name + " sum of engaged", 5, [&](std::size_t) {
+            double sum = 0;
+            for (const auto& v : column) {
+                if (v.has_value()) sum += *v;
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+
+    scan<cpp17::optional<double>>("optional<double>", n);
+    scan<cpp17::compact_optional<double, cpp17::nan_policy<double>>>("compact_optional<double, nan>", n);
+}
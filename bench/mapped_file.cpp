@@ -0,0 +1,122 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <cpp17/mapped_file.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "bench.hpp"
+
+namespace {
+    const char* const path = "cpp17_mapped_file_bench.txt";
+    std::size_t file_size = std::size_t(512) << 20;
+
+    void make_file() {
+        std::ofstream out(path, std::ios::binary);
+        std::string block;
+        for (std::size_t i = 0; block.size() < (1 << 20); ++i) {
+            block += "2019-01-01T00:00:00Z host-" + std::to_string(i % 97) + " request " + std::to_string(i) + " ok\n";
+        }
+        for (std::size_t written = 0; written < file_size; written += block.size()) {
+            out.write(block.data(), static_cast<std::streamsize>(block.size()));
+        }
+        file_size = static_cast<std::size_t>(out.tellp());
+    }
+
+    std::size_t count_lines(cpp17::string_view text) {
+        return static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n'));
+    }
+
+    // time until the first line is available and until the whole file is scanned
+    template <class F>
+    void measure(const std::string& name, F f) {
+        auto begin = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point first;
+        std::size_t bytes = 0;
+        std::size_t lines = f([&](cpp17::string_view text) {
+            if (bytes == 0) first = std::chrono::steady_clock::now();
+            bytes += text.size();
+            return count_lines(text);
+        });
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+        double first_ms = std::chrono::duration<double, std::milli>(first - begin).count();
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed << std::setprecision(1) << ms << " ms, "
+                  << std::setw(8) << first_ms << " ms to first byte, " << std::setprecision(2) << bytes / ms / 1e6 << " GB/s (" << lines << " lines)" << std::endl;
+    }
+} // namespace
+
+int main() {
+    make_file();
+
+    // the page cache is warm after make_file, so this measures copying and mapping, not the disk
+    for (int round = 0; round < 2; ++round) {
+        measure("ifstream into std::string", [](const std::function<std::size_t(cpp17::string_view)>& scan) {
+            std::ifstream in(path, std::ios::binary);
+            std::string text(file_size, '\0');
+            in.read(&text[0], static_cast<std::streamsize>(text.size()));
+            return scan(text);
+        });
+        measure("fread into std::string", [](const std::function<std::size_t(cpp17::string_view)>& scan) {
+            std::FILE* f = std::fopen(path, "rb");
+            std::string text(file_size, '\0');
+            std::size_t n = std::fread(&text[0], 1, text.size(), f);
+            std::fclose(f);
+            text.resize(n);
+            return scan(text);
+        });
+        measure("mapped_file", [](const std::function<std::size_t(cpp17::string_view)>& scan) {
+            cpp17::mapped_file file(path);
+            return scan(file);
+        });
+        measure("mapped_file sequential", [](const std::function<std::size_t(cpp17::string_view)>& scan) {
+            cpp17::mapping_options options;
+            options.advice = cpp17::access_advice::sequential;
+            cpp17::mapped_file file(path, options);
+            return scan(file);
+        });
+        measure("mapped_file populate", [](const std::function<std::size_t(cpp17::string_view)>& scan) {
+            cpp17::mapping_options options;
+            options.populate = true;
+            cpp17::mapped_file file(path, options);
+            return scan(file);
+        });
+        measure("mapped_file huge pages", [](const std::function<std::size_t(cpp17::string_view)>& scan) {
+            cpp17::mapping_options options;
+            options.huge_pages = true;
+            cpp17::mapped_file file(path, options);
+            return scan(file);
+        });
+        measure("for_each_window 64 MiB", [](const std::function<std::size_t(cpp17::string_view)>& scan) {
+            std::size_t lines = 0;
+            cpp17::mapping_options options;
+            options.advice = cpp17::access_advice::sequential;
+            cpp17::for_each_window(path, 64 << 20, '\n', [&](cpp17::string_view window) {
+                lines += scan(window);
+            }, options);
+            return lines;
+        });
+    }
+    std::remove(path);
+}
@@ -0,0 +1,173 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <cpp17/mdspan.hpp>
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace {
+    constexpr std::size_t n = 256;
+    constexpr std::size_t tile = 32;
+
+    using dynamic_matrix = cpp17::mdspan<float, cpp17::dextents<std::size_t, 2>>;
+    using static_matrix = cpp17::mdspan<float, cpp17::extents<std::size_t, n, n>>;
+    using const_static_matrix = cpp17::mdspan<const float, cpp17::extents<std::size_t, n, n>>;
+
+    __attribute__((noinline)) float rows_raw(const float* m, std::size_t rows, std::size_t cols) {
+        float sum = 0;
+        for (std::size_t i = 0; i < rows; ++i) {
+            for (std::size_t j = 0; j < cols; ++j) sum += m[i * cols + j];
+        }
+        return sum;
+    }
+    template <class Matrix>
+    __attribute__((noinline)) float rows_mdspan(Matrix m) {
+        float sum = 0;
+        for (std::size_t i = 0; i < m.extent(0); ++i) {
+            for (std::size_t j = 0; j < m.extent(1); ++j) sum += m(i, j);
+        }
+        return sum;
+    }
+
+    __attribute__((noinline)) float columns_raw(const float* m, std::size_t rows, std::size_t cols) {
+        float sum = 0;
+        for (std::size_t j = 0; j < cols; ++j) {
+            for (std::size_t i = 0; i < rows; ++i) sum += m[i * cols + j];
+        }
+        return sum;
+    }
+    template <class Matrix>
+    __attribute__((noinline)) float columns_mdspan(Matrix m) {
+        float sum = 0;
+        for (std::size_t j = 0; j < m.extent(1); ++j) {
+            for (std::size_t i = 0; i < m.extent(0); ++i) sum += m(i, j);
+        }
+        return sum;
+    }
+
+    // C += A * B, i-k-j order inside tiles so the innermost loop runs along rows of B and C
+    __attribute__((noinline)) void matmul_raw(const float* a, const float* b, float* c, std::size_t size) {
+        for (std::size_t i0 = 0; i0 < size; i0 += tile) {
+            for (std::size_t k0 = 0; k0 < size; k0 += tile) {
+                for (std::size_t j0 = 0; j0 < size; j0 += tile) {
+                    for (std::size_t i = i0; i < i0 + tile; ++i) {
+                        for (std::size_t k = k0; k < k0 + tile; ++k) {
+                            float aik = a[i * size + k];
+                            for (std::size_t j = j0; j < j0 + tile; ++j) c[i * size + j] += aik * b[k * size + j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+    template <class ConstMatrix, class Matrix>
+    __attribute__((noinline)) void matmul_mdspan(ConstMatrix a, ConstMatrix b, Matrix c) {
+        const std::size_t size = c.extent(0);
+        for (std::size_t i0 = 0; i0 < size; i0 += tile) {
+            for (std::size_t k0 = 0; k0 < size; k0 += tile) {
+                for (std::size_t j0 = 0; j0 < size; j0 += tile) {
+                    for (std::size_t i = i0; i < i0 + tile; ++i) {
+                        for (std::size_t k = k0; k < k0 + tile; ++k) {
+                            float aik = a(i, k);
+                            for (std::size_t j = j0; j < j0 + tile; ++j) c(i, j) += aik * b(k, j);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    // the same blocking expressed with submdspan tiles
+    template <class ConstMatrix, class Matrix>
+    __attribute__((noinline)) void matmul_submdspan(ConstMatrix a, ConstMatrix b, Matrix c) {
+        const std::size_t size = c.extent(0);
+        for (std::size_t i0 = 0; i0 < size; i0 += tile) {
+            for (std::size_t k0 = 0; k0 < size; k0 += tile) {
+                auto at = cpp17::submdspan(a, std::make_pair(i0, i0 + tile), std::make_pair(k0, k0 + tile));
+                for (std::size_t j0 = 0; j0 < size; j0 += tile) {
+                    auto bt = cpp17::submdspan(b, std::make_pair(k0, k0 + tile), std::make_pair(j0, j0 + tile));
+                    auto ct = cpp17::submdspan(c, std::make_pair(i0, i0 + tile), std::make_pair(j0, j0 + tile));
+                    for (std::size_t i = 0; i < tile; ++i) {
+                        for (std::size_t k = 0; k < tile; ++k) {
+                            float aik = at(i, k);
+                            for (std::size_t j = 0; j < tile; ++j) ct(i, j) += aik * bt(k, j);
+                        }
+                    }
+                }
+            }
+        }
+    }
+} // namespace
+
+int main() {
+    std::vector<float> a(n * n), b(n * n), c(n * n);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        a[i] = static_cast<float>(i % 7) * 0.25f;
+        b[i] = static_cast<float>(i % 5) * 0.5f;
+    }
+    dynamic_matrix dyn(a.data(), n, n);
+    static_matrix fixed(a.data());
+
+    const std::size_t iters = 2000;
+    bench::run("rows: raw pointer", iters, [&](std::size_t) {
+        bench::do_not_optimize(rows_raw(a.data(), n, n));
+    });
+    bench::run("rows: mdspan dextents", iters, [&](std::size_t) {
+        bench::do_not_optimize(rows_mdspan(dyn));
+    });
+    bench::run("rows: mdspan static extents", iters, [&](std::size_t) {
+        bench::do_not_optimize(rows_mdspan(fixed));
+    });
+    bench::run("columns: raw pointer", iters, [&](std::size_t) {
+        bench::do_not_optimize(columns_raw(a.data(), n, n));
+    });
+    bench::run("columns: mdspan dextents", iters, [&](std::size_t) {
+        bench::do_not_optimize(columns_mdspan(dyn));
+    });
+    bench::run("columns: mdspan static extents", iters, [&](std::size_t) {
+        bench::do_not_optimize(columns_mdspan(fixed));
+    });
+    cpp17::mdspan<float, cpp17::dextents<std::size_t, 2>, cpp17::layout_left> transposed(a.data(), n, n);
+    bench::run("columns: layout_left view (row order)", iters, [&](std::size_t) {
+        bench::do_not_optimize(columns_mdspan(transposed));
+    });
+
+    const std::size_t mm_iters = 20;
+    double flops = 2.0 * n * n * n;
+    double ns = bench::run("matmul: raw pointer", mm_iters, [&](std::size_t) {
+        matmul_raw(a.data(), b.data(), c.data(), n);
+    });
+    std::cout << "  " << flops / ns << " GFLOP/s" << std::endl;
+    ns = bench::run("matmul: mdspan dextents", mm_iters, [&](std::size_t) {
+        matmul_mdspan(cpp17::mdspan<const float, cpp17::dextents<std::size_t, 2>>(a.data(), n, n), cpp17::mdspan<const float, cpp17::dextents<std::size_t, 2>>(b.data(), n, n), dynamic_matrix(c.data(), n, n));
+    });
+    std::cout << "  " << flops / ns << " GFLOP/s" << std::endl;
+    ns = bench::run("matmul: mdspan static extents", mm_iters, [&](std::size_t) {
+        matmul_mdspan(const_static_matrix(a.data()), const_static_matrix(b.data()), static_matrix(c.data()));
+    });
+    std::cout << "  " << flops / ns << " GFLOP/s" << std::endl;
+    ns = bench::run("matmul: submdspan tiles, static extents", mm_iters, [&](std::size_t) {
+        matmul_submdspan(const_static_matrix(a.data()), const_static_matrix(b.data()), static_matrix(c.data()));
+    });
+    std::cout << "  " << flops / ns << " GFLOP/s" << std::endl;
+    bench::do_not_optimize(c.data());
+}
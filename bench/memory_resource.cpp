@@ -0,0 +1,118 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cpp17/any.hpp>
+#include <cpp17/memory_resource.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace {
+    constexpr std::size_t batch = 64;
+    constexpr std::size_t rounds = 20000;
+
+    std::size_t block_size(std::size_t i) {
+        return 16 + (i * 24) % 240;
+    }
+
+    // Every thread runs `rounds` requests of `batch` allocations and then frees them all.
+    template <class Setup>
+    void run_threads(const std::string& name, unsigned threads, Setup setup) {
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&setup] {
+                setup();
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double total = static_cast<double>(threads) * rounds * batch;
+        bench::report(name + " x" + std::to_string(threads), std::chrono::duration<double, std::nano>(end - begin).count() / total);
+    }
+
+    void with_resource(cpp17::pmr::memory_resource* r) {
+        void* blocks[batch];
+        for (std::size_t round = 0; round < rounds; ++round) {
+            for (std::size_t i = 0; i < batch; ++i) {
+                blocks[i] = r->allocate(block_size(i));
+            }
+            bench::clobber();
+            for (std::size_t i = 0; i < batch; ++i) {
+                r->deallocate(blocks[i], block_size(i));
+            }
+        }
+    }
+} // namespace
+
+int main() {
+    unsigned max_threads = std::thread::hardware_concurrency();
+    if (max_threads == 0) max_threads = 1;
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        run_threads("malloc/free", threads, [] {
+            void* blocks[batch];
+            for (std::size_t round = 0; round < rounds; ++round) {
+                for (std::size_t i = 0; i < batch; ++i) {
+                    blocks[i] = std::malloc(block_size(i));
+                }
+                bench::clobber();
+                for (std::size_t i = 0; i < batch; ++i) {
+                    std::free(blocks[i]);
+                }
+            }
+        });
+        run_threads("new_delete_resource", threads, [] {
+            with_resource(cpp17::pmr::new_delete_resource());
+        });
+
+        cpp17::pmr::synchronized_pool_resource shared;
+        run_threads("synchronized_pool_resource (shared)", threads, [&shared] {
+            with_resource(&shared);
+        });
+        run_threads("unsynchronized_pool_resource", threads, [] {
+            cpp17::pmr::unsynchronized_pool_resource pool;
+            with_resource(&pool);
+        });
+        run_threads("monotonic_buffer_resource", threads, [] {
+            cpp17::pmr::monotonic_buffer_resource arena;
+            void* blocks[batch];
+            for (std::size_t round = 0; round < rounds; ++round) {
+                for (std::size_t i = 0; i < batch; ++i) {
+                    blocks[i] = arena.allocate(block_size(i));
+                }
+                bench::do_not_optimize(blocks);
+                arena.release();
+            }
+        });
+        run_threads("any<std::string> per-request arena", threads, [] {
+            char buffer[16384];
+            for (std::size_t round = 0; round < rounds; ++round) {
+                cpp17::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), cpp17::pmr::null_memory_resource());
+                for (std::size_t i = 0; i < batch; ++i) {
+                    cpp17::any a(std::allocator_arg, &arena, std::string());
+                    bench::do_not_optimize(a);
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,118 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <cpp17/algorithm.hpp>
+#include <cpp17/numeric.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace {
+    // best of a few runs, per element
+    template <class F>
+    double measure(const std::string& name, std::size_t elements, F&& f) {
+        double best = 0;
+        for (int r = 0; r < 5; ++r) {
+            auto begin = std::chrono::steady_clock::now();
+            f();
+            auto end = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(elements);
+            if (r == 0 || ns < best) best = ns;
+        }
+        bench::report(name, best);
+        return best;
+    }
+} // namespace
+
+int main() {
+    const std::size_t n = std::size_t(1) << 23, sort_n = std::size_t(1) << 21;
+    std::vector<double> values(n), output(n);
+    std::mt19937 rng(5);
+    for (auto& v : values) v = std::uniform_real_distribution<double>(0, 1)(rng);
+    std::vector<int> unsorted(sort_n), keys(sort_n);
+    for (auto& k : unsorted) k = static_cast<int>(rng());
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    double seq_for_each = measure("for_each: std", n, [&] {
+        std::for_each(values.begin(), values.end(), [](double& v) { v = std::sqrt(v * v + 1.0) - 1.0; });
+    });
+    double seq_reduce = measure("reduce: std::accumulate", n, [&] {
+        bench::do_not_optimize(std::accumulate(values.begin(), values.end(), 0.0));
+    });
+    double seq_transform = measure("transform: std", n, [&] {
+        std::transform(values.begin(), values.end(), output.begin(), [](double v) { return v * 2.0 + 1.0; });
+        bench::clobber();
+    });
+    double seq_scan = measure("inclusive_scan: std::partial_sum", n, [&] {
+        std::partial_sum(values.begin(), values.end(), output.begin());
+        bench::clobber();
+    });
+    double seq_sort = measure("sort: std", sort_n, [&] {
+        keys = unsorted;
+        std::sort(keys.begin(), keys.end());
+    });
+
+    auto speedup = [](double base, double ns) {
+        std::cout << "    speedup " << std::fixed << base / ns << "x" << std::endl;
+    };
+    for (std::size_t threads = 1; threads <= 64; threads *= 2) {
+        cpp17::thread_pool pool(threads - 1);
+        auto par = cpp17::execution::par.on(pool);
+        std::string suffix = " x" + std::to_string(threads);
+        cpp17::span<double> data(values);
+        cpp17::span<const double> input(values);
+
+        speedup(seq_for_each, measure("for_each: par" + suffix, n, [&] {
+            cpp17::for_each(par, data, [](double& v) { v = std::sqrt(v * v + 1.0) - 1.0; });
+        }));
+        speedup(seq_reduce, measure("reduce: par" + suffix, n, [&] {
+            bench::do_not_optimize(cpp17::reduce(par, input, 0.0));
+        }));
+        speedup(seq_transform, measure("transform: par" + suffix, n, [&] {
+            cpp17::transform(par, input, cpp17::span<double>(output), [](double v) { return v * 2.0 + 1.0; });
+            bench::clobber();
+        }));
+        speedup(seq_scan, measure("inclusive_scan: par" + suffix, n, [&] {
+            cpp17::inclusive_scan(par, input, cpp17::span<double>(output));
+            bench::clobber();
+        }));
+        speedup(seq_sort, measure("sort: par" + suffix, sort_n, [&] {
+            keys = unsorted;
+            cpp17::sort(par, cpp17::span<int>(keys));
+        }));
+    }
+
+    // grain size on a cheap per-element body: too fine and the task overhead dominates
+    cpp17::thread_pool pool;
+    for (std::size_t grain = 64; grain <= (std::size_t(1) << 20); grain *= 8) {
+        measure("reduce: par grain " + std::to_string(grain), n, [&] {
+            bench::do_not_optimize(cpp17::reduce(cpp17::execution::par.on(pool).with_grain(grain), cpp17::span<const double>(values), 0.0));
+        });
+    }
+}
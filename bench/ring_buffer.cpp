@@ -0,0 +1,243 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <cpp17/ring_buffer.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace {
+    double elapsed_ns(std::chrono::steady_clock::time_point begin) {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    // producer and consumer on their own threads; reports ns per item
+    template <class Produce, class Consume>
+    void throughput(const std::string& name, std::uint64_t items, Produce produce, Consume consume) {
+        auto begin = std::chrono::steady_clock::now();
+        std::thread producer(produce);
+        std::uint64_t sum = consume();
+        producer.join();
+        bench::report(name, elapsed_ns(begin) / static_cast<double>(items));
+        if (sum != items * (items - 1) / 2) std::cout << "  checksum mismatch" << std::endl;
+    }
+
+    struct mutex_queue {
+        std::mutex mutex;
+        std::deque<std::uint64_t> items;
+
+        void push(std::uint64_t v) {
+            std::lock_guard<std::mutex> lock(mutex);
+            items.push_back(v);
+        }
+        bool try_pop(std::uint64_t& v) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (items.empty()) return false;
+            v = items.front();
+            items.pop_front();
+            return true;
+        }
+    };
+
+    // length-prefixed records of 1 to 200 bytes streamed through a byte ring
+    std::vector<char> make_stream(std::size_t bytes) {
+        std::vector<char> stream;
+        std::uint32_t state = 1;
+        while (stream.size() < bytes) {
+            state = state * 1664525u + 1013904223u;
+            std::uint8_t length = static_cast<std::uint8_t>(1 + (state >> 24) % 200);
+            stream.push_back(static_cast<char>(length));
+            stream.insert(stream.end(), length, static_cast<char>(state >> 8));
+        }
+        return stream;
+    }
+
+    // Feeds the stream in 4 KiB reads and parses every complete record in place; a record split by
+    // the wrap-around has to be copied out unless the ring is mirrored.
+    std::uint64_t parse_stream(cpp17::ring_buffer<char>& ring, const std::vector<char>& stream, std::uint64_t& copied) {
+        std::uint64_t checksum = 0;
+        char record[256];
+        std::size_t fed = 0;
+        while (fed < stream.size() || !ring.empty()) {
+            std::size_t chunk = stream.size() - fed < 4096 ? stream.size() - fed : 4096;
+            fed += ring.push(cpp17::span<const char>(stream.data() + fed, chunk));
+            for (;;) {
+                // the length byte is always in the first segment
+                auto data = ring.readable();
+                if (data.empty()) break;
+                std::size_t length = static_cast<std::uint8_t>(data.first[0]);
+                if (data.size() < length + 1) break;
+                const char* p;
+                if (data.first.size() >= length + 1) {
+                    p = data.first.data() + 1;
+                } else {
+                    std::size_t head = data.first.size() - 1;
+                    std::memcpy(record, data.first.data() + 1, head);
+                    std::memcpy(record + head, data.second.data(), length - head);
+                    p = record;
+                    ++copied;
+                }
+                checksum += static_cast<unsigned char>(p[length - 1]) + length;
+                ring.consume(length + 1);
+            }
+        }
+        return checksum;
+    }
+} // namespace
+
+int main() {
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    const std::uint64_t items = 20000000;
+
+    {
+        cpp17::spsc_ring_buffer<std::uint64_t> queue(4096);
+        throughput("spsc: try_push / try_pop", items, [&] {
+            for (std::uint64_t i = 0; i < items;) {
+                if (queue.try_push(i)) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            } }, [&] {
+            std::uint64_t sum = 0, v;
+            for (std::uint64_t n = 0; n < items;) {
+                if (queue.try_pop(v)) {
+                    sum += v;
+                    ++n;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            return sum; });
+    }
+    {
+        cpp17::spsc_ring_buffer<std::uint64_t> queue(4096);
+        throughput("spsc: push / pop spans of 64", items, [&] {
+            std::uint64_t batch[64];
+            for (std::uint64_t i = 0; i < items;) {
+                std::size_t n = items - i < 64 ? static_cast<std::size_t>(items - i) : 64;
+                for (std::size_t k = 0; k < n; ++k) batch[k] = i + k;
+                std::size_t pushed = queue.push(cpp17::span<const std::uint64_t>(batch, n));
+                if (pushed == 0) std::this_thread::yield();
+                i += pushed;
+            } }, [&] {
+            std::uint64_t sum = 0, batch[64];
+            for (std::uint64_t n = 0; n < items;) {
+                std::size_t popped = queue.pop(cpp17::span<std::uint64_t>(batch));
+                if (popped == 0) std::this_thread::yield();
+                for (std::size_t k = 0; k < popped; ++k) sum += batch[k];
+                n += popped;
+            }
+            return sum; });
+    }
+    {
+        cpp17::spsc_ring_buffer<std::uint64_t> queue(4096);
+        throughput("spsc: writable / readable in place", items, [&] {
+            for (std::uint64_t i = 0; i < items;) {
+                auto room = queue.writable(64);
+                std::uint64_t n = 0;
+                for (auto& v : room.first) {
+                    if (i + n == items) break;
+                    v = i + n++;
+                }
+                if (n == room.first.size()) {
+                    for (auto& v : room.second) {
+                        if (i + n == items) break;
+                        v = i + n++;
+                    }
+                }
+                if (n == 0) std::this_thread::yield();
+                queue.commit(static_cast<std::size_t>(n));
+                i += n;
+            } }, [&] {
+            std::uint64_t sum = 0;
+            for (std::uint64_t n = 0; n < items;) {
+                auto data = queue.readable(64);
+                for (auto v : data.first) sum += v;
+                for (auto v : data.second) sum += v;
+                if (data.empty()) std::this_thread::yield();
+                queue.consume(data.size());
+                n += data.size();
+            }
+            return sum; });
+    }
+    {
+        mutex_queue queue;
+        throughput("mutex + std::deque", items, [&] {
+            for (std::uint64_t i = 0; i < items; ++i) queue.push(i); }, [&] {
+            std::uint64_t sum = 0, v;
+            for (std::uint64_t n = 0; n < items;) {
+                if (queue.try_pop(v)) {
+                    sum += v;
+                    ++n;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            return sum; });
+    }
+
+    {
+        // one item bounced between two threads; reports half the round trip
+        const std::uint64_t rounds = 200000;
+        cpp17::spsc_ring_buffer<std::uint64_t> ping(64), pong(64);
+        auto begin = std::chrono::steady_clock::now();
+        std::thread echo([&] {
+            std::uint64_t v;
+            for (std::uint64_t n = 0; n < rounds;) {
+                if (ping.try_pop(v)) {
+                    while (!pong.try_push(v)) std::this_thread::yield();
+                    ++n;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        std::uint64_t v;
+        for (std::uint64_t i = 0; i < rounds; ++i) {
+            ping.try_push(i);
+            while (!pong.try_pop(v)) std::this_thread::yield();
+        }
+        echo.join();
+        bench::report("spsc: one-way latency (ping-pong / 2)", elapsed_ns(begin) / (2.0 * rounds));
+    }
+
+    {
+        const auto stream = make_stream(std::size_t(64) << 20);
+        for (int mirrored = 0; mirrored < 2; ++mirrored) {
+            cpp17::ring_buffer_options options;
+            options.mirrored = mirrored != 0;
+            cpp17::ring_buffer<char> ring(16384, options);
+            std::uint64_t copied = 0;
+            auto begin = std::chrono::steady_clock::now();
+            bench::do_not_optimize(parse_stream(ring, stream, copied));
+            bench::report(std::string("parse records: ") + (mirrored ? "mirrored" : "two segments") + " (ns/byte)", elapsed_ns(begin) / static_cast<double>(stream.size()));
+            std::cout << "  records copied across the wrap: " << copied << std::endl;
+        }
+    }
+}
@@ -0,0 +1,139 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <cpp17/span.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+// The kernels are kept out of line so that their code can be compared with objdump: the span versions
+// are expected to compile to the same instructions as the raw pointer loop.
+namespace kernels {
+    __attribute__((noinline)) void scale_raw(float* data, std::size_t n, float a, float b) {
+        for (std::size_t i = 0; i < n; ++i) {
+            data[i] = data[i] * a + b;
+        }
+    }
+
+    __attribute__((noinline)) void scale_span_index(cpp17::span<float> data, float a, float b) {
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            data[i] = data[i] * a + b;
+        }
+    }
+
+    __attribute__((noinline)) void scale_span_range(cpp17::span<float> data, float a, float b) {
+        for (float& v : data) {
+            v = v * a + b;
+        }
+    }
+
+    __attribute__((noinline)) void prefix_sum_raw(int* data, std::size_t n) {
+        for (std::size_t i = 1; i < n; ++i) {
+            data[i] += data[i - 1];
+        }
+    }
+
+    __attribute__((noinline)) void prefix_sum_span(cpp17::span<int> data) {
+        for (std::size_t i = 1; i < data.size(); ++i) {
+            data[i] += data[i - 1];
+        }
+    }
+
+    // fixed-width packet headers: with a static extent the trip count is a constant, so the loop is
+    // fully unrolled and vectorized without a remainder
+    template <std::size_t N>
+    __attribute__((noinline)) std::uint32_t header_sum_static(cpp17::span<const std::uint8_t, N> header) {
+        std::uint32_t sum = 0;
+        for (std::uint8_t b : header) {
+            sum += b;
+        }
+        return sum;
+    }
+
+    __attribute__((noinline)) std::uint32_t header_sum_dynamic(cpp17::span<const std::uint8_t> header) {
+        std::uint32_t sum = 0;
+        for (std::uint8_t b : header) {
+            sum += b;
+        }
+        return sum;
+    }
+
+    // read-only kernels take span<const T>; span<T> converts implicitly
+    __attribute__((noinline)) long sum(cpp17::span<const int> data) {
+        return std::accumulate(data.begin(), data.end(), 0L);
+    }
+} // namespace kernels
+
+template <std::size_t N>
+void header_sums() {
+    constexpr std::size_t packets = 4096;
+    std::vector<std::uint8_t> buffer(packets * N);
+    for (std::size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = static_cast<std::uint8_t>(i * 31);
+    }
+    cpp17::span<const std::uint8_t> all(buffer);
+    std::string label = std::to_string(N) + "-byte headers: ";
+    std::uint32_t total = 0;
+    bench::run(label + "span<const uint8_t>", packets * 256, [&](std::size_t i) {
+        total += kernels::header_sum_dynamic(all.subspan(i % packets * N, N));
+    });
+    bench::run(label + "span<const uint8_t, N>", packets * 256, [&](std::size_t i) {
+        total += kernels::header_sum_static(cpp17::span<const std::uint8_t, N>(all.data() + i % packets * N, N));
+    });
+    bench::do_not_optimize(total);
+}
+
+int main() {
+    for (std::size_t n : {std::size_t(1) << 10, std::size_t(1) << 16, std::size_t(1) << 22}) {
+        std::vector<float> floats(n, 1.0f);
+        std::vector<int> ints(n, 1);
+        std::size_t iters = (std::size_t(1) << 28) / n;
+        std::string label = std::to_string(n) + " elements: ";
+
+        // a * x + b with a = 1 and b = 0 keeps the data unchanged between iterations
+        bench::run(label + "scale raw pointer", iters, [&](std::size_t) {
+            kernels::scale_raw(floats.data(), floats.size(), 1.0f, 0.0f);
+        });
+        bench::run(label + "scale span[i]", iters, [&](std::size_t) {
+            kernels::scale_span_index(floats, 1.0f, 0.0f);
+        });
+        bench::run(label + "scale span range-for", iters, [&](std::size_t) {
+            kernels::scale_span_range(floats, 1.0f, 0.0f);
+        });
+
+        bench::run(label + "prefix sum raw pointer", iters / 4, [&](std::size_t) {
+            ints.assign(n, 1);
+            kernels::prefix_sum_raw(ints.data(), ints.size());
+        });
+        bench::run(label + "prefix sum span", iters / 4, [&](std::size_t) {
+            ints.assign(n, 1);
+            kernels::prefix_sum_span(ints);
+        });
+        cpp17::span<int> view(ints);
+        bench::do_not_optimize(kernels::sum(view));
+    }
+
+    header_sums<16>();
+    header_sums<32>();
+    header_sums<64>();
+}
@@ -0,0 +1,165 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <cpp17/span_io.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+// record: u32 id, u16 flags, f64 value, u8 tag, varint count, u16-prefixed name
+namespace {
+    const std::size_t records = 1000000;
+
+    template <class Writer>
+    std::size_t encode(cpp17::span<cpp17::byte> buffer) {
+        Writer writer(buffer);
+        const char* names[] = {"sensor", "temperature", "x", "pressure_high_band"};
+        for (std::size_t i = 0; i < records; ++i) {
+            writer.write_fields(static_cast<std::uint32_t>(i), static_cast<std::uint16_t>(i * 7), i * 0.5, static_cast<std::uint8_t>(i));
+            writer.write_varint(i % 1000);
+            writer.template write_string<std::uint16_t>(names[i % 4]);
+        }
+        return writer.position();
+    }
+
+    template <class Writer>
+    std::vector<cpp17::byte> encoded() {
+        std::vector<cpp17::byte> buffer(records * 48);
+        buffer.resize(encode<Writer>(buffer));
+        return buffer;
+    }
+
+    // every run handles the whole buffer; reports ns per record
+    template <class F>
+    void measure(const std::string& name, F&& f) {
+        const int runs = 5;
+        auto begin = std::chrono::steady_clock::now();
+        for (int r = 0; r < runs; ++r) {
+            f();
+        }
+        auto end = std::chrono::steady_clock::now();
+        bench::report(name, std::chrono::duration<double, std::nano>(end - begin).count() / (static_cast<double>(runs) * records));
+    }
+
+    std::uint64_t varint_from(std::istream& in) {
+        std::uint64_t v = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            int c = in.get();
+            if (c == EOF) throw std::out_of_range("truncated varint");
+            v |= std::uint64_t(c & 0x7f) << shift;
+            if ((c & 0x80) == 0) return v;
+        }
+    }
+
+    template <class T>
+    T field_from(std::istream& in) {
+        T v;
+        if (!in.read(reinterpret_cast<char*>(&v), sizeof(T))) throw std::out_of_range("truncated field");
+        return v;
+    }
+
+    // the usual stream-based decoder: one virtual read per field and a std::string per name
+    std::uint64_t decode_istringstream(const std::string& bytes) {
+        std::istringstream in(bytes);
+        std::uint64_t checksum = 0;
+        std::string name;
+        for (std::size_t i = 0; i < records; ++i) {
+            checksum += field_from<std::uint32_t>(in);
+            checksum += field_from<std::uint16_t>(in);
+            checksum += static_cast<std::uint64_t>(field_from<double>(in));
+            checksum += field_from<std::uint8_t>(in);
+            checksum += varint_from(in);
+            name.resize(field_from<std::uint16_t>(in));
+            if (!in.read(&name[0], name.size())) throw std::out_of_range("truncated name");
+            checksum += name.size();
+        }
+        return checksum;
+    }
+
+    template <class Reader>
+    std::uint64_t decode_fields(cpp17::span<const cpp17::byte> bytes) {
+        Reader reader(bytes);
+        std::uint64_t checksum = 0;
+        for (std::size_t i = 0; i < records; ++i) {
+            checksum += reader.template read<std::uint32_t>();
+            checksum += reader.template read<std::uint16_t>();
+            checksum += static_cast<std::uint64_t>(reader.template read<double>());
+            checksum += reader.template read<std::uint8_t>();
+            checksum += reader.read_varint();
+            checksum += reader.template read_string<std::uint16_t>().size();
+        }
+        return checksum;
+    }
+
+    // the fixed-size header is bounds-checked once
+    std::uint64_t decode_batched(cpp17::span<const cpp17::byte> bytes) {
+        cpp17::span_reader reader(bytes);
+        std::uint64_t checksum = 0;
+        for (std::size_t i = 0; i < records; ++i) {
+            reader.require(15);
+            checksum += reader.read_unchecked<std::uint32_t>();
+            checksum += reader.read_unchecked<std::uint16_t>();
+            checksum += static_cast<std::uint64_t>(reader.read_unchecked<double>());
+            checksum += reader.read_unchecked<std::uint8_t>();
+            checksum += reader.read_varint();
+            checksum += reader.read_string<std::uint16_t>().size();
+        }
+        return checksum;
+    }
+} // namespace
+
+int main() {
+    const auto little = encoded<cpp17::span_writer>();
+    const auto big = encoded<cpp17::big_endian_span_writer>();
+    const std::string stream_bytes(reinterpret_cast<const char*>(little.data()), little.size());
+    std::cout << "encoded " << records << " records, " << little.size() << " bytes" << std::endl;
+
+    const std::uint64_t expected = decode_istringstream(stream_bytes);
+    std::uint64_t checksum = 0;
+    auto check = [&] {
+        if (checksum != expected) std::cout << "  checksum mismatch" << std::endl;
+    };
+    measure("decode: std::istringstream", [&] {
+        checksum = decode_istringstream(stream_bytes);
+    });
+    check();
+    measure("decode: span_reader", [&] {
+        checksum = decode_fields<cpp17::span_reader>(little);
+    });
+    check();
+    measure("decode: span_reader, one check per header", [&] {
+        checksum = decode_batched(little);
+    });
+    check();
+    measure("decode: big_endian_span_reader", [&] {
+        checksum = decode_fields<cpp17::big_endian_span_reader>(big);
+    });
+    check();
+
+    std::vector<cpp17::byte> out(little.size());
+    measure("encode: span_writer", [&] {
+        bench::do_not_optimize(encode<cpp17::span_writer>(out));
+    });
+}
@@ -0,0 +1,148 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <cpp17/span_views.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace kernels {
+    constexpr std::size_t channels = 8;
+    constexpr std::size_t batch = 16;
+
+    // per-channel energy of interleaved frames
+    __attribute__((noinline)) void energy_copy(cpp17::span<const float> frames, std::vector<float>& scratch, float* out) {
+        std::size_t n = frames.size() / channels;
+        scratch.resize(n);
+        for (std::size_t c = 0; c < channels; ++c) {
+            for (std::size_t i = 0; i < n; ++i) {
+                scratch[i] = frames[i * channels + c];
+            }
+            float sum = 0;
+            for (float v : scratch) sum += v * v;
+            out[c] = sum;
+        }
+    }
+
+    __attribute__((noinline)) void energy_strided(cpp17::span<const float> frames, float* out) {
+        auto split = cpp17::interleaved(frames, channels);
+        for (std::size_t c = 0; c < channels; ++c) {
+            float sum = 0;
+            for (float v : split[c]) sum += v * v;
+            out[c] = sum;
+        }
+    }
+
+    // one pass over memory, one static-extent frame at a time
+    __attribute__((noinline)) void energy_frames(cpp17::span<const float> frames, float* out) {
+        float sums[channels] = {};
+        for (auto frame : cpp17::chunks<channels>(frames)) {
+            for (std::size_t c = 0; c < frame.size(); ++c) {
+                sums[c] += frame[c] * frame[c];
+            }
+        }
+        for (std::size_t c = 0; c < channels; ++c) out[c] = sums[c];
+    }
+
+    // peak of every batch
+    __attribute__((noinline)) void peaks_raw(const float* data, std::size_t n, float* out) {
+        for (std::size_t b = 0; b < n / batch; ++b) {
+            float peak = data[b * batch];
+            for (std::size_t i = 1; i < batch; ++i) {
+                peak = data[b * batch + i] > peak ? data[b * batch + i] : peak;
+            }
+            out[b] = peak;
+        }
+    }
+
+    __attribute__((noinline)) void peaks_dynamic(cpp17::span<const float> data, float* out) {
+        for (auto chunk : cpp17::chunks(data, batch)) {
+            float peak = chunk[0];
+            for (std::size_t i = 1; i < chunk.size(); ++i) {
+                peak = chunk[i] > peak ? chunk[i] : peak;
+            }
+            *out++ = peak;
+        }
+    }
+
+    __attribute__((noinline)) void peaks_static(cpp17::span<const float> data, float* out) {
+        for (auto chunk : cpp17::chunks<batch>(data)) {
+            float peak = chunk[0];
+            for (std::size_t i = 1; i < chunk.size(); ++i) {
+                peak = chunk[i] > peak ? chunk[i] : peak;
+            }
+            *out++ = peak;
+        }
+    }
+} // namespace kernels
+
+namespace {
+    template <class F>
+    void measure(const std::string& name, std::size_t samples, F&& f) {
+        const int runs = 20;
+        auto begin = std::chrono::steady_clock::now();
+        for (int r = 0; r < runs; ++r) {
+            f();
+        }
+        auto end = std::chrono::steady_clock::now();
+        bench::report(name, std::chrono::duration<double, std::nano>(end - begin).count() / (static_cast<double>(runs) * samples));
+    }
+} // namespace
+
+int main() {
+    const std::size_t frames = std::size_t(1) << 20, samples = frames * kernels::channels;
+    std::vector<float> data(samples);
+    std::mt19937 rng(3);
+    for (auto& v : data) v = std::uniform_real_distribution<float>(-1, 1)(rng);
+    cpp17::span<const float> input(data);
+
+    // all results are per sample
+    float energy[kernels::channels];
+    std::vector<float> scratch;
+    measure("deinterleave: copy channels, then sum", samples, [&] {
+        kernels::energy_copy(input, scratch, energy);
+        bench::do_not_optimize(energy);
+    });
+    measure("deinterleave: strided_span per channel", samples, [&] {
+        kernels::energy_strided(input, energy);
+        bench::do_not_optimize(energy);
+    });
+    measure("deinterleave: chunks<8> frames", samples, [&] {
+        kernels::energy_frames(input, energy);
+        bench::do_not_optimize(energy);
+    });
+
+    std::vector<float> peaks(samples / kernels::batch);
+    measure("batch peaks: raw pointer", samples, [&] {
+        kernels::peaks_raw(data.data(), samples, peaks.data());
+        bench::clobber();
+    });
+    measure("batch peaks: chunks(s, 16)", samples, [&] {
+        kernels::peaks_dynamic(input, peaks.data());
+        bench::clobber();
+    });
+    measure("batch peaks: chunks<16>(s)", samples, [&] {
+        kernels::peaks_static(input, peaks.data());
+        bench::clobber();
+    });
+}
@@ -0,0 +1,96 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cpp17/split.hpp>
+
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "bench.hpp"
+
+namespace {
+    // CSV-like rows: eight numeric or word fields per line, CRLF line endings
+    std::string make_csv(std::size_t bytes) {
+        std::mt19937 rng(3);
+        std::string s;
+        s.reserve(bytes + 128);
+        while (s.size() < bytes) {
+            for (int f = 0; f < 8; ++f) {
+                if (f != 0) s += ',';
+                s += std::to_string(rng() % 1000000);
+            }
+            s += "\r\n";
+        }
+        return s;
+    }
+
+    void throughput(const std::string& name, std::size_t bytes, double ns) {
+        std::cout << "  " << name << ": " << static_cast<double>(bytes) / ns << " GB/s" << std::endl;
+    }
+} // namespace
+
+int main() {
+    const std::string csv = make_csv(64 * 1024 * 1024);
+    const cpp17::string_view text(csv);
+
+    double ns = bench::run("istringstream + getline (64 MiB)", 1, [&](std::size_t) {
+        std::istringstream lines(csv);
+        std::string line, field;
+        std::size_t n = 0;
+        while (std::getline(lines, line)) {
+            std::istringstream fields(line);
+            while (std::getline(fields, field, ',')) n += field.size();
+        }
+        bench::do_not_optimize(n);
+    });
+    throughput("istringstream", csv.size(), ns);
+
+    ns = bench::run("string_view find + substr (64 MiB)", 3, [&](std::size_t) {
+        std::size_t n = 0, pos = 0;
+        while (pos < text.size()) {
+            auto eol = text.find('\n', pos);
+            auto line = text.substr(pos, eol - pos - 1);
+            std::size_t start = 0;
+            for (;;) {
+                auto comma = line.find(',', start);
+                n += (comma == cpp17::string_view::npos ? line.size() : comma) - start;
+                if (comma == cpp17::string_view::npos) break;
+                start = comma + 1;
+            }
+            pos = eol + 1;
+        }
+        bench::do_not_optimize(n);
+    });
+    throughput("find + substr", csv.size(), ns);
+
+    ns = bench::run("cpp17::lines + cpp17::split (64 MiB)", 3, [&](std::size_t) {
+        std::size_t n = 0;
+        for (auto line : cpp17::lines(text)) {
+            for (auto field : cpp17::split(line, ',')) n += field.size();
+        }
+        bench::do_not_optimize(n);
+    });
+    throughput("lines + split", csv.size(), ns);
+
+    ns = bench::run("cpp17::split_any \",\\r\\n\" (64 MiB)", 3, [&](std::size_t) {
+        std::size_t n = 0;
+        for (auto field : cpp17::split_any(text, ",\r\n").skip_empty()) n += field.size();
+        bench::do_not_optimize(n);
+    });
+    throughput("split_any", csv.size(), ns);
+}
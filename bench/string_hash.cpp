@@ -0,0 +1,127 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cpp17/string_view.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace {
+    // keys that differ in few bits: the usual weak spot of cheap hashes
+    std::vector<std::string> make_keys(std::size_t n) {
+        std::vector<std::string> keys;
+        keys.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            keys.push_back("user:" + std::to_string(i) + ":session");
+        }
+        return keys;
+    }
+
+    template <class Hash>
+    void quality(const std::string& name, const std::vector<std::string>& keys, Hash h) {
+        std::unordered_set<std::uint64_t> full;
+        std::vector<std::size_t> buckets(1 << 16);
+        for (auto& k : keys) {
+            std::uint64_t v = h(k);
+            full.insert(v);
+            ++buckets[v & (buckets.size() - 1)];
+        }
+        // chi-squared over the low 16 bits; expect about buckets.size() for a uniform hash
+        double expected = static_cast<double>(keys.size()) / static_cast<double>(buckets.size()), chi2 = 0;
+        for (auto b : buckets) {
+            chi2 += (b - expected) * (b - expected) / expected;
+        }
+        std::cout << name << ": " << keys.size() - full.size() << " full collisions, chi2(low 16 bits) = " << chi2 << " (ideal ~" << buckets.size() << ")" << std::endl;
+    }
+
+    // average number of output bits flipped by a single-bit input change; ideal is 32
+    template <class Hash>
+    void avalanche(const std::string& name, Hash h) {
+        std::mt19937 rng(7);
+        double flipped = 0;
+        std::size_t trials = 0;
+        for (int t = 0; t < 2000; ++t) {
+            std::string s(24, '\0');
+            for (auto& c : s) {
+                c = static_cast<char>(rng());
+            }
+            std::uint64_t base = h(s);
+            for (std::size_t bit = 0; bit < s.size() * 8; ++bit) {
+                s[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+                flipped += __builtin_popcountll(base ^ h(s));
+                s[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+                ++trials;
+            }
+        }
+        std::cout << name << ": avalanche " << flipped / static_cast<double>(trials) << " of 64 bits (ideal 32)" << std::endl;
+    }
+} // namespace
+
+int main() {
+    const auto keys = make_keys(1000000);
+    quality("std::hash<std::string>", keys, std::hash<std::string>());
+    quality("cpp17::string_hash", keys, cpp17::string_hash());
+    avalanche("std::hash<std::string>", std::hash<std::string>());
+    avalanche("cpp17::string_hash", cpp17::string_hash());
+
+    for (std::size_t len : {4, 16, 64, 256, 4096, 1 << 20}) {
+        std::string s(len, 'x');
+        std::size_t iters = (64 << 20) / len;
+        std::string label = std::to_string(len) + " bytes: ";
+        double std_ns = bench::run(label + "std::hash<std::string>", iters, [&](std::size_t i) {
+            s[0] = static_cast<char>(i);
+            bench::do_not_optimize(std::hash<std::string>()(s));
+        });
+        double ns = bench::run(label + "cpp17::string_hash", iters, [&](std::size_t i) {
+            s[0] = static_cast<char>(i);
+            bench::do_not_optimize(cpp17::string_hash()(s));
+        });
+        std::cout << "  " << len / std_ns << " vs " << len / ns << " GB/s" << std::endl;
+    }
+
+    // lookups keyed by std::string but probed with views, e.g. tokens sliced out of a request buffer
+    std::string text;
+    std::vector<cpp17::string_view> probes;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        text += keys[i * 997];
+    }
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        probes.emplace_back(text.data() + offset, keys[i * 997].size());
+        offset += keys[i * 997].size();
+    }
+    std::unordered_map<std::string, int> by_string;
+    std::unordered_map<cpp17::string_view, int> by_view;
+    for (auto& k : keys) {
+        by_string.emplace(k, 1);
+        by_view.emplace(cpp17::string_view(k), 1);
+    }
+    bench::run("probe std::string map with a temporary string", 1000000, [&](std::size_t i) {
+        auto v = probes[i % probes.size()];
+        bench::do_not_optimize(by_string.find(std::string(v.data(), v.size())));
+    });
+    bench::run("probe string_view map with a view", 1000000, [&](std::size_t i) {
+        bench::do_not_optimize(by_view.find(probes[i % probes.size()]));
+    });
+}
@@ -0,0 +1,133 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <cpp17/string_pool.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace {
+    // a token stream with a skewed vocabulary, as produced by a lexer or a log parser
+    std::vector<std::string> make_tokens(std::size_t n, std::size_t vocabulary) {
+        std::mt19937 rng(11);
+        std::vector<std::string> words;
+        for (std::size_t i = 0; i < vocabulary; ++i) {
+            words.push_back("identifier_" + std::to_string(i * 2654435761u % 1000003));
+        }
+        std::vector<std::string> tokens;
+        tokens.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            // squaring a uniform variate favours low indices
+            double u = std::uniform_real_distribution<double>(0, 1)(rng);
+            tokens.push_back(words[static_cast<std::size_t>(u * u * static_cast<double>(vocabulary))]);
+        }
+        return tokens;
+    }
+
+    template <class F>
+    double run_threads(const std::string& name, unsigned threads, std::size_t per_thread, F f) {
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&f, t] {
+                f(t);
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / (static_cast<double>(threads) * per_thread);
+        bench::report(name + " x" + std::to_string(threads), ns);
+        return ns;
+    }
+} // namespace
+
+int main() {
+    const std::size_t n = 2000000, vocabulary = 50000;
+    const auto tokens = make_tokens(n, vocabulary);
+
+    {
+        std::unordered_set<std::string> set;
+        bench::run("intern: unordered_set<std::string>", n, [&](std::size_t i) {
+            bench::do_not_optimize(set.insert(tokens[i]).first->data());
+        });
+        std::unordered_map<std::string, std::uint32_t> ids;
+        bench::run("intern id: unordered_map<std::string, id>", n, [&](std::size_t i) {
+            bench::do_not_optimize(ids.emplace(tokens[i], static_cast<std::uint32_t>(ids.size())).first->second);
+        });
+        cpp17::string_pool pool;
+        bench::run("intern: cpp17::string_pool", n, [&](std::size_t i) {
+            bench::do_not_optimize(pool.intern(tokens[i]));
+        });
+        cpp17::string_pool id_pool;
+        bench::run("intern id: cpp17::string_pool", n, [&](std::size_t i) {
+            bench::do_not_optimize(id_pool.intern_id(tokens[i]));
+        });
+
+        auto s = pool.stats();
+        std::cout << "string_pool: " << s.strings << " strings, " << s.string_bytes << " bytes of text, " << s.arena_bytes << " arena + " << s.table_bytes << " table bytes, " << 100.0 * s.hits / s.interns << "% hits" << std::endl;
+        std::cout << "  std::vector<std::string> of all tokens: " << n * sizeof(std::string) << " bytes + heap for long strings; interned handles: " << n * sizeof(cpp17::interned_string) << " bytes" << std::endl;
+    }
+
+    {
+        // equality on the hot path: interned strings compare one pointer
+        cpp17::string_pool pool;
+        std::vector<cpp17::interned_string> interned;
+        for (auto& t : tokens) interned.push_back(pool.intern(t));
+        const std::string& needle = tokens[n / 2];
+        auto interned_needle = pool.intern(needle);
+        std::size_t hits = 0;
+        bench::run("compare: std::string ==", n, [&](std::size_t i) {
+            hits += tokens[i] == needle;
+        });
+        bench::run("compare: interned_string ==", n, [&](std::size_t i) {
+            hits += interned[i] == interned_needle;
+        });
+        bench::do_not_optimize(hits);
+    }
+
+    unsigned max_threads = std::thread::hardware_concurrency();
+    if (max_threads == 0) max_threads = 1;
+    for (unsigned threads = 1; threads <= max_threads * 2; threads *= 2) {
+        std::size_t per_thread = n / threads;
+        std::mutex mutex;
+        cpp17::string_pool locked;
+        run_threads("intern: string_pool behind one mutex", threads, per_thread, [&](unsigned t) {
+            for (std::size_t i = t * per_thread, end = i + per_thread; i < end; ++i) {
+                std::lock_guard<std::mutex> lock(mutex);
+                bench::do_not_optimize(locked.intern(tokens[i]));
+            }
+        });
+        cpp17::concurrent_string_pool shared;
+        run_threads("intern: concurrent_string_pool", threads, per_thread, [&](unsigned t) {
+            for (std::size_t i = t * per_thread, end = i + per_thread; i < end; ++i) {
+                bench::do_not_optimize(shared.intern(tokens[i]));
+            }
+        });
+    }
+}
@@ -0,0 +1,115 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cpp17/string_view.hpp>
+
+#include <cctype>
+#include <random>
+#include <string>
+
+#include "bench.hpp"
+
+namespace {
+    std::string make_haystack(std::size_t n) {
+        std::mt19937 rng(42);
+        std::string s;
+        s.reserve(n);
+        while (s.size() < n) {
+            s += (rng() % 8 == 0) ? ' ' : static_cast<char>('a' + rng() % 26);
+        }
+        return s;
+    }
+} // namespace
+
+int main() {
+    constexpr std::size_t size = 8 * 1024 * 1024;
+    const std::string haystack = make_haystack(size);
+    const cpp17::string_view view(haystack);
+
+    for (std::size_t m : {1, 2, 4, 8, 16, 32, 64, 256}) {
+        // the needle only occurs at the very end, so every call scans the whole haystack
+        std::string needle(m, 'Z');
+        std::string text = haystack + needle;
+        cpp17::string_view text_view(text);
+        std::string label = "needle " + std::to_string(m) + ": ";
+
+        bench::run(label + "std::string::find (8 MiB)", 10, [&](std::size_t) {
+            bench::do_not_optimize(text.find(needle));
+        });
+        bench::run(label + "cpp17::string_view::find (8 MiB)", 10, [&](std::size_t) {
+            bench::do_not_optimize(text_view.find(cpp17::string_view(needle)));
+        });
+    }
+
+    // periodic input: the worst case for first-character filtering
+    std::string periodic(size, 'a');
+    std::string needle = std::string(63, 'a') + "b";
+    bench::run("aaa...ab / 64: std::string::find", 3, [&](std::size_t) {
+        bench::do_not_optimize(periodic.find(needle));
+    });
+    bench::run("aaa...ab / 64: cpp17::string_view::find", 3, [&](std::size_t) {
+        bench::do_not_optimize(cpp17::string_view(periodic).find(cpp17::string_view(needle)));
+    });
+
+    bench::run("char: cpp17::string_view::find (8 MiB)", 10, [&](std::size_t) {
+        bench::do_not_optimize(view.find('Z'));
+    });
+
+    // character sets: none of these occur, so every call scans the whole haystack
+    for (const char* set : {"0123456789", "!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~"}) {
+        std::string label = "set of " + std::to_string(std::char_traits<char>::length(set)) + ": ";
+        bench::run(label + "std::string::find_first_of (8 MiB)", 10, [&](std::size_t) {
+            bench::do_not_optimize(haystack.find_first_of(set));
+        });
+        bench::run(label + "cpp17::string_view::find_first_of (8 MiB)", 10, [&](std::size_t) {
+            bench::do_not_optimize(view.find_first_of(set));
+        });
+    }
+    bench::run("std::string::find_first_not_of letters+space (8 MiB)", 10, [&](std::size_t) {
+        bench::do_not_optimize(haystack.find_first_not_of("abcdefghijklmnopqrstuvwxyz "));
+    });
+    bench::run("cpp17::string_view::find_first_not_of letters+space (8 MiB)", 10, [&](std::size_t) {
+        bench::do_not_optimize(view.find_first_not_of("abcdefghijklmnopqrstuvwxyz "));
+    });
+    bench::run("std::string::rfind (8 MiB)", 10, [&](std::size_t) {
+        bench::do_not_optimize(haystack.rfind("ZZ"));
+    });
+    bench::run("cpp17::string_view::rfind (8 MiB)", 10, [&](std::size_t) {
+        bench::do_not_optimize(view.rfind("ZZ"));
+    });
+
+    // differing lengths are rejected before touching the characters
+    const std::string longer = haystack + "!";
+    bench::run("operator== on different lengths (8 MiB)", 1000, [&](std::size_t) {
+        bench::do_not_optimize(view == cpp17::string_view(longer));
+    });
+
+    const std::string header = "X-Forwarded-For-Original-Client-Address";
+    std::string lowered = header;
+    for (auto& c : lowered) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    bench::run("header compare: tolower per character", 10000000, [&](std::size_t) {
+        bool eq = header.size() == lowered.size();
+        for (std::size_t i = 0; eq && i < header.size(); ++i) {
+            eq = std::tolower(static_cast<unsigned char>(header[i])) == std::tolower(static_cast<unsigned char>(lowered[i]));
+        }
+        bench::do_not_optimize(eq);
+    });
+    bench::run("header compare: cpp17::iequals", 10000000, [&](std::size_t) {
+        bench::do_not_optimize(cpp17::iequals(header, lowered));
+    });
+}
@@ -0,0 +1,125 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cpp17/utf8.hpp>
+
+#include <codecvt>
+#include <iostream>
+#include <locale>
+#include <random>
+#include <string>
+
+#include "bench.hpp"
+
+namespace {
+    // `ascii_percent` of the characters are ASCII, the rest spread over 2-, 3- and 4-byte sequences
+    std::string make_text(std::size_t bytes, unsigned ascii_percent) {
+        static const char* const others[] = {"\xc3\xa9", "\xd0\x96", "\xe2\x82\xac", "\xe6\x97\xa5", "\xf0\x9f\x98\x80"};
+        std::mt19937 rng(7);
+        std::string s;
+        s.reserve(bytes + 8);
+        while (s.size() < bytes) {
+            if (rng() % 100 < ascii_percent) {
+                s += static_cast<char>('a' + rng() % 26);
+            } else {
+                s += others[rng() % 5];
+            }
+        }
+        return s;
+    }
+
+    // byte-at-a-time validation with a branch per sequence length
+    bool validate_per_byte(const std::string& s) {
+        const auto* p = reinterpret_cast<const unsigned char*>(s.data());
+        std::size_t n = s.size(), i = 0;
+        while (i < n) {
+            unsigned b = p[i];
+            std::size_t length;
+            unsigned cp;
+            if (b < 0x80) {
+                ++i;
+                continue;
+            } else if ((b & 0xe0) == 0xc0) {
+                length = 2;
+                cp = b & 0x1f;
+            } else if ((b & 0xf0) == 0xe0) {
+                length = 3;
+                cp = b & 0x0f;
+            } else if ((b & 0xf8) == 0xf0) {
+                length = 4;
+                cp = b & 0x07;
+            } else {
+                return false;
+            }
+            if (n - i < length) return false;
+            for (std::size_t k = 1; k < length; ++k) {
+                if ((p[i + k] & 0xc0) != 0x80) return false;
+                cp = (cp << 6) | (p[i + k] & 0x3f);
+            }
+            if ((length == 2 && cp < 0x80) || (length == 3 && cp < 0x800) || (length == 4 && cp < 0x10000) ||
+                cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff)) {
+                return false;
+            }
+            i += length;
+        }
+        return true;
+    }
+
+    void throughput(const std::string& name, std::size_t bytes, double ns) {
+        std::cout << "  " << name << ": " << static_cast<double>(bytes) / ns << " GB/s" << std::endl;
+    }
+} // namespace
+
+int main() {
+    const std::size_t size = 32 * 1024 * 1024;
+    for (unsigned ascii : {100u, 90u, 10u}) {
+        const std::string text = make_text(size, ascii);
+        const std::string suffix = " (" + std::to_string(ascii) + "% ASCII, 32 MiB)";
+
+        double ns = bench::run("per-byte validation" + suffix, 5, [&](std::size_t) {
+            bench::do_not_optimize(validate_per_byte(text));
+        });
+        throughput("per-byte", text.size(), ns);
+
+        ns = bench::run("cpp17::utf8::validate" + suffix, 5, [&](std::size_t) {
+            bench::do_not_optimize(cpp17::utf8::validate(text));
+        });
+        throughput("validate", text.size(), ns);
+
+        ns = bench::run("cpp17::utf8::length" + suffix, 5, [&](std::size_t) {
+            bench::do_not_optimize(cpp17::utf8::length(text));
+        });
+        throughput("length", text.size(), ns);
+
+        std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> convert;
+        ns = bench::run("wstring_convert to UTF-16" + suffix, 1, [&](std::size_t) {
+            bench::do_not_optimize(convert.from_bytes(text));
+        });
+        throughput("wstring_convert", text.size(), ns);
+
+        ns = bench::run("cpp17::utf8::to_u16string" + suffix, 3, [&](std::size_t) {
+            bench::do_not_optimize(cpp17::utf8::to_u16string(text));
+        });
+        throughput("to_u16string", text.size(), ns);
+
+        ns = bench::run("code_points sum" + suffix, 3, [&](std::size_t) {
+            char32_t sum = 0;
+            for (char32_t c : cpp17::utf8::code_points(text)) sum += c;
+            bench::do_not_optimize(sum);
+        });
+        throughput("code_points", text.size(), ns);
+    }
+}
@@ -0,0 +1,101 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_ALGORITHM_HPP
+#define LIBCPP17_ALGORITHM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#include "execution.hpp"
+#include "span.hpp"
+
+namespace cpp17 {
+    namespace detail {
+        struct less {
+            template <class T, class U>
+            constexpr bool operator()(const T& lhs, const U& rhs) const {
+                return lhs < rhs;
+            }
+        };
+
+        inline void check_output_size(std::size_t in, std::size_t out) {
+            if (out < in) throw std::invalid_argument("output span is shorter than the input");
+        }
+    } // namespace detail
+
+    template <class Policy, class T, std::size_t N, class F>
+    detail::enable_if_execution_policy<Policy, void> for_each(Policy&& policy, span<T, N> s, F f) {
+        detail::for_each_chunk(policy, detail::make_chunking(policy, s.size()), [&](std::size_t, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                f(s[i]);
+            }
+        });
+    }
+
+    // returns the written part of out
+    template <class Policy, class T, std::size_t N, class U, std::size_t M, class F>
+    detail::enable_if_execution_policy<Policy, span<U>> transform(Policy&& policy, span<T, N> in, span<U, M> out, F f) {
+        detail::check_output_size(in.size(), out.size());
+        detail::for_each_chunk(policy, detail::make_chunking(policy, in.size()), [&](std::size_t, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                out[i] = f(in[i]);
+            }
+        });
+        return out.first(in.size());
+    }
+
+    template <class Policy, class T1, std::size_t N1, class T2, std::size_t N2, class U, std::size_t M, class F>
+    detail::enable_if_execution_policy<Policy, span<U>> transform(Policy&& policy, span<T1, N1> in1, span<T2, N2> in2, span<U, M> out, F f) {
+        detail::check_output_size(in1.size(), in2.size());
+        detail::check_output_size(in1.size(), out.size());
+        detail::for_each_chunk(policy, detail::make_chunking(policy, in1.size()), [&](std::size_t, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                out[i] = f(in1[i], in2[i]);
+            }
+        });
+        return out.first(in1.size());
+    }
+
+    // Sorts the chunks in parallel, then merges neighbouring runs pairwise; every round halves the
+    // number of runs, so the last merge runs on one thread.
+    template <class Policy, class T, std::size_t N, class Compare = detail::less>
+    detail::enable_if_execution_policy<Policy, void> sort(Policy&& policy, span<T, N> s, Compare comp = Compare()) {
+        auto chunks = detail::make_chunking(policy, s.size());
+        if (chunks.count <= 1) {
+            std::sort(s.begin(), s.end(), comp);
+            return;
+        }
+        detail::for_each_chunk(policy, chunks, [&](std::size_t, std::size_t begin, std::size_t end) {
+            std::sort(s.begin() + begin, s.begin() + end, comp);
+        });
+        for (std::size_t width = 1; width < chunks.count; width *= 2) {
+            std::size_t pairs = (chunks.count + 2 * width - 1) / (2 * width);
+            detail::parallel_for(policy, pairs, [&](std::size_t first, std::size_t last) {
+                for (std::size_t p = first; p < last; ++p) {
+                    std::size_t left = p * 2 * width, right = left + width;
+                    if (right >= chunks.count) continue;
+                    std::size_t end = right + width < chunks.count ? chunks.begin(right + width) : s.size();
+                    std::inplace_merge(s.begin() + chunks.begin(left), s.begin() + chunks.begin(right), s.begin() + end, comp);
+                }
+            });
+        }
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_ALGORITHM_HPP
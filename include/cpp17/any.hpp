@@ -17,111 +17,227 @@
 #ifndef STATIC_STANDARD_ANY_HPP
 #define STATIC_STANDARD_ANY_HPP
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 
+#include "memory_resource.hpp"
 #include "optional.hpp"
 
 namespace cpp17 {
     namespace detail {
+        using type_id_t = const void*;
+
         namespace any {
+            // each id is the address of a distinct writable object, which identical-code/data folding never merges
             template <class ValueType>
-            struct dummy {
-                static void f(ValueType*) {
-                }
+            struct type_tag {
+                static char id;
             };
+            template <class ValueType>
+            char type_tag<ValueType>::id = 0;
         } // namespace any
         template <class ValueType>
-        std::uintptr_t type_id() {
-            return reinterpret_cast<std::uintptr_t>(
-                    &any::dummy<
+        constexpr type_id_t type_id() noexcept {
+            return &any::type_tag<
+                    typename std::remove_cv<
                             typename std::remove_reference<
-                                    typename std::remove_cv<
-                                            ValueType>::type>::type>::f);
+                                    ValueType>::type>::type>::id;
         }
+
+        struct any_access;
     } // namespace detail
     class any {
+        friend struct detail::any_access;
+
     private:
-        struct _any_base {
-            std::uintptr_t type_id;
-            _any_base() = delete;
-            explicit _any_base(std::uintptr_t t)
-                    : type_id(t) {
-            }
-            _any_base(const _any_base&) = default;
-            _any_base(_any_base&&) noexcept = default;
-            virtual ~_any_base() = default;
-            virtual const void* get() const = 0;
-            virtual _any_base* new_instance() const = 0;
+        union _storage {
+            void* ptr;
+            typename std::aligned_storage<3 * sizeof(void*), alignof(void*)>::type buf;
         };
+
         template <class T>
-        class _any_holder : public _any_base {
-        private:
-            T data;
+        struct _is_small
+                : std::integral_constant<bool,
+                                         sizeof(T) <= sizeof(_storage) &&
+                                                 alignof(_storage) % alignof(T) == 0 &&
+                                                 std::is_nothrow_move_constructible<T>::value> {
+        };
 
-        public:
-            _any_holder()
-                    : _any_base(detail::type_id<T>()) {
+        template <class T>
+        struct _is_trivial
+                : std::integral_constant<bool,
+                                         _is_small<T>::value &&
+                                                 std::is_trivially_copyable<T>::value> {
+        };
+
+        struct _vtable {
+            void (*copy)(const _storage& src, _storage& dst, pmr::memory_resource* r);
+            void (*move)(_storage& src, _storage& dst) noexcept;
+            void (*destroy)(_storage& s) noexcept;
+        };
+
+        template <class T, bool Small = _is_small<T>::value>
+        struct _manager {
+            static T* get(_storage& s) noexcept {
+                return reinterpret_cast<T*>(&s.buf);
+            }
+            static const T* get(const _storage& s) noexcept {
+                return reinterpret_cast<const T*>(&s.buf);
             }
-            _any_holder(const _any_holder&) = default;
-            _any_holder(_any_holder&&) noexcept = default;
+            template <class... Args>
+            static void create(_storage& s, pmr::memory_resource*, Args&&... args) {
+                new (&s.buf) T(std::forward<Args>(args)...);
+            }
+            static void copy(const _storage& src, _storage& dst, pmr::memory_resource* r) {
+                create(dst, r, *get(src));
+            }
+            static void move(_storage& src, _storage& dst) noexcept {
+                create(dst, nullptr, std::move(*get(src)));
+                destroy(src);
+            }
+            static void destroy(_storage& s) noexcept {
+                get(s)->~T();
+            }
+        };
+        template <class T>
+        struct _heap_block {
+            pmr::memory_resource* resource;
+            T value;
 
             template <class... Args>
-            explicit _any_holder(Args&&... args)
-                    : _any_base(detail::type_id<T>()), data(std::forward<Args>(args)...) {
+            explicit _heap_block(pmr::memory_resource* r, Args&&... args)
+                    : resource(r), value(std::forward<Args>(args)...) {
             }
+        };
 
-            const void* get() const override {
-                return &data;
+        template <class T>
+        struct _manager<T, false> {
+            using block = _heap_block<T>;
+
+            static T* get(_storage& s) noexcept {
+                return &static_cast<block*>(s.ptr)->value;
+            }
+            static const T* get(const _storage& s) noexcept {
+                return &static_cast<const block*>(s.ptr)->value;
+            }
+            template <class... Args>
+            static void create(_storage& s, pmr::memory_resource* r, Args&&... args) {
+                void* p = r->allocate(sizeof(block), alignof(block));
+                try {
+                    s.ptr = new (p) block(r, std::forward<Args>(args)...);
+                } catch (...) {
+                    r->deallocate(p, sizeof(block), alignof(block));
+                    throw;
+                }
+            }
+            static void copy(const _storage& src, _storage& dst, pmr::memory_resource* r) {
+                create(dst, r, *get(src));
             }
-            _any_base* new_instance() const override {
-                return new _any_holder<T>(data);
+            static void move(_storage& src, _storage& dst) noexcept {
+                dst.ptr = src.ptr;
+            }
+            static void destroy(_storage& s) noexcept {
+                auto b = static_cast<block*>(s.ptr);
+                pmr::memory_resource* r = b->resource;
+                b->~block();
+                r->deallocate(b, sizeof(block), alignof(block));
             }
         };
 
+        template <class T>
+        static typename std::enable_if<_is_trivial<T>::value, const _vtable*>::type _vtable_for() noexcept {
+            return nullptr;
+        }
+        template <class T>
+        static typename std::enable_if<!_is_trivial<T>::value, const _vtable*>::type _vtable_for() noexcept {
+            static constexpr _vtable vt{&_manager<T>::copy, &_manager<T>::move, &_manager<T>::destroy};
+            return &vt;
+        }
+
+        template <class T>
+        using _enable_if_not_any = typename std::enable_if<
+                !std::is_same<typename std::decay<T>::type, any>::value>::type;
+
     private:
-        _any_base* _any = nullptr;
+        // _vt is null for trivially copyable inline payloads, which are copied and moved as raw bytes.
+        detail::type_id_t _type;
+        const _vtable* _vt;
+        _storage _s;
+
+        void _copy_from(const any& rhs, pmr::memory_resource* r) {
+            if (rhs._vt == nullptr) {
+                _s = rhs._s;
+            } else {
+                rhs._vt->copy(rhs._s, _s, r);
+            }
+            _type = rhs._type;
+            _vt = rhs._vt;
+        }
+        void _move_from(any& rhs) noexcept {
+            if (rhs._vt == nullptr) {
+                _s = rhs._s;
+            } else {
+                rhs._vt->move(rhs._s, _s);
+            }
+            _type = rhs._type;
+            _vt = rhs._vt;
+            rhs._type = nullptr;
+            rhs._vt = nullptr;
+        }
 
     public:
-        any()
-                : _any(nullptr) {
+        any() noexcept
+                : _type(nullptr), _vt(nullptr), _s() {
         }
+        // like pmr containers, a plain copy allocates from the default resource rather than the source's
         any(const any& rhs)
                 : any() {
-            if (rhs.has_value()) {
-                _any = rhs._any->new_instance();
-            }
+            _copy_from(rhs, pmr::get_default_resource());
+        }
+        any(std::allocator_arg_t, pmr::memory_resource* r, const any& rhs)
+                : any() {
+            _copy_from(rhs, r);
         }
         any(any&& rhs) noexcept
-                : _any(rhs._any) {
-            rhs._any = nullptr;
+                : any() {
+            _move_from(rhs);
         }
         any& operator=(const any& rhs) {
-            if (rhs.has_value()) {
-                _any = rhs._any->new_instance();
-            } else {
-                reset();
+            if (this != &rhs) {
+                any(rhs).swap(*this);
             }
             return *this;
         }
         any& operator=(any&& rhs) noexcept {
-            reset();
-            _any = rhs._any;
-            rhs._any = nullptr;
+            if (this != &rhs) {
+                reset();
+                _move_from(rhs);
+            }
             return *this;
         }
-        template <class T>
+        template <class T, class = _enable_if_not_any<T>>
         any& operator=(T&& rhs) {
             using Ty = typename std::remove_cv<typename std::remove_reference<T>::type>::type;
             emplace<Ty>(std::forward<T>(rhs));
             return *this;
         }
-        template <class T>
-        any(T&& rhs) {
+        template <class T, class = _enable_if_not_any<T>>
+        any(T&& rhs)
+                : any() {
             using Ty = typename std::remove_cv<typename std::remove_reference<T>::type>::type;
             emplace<Ty>(std::forward<T>(rhs));
         }
+        template <class T, class = _enable_if_not_any<T>>
+        any(std::allocator_arg_t, pmr::memory_resource* r, T&& rhs)
+                : any() {
+            using Ty = typename std::remove_cv<typename std::remove_reference<T>::type>::type;
+            _emplace<Ty>(r, std::forward<T>(rhs));
+        }
 
         ~any() {
             reset();
@@ -129,40 +245,193 @@ namespace cpp17 {
 
     public:
         bool has_value() const noexcept {
-            return _any != nullptr;
+            return _type != nullptr;
         }
         void reset() noexcept {
-            if (!has_value()) return;
-            delete _any;
-            _any = nullptr;
+            if (_vt != nullptr) {
+                _vt->destroy(_s);
+            }
+            _type = nullptr;
+            _vt = nullptr;
+        }
+        void swap(any& rhs) noexcept {
+            if (this == &rhs) return;
+            any tmp(std::move(rhs));
+            rhs._move_from(*this);
+            _move_from(tmp);
         }
 
     public:
         template <class Ty>
         optional<Ty> get() const {
-            if (!has_value()) return nullopt;
+            auto p = get_if<Ty>();
+            if (p == nullptr) return nullopt;
+
+            return optional<Ty>(*p);
+        }
 
-            if (_any->type_id != detail::type_id<Ty>()) return nullopt;
+        template <class Ty>
+        typename std::remove_reference<Ty>::type* get_if() noexcept {
+            using T = typename std::remove_cv<typename std::remove_reference<Ty>::type>::type;
+            if (_type != detail::type_id<T>()) return nullptr;
 
-            return optional<Ty>(*static_cast<const Ty*>(_any->get()));
+            return _manager<T>::get(_s);
+        }
+        template <class Ty>
+        const typename std::remove_reference<Ty>::type* get_if() const noexcept {
+            using T = typename std::remove_cv<typename std::remove_reference<Ty>::type>::type;
+            if (_type != detail::type_id<T>()) return nullptr;
+
+            return _manager<T>::get(_s);
         }
 
         template <class T, class... Args>
         void emplace(Args&&... args) {
+            _emplace<T>(pmr::get_default_resource(), std::forward<Args>(args)...);
+        }
+
+    private:
+        template <class T, class... Args>
+        void _emplace(pmr::memory_resource* r, Args&&... args) {
             reset();
-            _any = new _any_holder<T>(std::forward<Args>(args)...);
+            _manager<T>::create(_s, r, std::forward<Args>(args)...);
+            _type = detail::type_id<T>();
+            _vt = _vtable_for<T>();
         }
     };
 
+    inline void swap(any& lhs, any& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
     struct bad_any_cast : public std::exception {
         using exception::exception;
     };
 
+    template <class T>
+    const T* any_cast(const any* a) noexcept {
+        return a != nullptr ? a->get_if<T>() : nullptr;
+    }
+    template <class T>
+    T* any_cast(any* a) noexcept {
+        return a != nullptr ? a->get_if<T>() : nullptr;
+    }
+
     template <class T>
     T any_cast(const any& a) {
-        auto v = a.get<T>();
-        if (!v) throw bad_any_cast();
-        return v.value();
+        using U = typename std::remove_cv<typename std::remove_reference<T>::type>::type;
+        auto p = any_cast<U>(&a);
+        if (p == nullptr) throw bad_any_cast();
+        return static_cast<T>(*p);
+    }
+    template <class T>
+    T any_cast(any& a) {
+        using U = typename std::remove_cv<typename std::remove_reference<T>::type>::type;
+        auto p = any_cast<U>(&a);
+        if (p == nullptr) throw bad_any_cast();
+        return static_cast<T>(*p);
+    }
+    template <class T>
+    T any_cast(any&& a) {
+        using U = typename std::remove_cv<typename std::remove_reference<T>::type>::type;
+        auto p = any_cast<U>(&a);
+        if (p == nullptr) throw bad_any_cast();
+        return static_cast<T>(std::move(*p));
+    }
+
+    namespace detail {
+        struct any_access {
+            static type_id_t type(const cpp17::any& a) noexcept {
+                return a._type;
+            }
+            template <class T>
+            static T& get(cpp17::any& a) noexcept {
+                return *cpp17::any::_manager<T>::get(a._s);
+            }
+            template <class T>
+            static const T& get(const cpp17::any& a) noexcept {
+                return *cpp17::any::_manager<T>::get(a._s);
+            }
+        };
+
+        constexpr std::size_t any_dispatch_bits(std::size_t n, std::size_t bits = 1) {
+            return (std::size_t(1) << bits) >= 2 * n ? bits : any_dispatch_bits(n, bits + 1);
+        }
+
+        // open-addressing map from type id to alternative index, at most half full
+        template <std::size_t N>
+        class any_dispatch_table {
+        private:
+            static constexpr std::size_t _bits = any_dispatch_bits(N);
+            static constexpr std::size_t _size = std::size_t(1) << _bits;
+
+            type_id_t _keys[_size];
+            std::size_t _values[_size];
+
+            static std::size_t _hash(type_id_t id) noexcept {
+                auto h = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(id)) * 0x9E3779B97F4A7C15ull;
+                return static_cast<std::size_t>(h >> (64 - _bits));
+            }
+
+        public:
+            explicit any_dispatch_table(const type_id_t (&ids)[N]) noexcept
+                    : _keys(), _values() {
+                for (std::size_t i = 0; i < N; ++i) {
+                    std::size_t slot = _hash(ids[i]);
+                    while (_keys[slot] != nullptr && _keys[slot] != ids[i]) {
+                        slot = (slot + 1) & (_size - 1);
+                    }
+                    if (_keys[slot] == nullptr) {
+                        _keys[slot] = ids[i];
+                        _values[slot] = i;
+                    }
+                }
+            }
+
+            std::size_t find(type_id_t id) const noexcept {
+                for (std::size_t slot = _hash(id);; slot = (slot + 1) & (_size - 1)) {
+                    if (_keys[slot] == id) return _values[slot];
+                    if (_keys[slot] == nullptr) return N;
+                }
+            }
+        };
+
+        template <class T, class... Ts>
+        struct first_type {
+            using type = T;
+        };
+
+        template <class Any, class Visitor, class... Ts>
+        struct any_visitor {
+            template <class T>
+            using qualified = typename std::conditional<std::is_const<Any>::value, const T&, T&>::type;
+
+            using result_type = decltype(std::declval<Visitor&>()(std::declval<qualified<typename first_type<Ts...>::type>>()));
+
+            template <class T>
+            static result_type thunk(Any& a, Visitor& vis) {
+                return vis(any_access::get<T>(a));
+            }
+
+            static result_type visit(Any& a, Visitor& vis) {
+                static const type_id_t ids[] = {type_id<Ts>()...};
+                static const any_dispatch_table<sizeof...(Ts)> table(ids);
+                static result_type (*const thunks[])(Any&, Visitor&) = {&thunk<typename std::remove_cv<Ts>::type>...};
+
+                std::size_t index = a.has_value() ? table.find(any_access::type(a)) : sizeof...(Ts);
+                if (index == sizeof...(Ts)) throw bad_any_cast();
+                return thunks[index](a, vis);
+            }
+        };
+    } // namespace detail
+
+    template <class... Ts, class Visitor>
+    typename detail::any_visitor<any, Visitor, Ts...>::result_type visit_any(any& a, Visitor&& vis) {
+        return detail::any_visitor<any, Visitor, Ts...>::visit(a, vis);
+    }
+    template <class... Ts, class Visitor>
+    typename detail::any_visitor<const any, Visitor, Ts...>::result_type visit_any(const any& a, Visitor&& vis) {
+        return detail::any_visitor<const any, Visitor, Ts...>::visit(a, vis);
     }
 } // namespace cpp17
 
@@ -0,0 +1,92 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_BIT_HPP
+#define LIBCPP17_BIT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace cpp17 {
+#if defined(__BYTE_ORDER__)
+    enum class endian {
+        little = __ORDER_LITTLE_ENDIAN__,
+        big = __ORDER_BIG_ENDIAN__,
+        native = __BYTE_ORDER__,
+    };
+#else
+    enum class endian {
+        little = 0,
+        big = 1,
+        native = little,
+    };
+#endif
+
+    namespace detail {
+        template <std::size_t N>
+        struct uint_of_size;
+        template <>
+        struct uint_of_size<1> {
+            using type = std::uint8_t;
+        };
+        template <>
+        struct uint_of_size<2> {
+            using type = std::uint16_t;
+        };
+        template <>
+        struct uint_of_size<4> {
+            using type = std::uint32_t;
+        };
+        template <>
+        struct uint_of_size<8> {
+            using type = std::uint64_t;
+        };
+
+        constexpr std::uint8_t bswap(std::uint8_t v) noexcept {
+            return v;
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        constexpr std::uint16_t bswap(std::uint16_t v) noexcept {
+            return __builtin_bswap16(v);
+        }
+        constexpr std::uint32_t bswap(std::uint32_t v) noexcept {
+            return __builtin_bswap32(v);
+        }
+        constexpr std::uint64_t bswap(std::uint64_t v) noexcept {
+            return __builtin_bswap64(v);
+        }
+#else
+        constexpr std::uint16_t bswap(std::uint16_t v) noexcept {
+            return static_cast<std::uint16_t>((v << 8) | (v >> 8));
+        }
+        constexpr std::uint32_t bswap(std::uint32_t v) noexcept {
+            return (std::uint32_t(bswap(static_cast<std::uint16_t>(v))) << 16) | bswap(static_cast<std::uint16_t>(v >> 16));
+        }
+        constexpr std::uint64_t bswap(std::uint64_t v) noexcept {
+            return (std::uint64_t(bswap(static_cast<std::uint32_t>(v))) << 32) | bswap(static_cast<std::uint32_t>(v >> 32));
+        }
+#endif
+    } // namespace detail
+
+    template <class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+    constexpr T byteswap(T v) noexcept {
+        return static_cast<T>(detail::bswap(static_cast<typename detail::uint_of_size<sizeof(T)>::type>(v)));
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_BIT_HPP
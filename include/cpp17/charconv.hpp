@@ -0,0 +1,1188 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_CHARCONV_HPP
+#define LIBCPP17_CHARCONV_HPP
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+#include "detail/bignum.hpp"
+#include "detail/int128.hpp"
+#include "optional.hpp"
+#include "string_view.hpp"
+
+namespace cpp17 {
+    enum class chars_format {
+        scientific = 0x1,
+        fixed = 0x2,
+        hex = 0x4,
+        general = fixed | scientific
+    };
+
+    struct from_chars_result {
+        const char* ptr;
+        std::errc ec;
+    };
+
+    struct to_chars_result {
+        char* ptr;
+        std::errc ec;
+    };
+
+    namespace detail {
+        namespace charconv {
+            template <class T>
+            using enable_if_integer = typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type;
+            template <class T>
+            using enable_if_float = typename std::enable_if<std::is_same<T, float>::value || std::is_same<T, double>::value, int>::type;
+
+            inline bool has(chars_format fmt, chars_format flag) noexcept {
+                return (static_cast<int>(fmt) & static_cast<int>(flag)) != 0;
+            }
+
+            // 36 for anything that is not a digit in any base
+            inline unsigned digit_value(char c) noexcept {
+                unsigned d = static_cast<unsigned char>(c) - unsigned('0');
+                if (d < 10) return d;
+                unsigned l = (static_cast<unsigned char>(c) | 0x20u) - unsigned('a');
+                return l < 26 ? l + 10 : 36;
+            }
+
+            inline const char* digit_pairs() noexcept {
+                static const char table[] =
+                        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                        "8081828384858687888990919293949596979899";
+                return table;
+            }
+
+            inline const char* digit_chars() noexcept {
+                static const char table[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+                return table;
+            }
+
+            template <class U>
+            from_chars_result parse_unsigned(const char* first, const char* last, U& value, unsigned base) noexcept {
+                int bits_per_digit = 1;
+                while ((1u << bits_per_digit) < base) ++bits_per_digit;
+                // this many leading digits cannot overflow, so they skip the check
+                std::ptrdiff_t safe_digits = base == 10 ? std::numeric_limits<U>::digits10 : std::numeric_limits<U>::digits / bits_per_digit;
+                const char* safe = last - first > safe_digits ? first + safe_digits : last;
+
+                const char* p = first;
+                U v = 0;
+                for (; p != safe; ++p) {
+                    unsigned d = digit_value(*p);
+                    if (d >= base) break;
+                    v = static_cast<U>(v * base + d);
+                }
+                bool overflow = false;
+                if (p == safe) {
+                    for (; p != last; ++p) {
+                        unsigned d = digit_value(*p);
+                        if (d >= base) break;
+                        if (overflow) continue;
+                        if (v > static_cast<U>((std::numeric_limits<U>::max() - d) / base)) {
+                            overflow = true;
+                        } else {
+                            v = static_cast<U>(v * base + d);
+                        }
+                    }
+                }
+                if (p == first) return {first, std::errc::invalid_argument};
+                if (overflow) return {p, std::errc::result_out_of_range};
+                value = v;
+                return {p, std::errc()};
+            }
+
+            template <class I>
+            from_chars_result parse_integer(const char* first, const char* last, I& value, unsigned base, std::true_type /*signed*/) noexcept {
+                using U = typename std::make_unsigned<I>::type;
+                bool negative = first != last && *first == '-';
+                U u;
+                from_chars_result r = parse_unsigned(first + negative, last, u, base);
+                if (r.ec == std::errc::invalid_argument) return {first, r.ec};
+                if (r.ec != std::errc()) return r;
+                U limit = static_cast<U>(std::numeric_limits<I>::max()) + static_cast<U>(negative);
+                if (u > limit) return {r.ptr, std::errc::result_out_of_range};
+                if (!negative) {
+                    value = static_cast<I>(u);
+                } else if (u == limit) {
+                    value = std::numeric_limits<I>::min();
+                } else {
+                    value = static_cast<I>(-static_cast<I>(u));
+                }
+                return r;
+            }
+
+            template <class U>
+            from_chars_result parse_integer(const char* first, const char* last, U& value, unsigned base, std::false_type /*signed*/) noexcept {
+                return parse_unsigned(first, last, value, base);
+            }
+
+            template <class U>
+            int count_digits10(U v) noexcept {
+                int n = 1;
+                for (;;) {
+                    if (v < 10) return n;
+                    if (v < 100) return n + 1;
+                    if (v < 1000) return n + 2;
+                    if (v < 10000) return n + 3;
+                    v /= 10000u;
+                    n += 4;
+                }
+            }
+
+            // writes the decimal digits of v so that they end at `end`
+            template <class U>
+            void write_digits10(char* end, U v) noexcept {
+                const char* pairs = digit_pairs();
+                while (v >= 100) {
+                    unsigned i = static_cast<unsigned>(v % 100) * 2;
+                    v /= 100;
+                    *--end = pairs[i + 1];
+                    *--end = pairs[i];
+                }
+                if (v >= 10) {
+                    unsigned i = static_cast<unsigned>(v) * 2;
+                    *--end = pairs[i + 1];
+                    *--end = pairs[i];
+                } else {
+                    *--end = static_cast<char>('0' + v);
+                }
+            }
+
+            template <class U>
+            to_chars_result format_unsigned(char* first, char* last, U v, unsigned base) noexcept {
+                if (base == 10) {
+                    int n = count_digits10(v);
+                    if (last - first < n) return {last, std::errc::value_too_large};
+                    write_digits10(first + n, v);
+                    return {first + n, std::errc()};
+                }
+                char buffer[std::numeric_limits<U>::digits];
+                char* end = buffer + sizeof(buffer);
+                char* p = end;
+                do {
+                    *--p = digit_chars()[v % base];
+                    v = static_cast<U>(v / base);
+                } while (v != 0);
+                if (last - first < end - p) return {last, std::errc::value_too_large};
+                std::memcpy(first, p, static_cast<std::size_t>(end - p));
+                return {first + (end - p), std::errc()};
+            }
+
+            template <class I>
+            to_chars_result format_integer(char* first, char* last, I v, unsigned base, std::true_type /*signed*/) noexcept {
+                using U = typename std::make_unsigned<I>::type;
+                U u = static_cast<U>(v);
+                if (v < 0) {
+                    if (first == last) return {last, std::errc::value_too_large};
+                    *first++ = '-';
+                    u = static_cast<U>(0u - u);
+                }
+                return format_unsigned(first, last, u, base);
+            }
+
+            template <class U>
+            to_chars_result format_integer(char* first, char* last, U v, unsigned base, std::false_type /*signed*/) noexcept {
+                return format_unsigned(first, last, v, base);
+            }
+
+            template <class F>
+            struct float_info;
+
+            template <>
+            struct float_info<double> {
+                using bits_type = std::uint64_t;
+                static constexpr int mantissa_bits = 52;
+                static constexpr int exponent_bias = 1023;
+                static constexpr int max_exponent_field = 2047;
+                static constexpr int max_shortest_digits = 17;
+                // beyond these decimal magnitudes the result is certainly infinite or zero
+                static constexpr int overflow_magnitude = 310;
+                static constexpr int underflow_magnitude = -325;
+                // w * 10^e is exact when w <= 2^53 and |e| <= 22
+                static constexpr int exact_pow10 = 22;
+                static constexpr std::uint64_t exact_mantissa = std::uint64_t(1) << 53;
+                // w * 10^q with w < 2^64 can only fall exactly halfway between two doubles for q in this range
+                static constexpr int min_tie_exponent = -4;
+                static constexpr int max_tie_exponent = 23;
+
+                static double pow10(int i) noexcept {
+                    static const double table[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+                    return table[i];
+                }
+            };
+
+            template <>
+            struct float_info<float> {
+                using bits_type = std::uint32_t;
+                static constexpr int mantissa_bits = 23;
+                static constexpr int exponent_bias = 127;
+                static constexpr int max_exponent_field = 255;
+                static constexpr int max_shortest_digits = 9;
+                static constexpr int overflow_magnitude = 40;
+                static constexpr int underflow_magnitude = -47;
+                static constexpr int exact_pow10 = 10;
+                static constexpr std::uint64_t exact_mantissa = std::uint64_t(1) << 24;
+                static constexpr int min_tie_exponent = -17;
+                static constexpr int max_tie_exponent = 10;
+
+                static float pow10(int i) noexcept {
+                    static const float table[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+                    return table[i];
+                }
+            };
+
+            // the fast path needs float arithmetic to round to the type's own precision (not x87 extended precision)
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+            constexpr bool exact_float_arithmetic = true;
+#else
+            constexpr bool exact_float_arithmetic = false;
+#endif
+
+            template <class F>
+            typename float_info<F>::bits_type to_bits(F v) noexcept {
+                typename float_info<F>::bits_type bits;
+                std::memcpy(&bits, &v, sizeof(v));
+                return bits;
+            }
+
+            template <class F>
+            F from_bits(typename float_info<F>::bits_type bits) noexcept {
+                F v;
+                std::memcpy(&v, &bits, sizeof(v));
+                return v;
+            }
+
+            // rounds q * 2^e (q != 0) to nearest-even; `sticky` marks nonzero bits already dropped below q
+            template <class F>
+            std::errc round_to_float(std::uint64_t q, int e, bool sticky, bool negative, F& value) noexcept {
+                using info = float_info<F>;
+                using bits_type = typename info::bits_type;
+                constexpr int precision = info::mantissa_bits + 1;
+                constexpr int min_exponent = 1 - info::exponent_bias;
+
+                while ((q >> 63) == 0) {
+                    q <<= 1;
+                    --e;
+                }
+                // value in [2^exponent, 2^(exponent + 1))
+                long exponent = static_cast<long>(e) + 63;
+                long shift = 64 - precision;
+                if (exponent < min_exponent) shift += min_exponent - exponent;
+
+                std::uint64_t mantissa;
+                bool round_up;
+                if (shift > 64) {
+                    mantissa = 0;
+                    round_up = false;
+                } else {
+                    std::uint64_t half = std::uint64_t(1) << (shift - 1);
+                    std::uint64_t rest = shift == 64 ? q : q & ((half << 1) - 1);
+                    mantissa = shift == 64 ? 0 : q >> shift;
+                    round_up = rest > half || (rest == half && (sticky || (mantissa & 1) != 0));
+                }
+                if (round_up) ++mantissa;
+                if (exponent < min_exponent) exponent = min_exponent;
+                if (mantissa == (std::uint64_t(1) << precision)) {
+                    mantissa >>= 1;
+                    ++exponent;
+                }
+                if (mantissa == 0) return std::errc::result_out_of_range;
+                long field = mantissa >> info::mantissa_bits ? exponent + info::exponent_bias : 0;
+                if (field >= info::max_exponent_field) return std::errc::result_out_of_range;
+
+                bits_type bits = static_cast<bits_type>((static_cast<bits_type>(field) << info::mantissa_bits) | (mantissa & ((std::uint64_t(1) << info::mantissa_bits) - 1)));
+                if (negative) bits |= bits_type(1) << (sizeof(bits_type) * 8 - 1);
+                value = from_bits<F>(bits);
+                return std::errc();
+            }
+
+            struct uint128 {
+                std::uint64_t high;
+                std::uint64_t low;
+            };
+
+            // floor(5^e * 2^s) for e in [min_exponent, max_exponent], with s chosen so that the value lies in
+            // [2^127, 2^128). 10^e has the same normalized significand. Computed exactly on first use.
+            class pow5_table {
+            public:
+                static constexpr int min_exponent = -342;
+                static constexpr int max_exponent = 325;
+
+            private:
+                uint128 _entries[max_exponent - min_exponent + 1];
+
+            public:
+                pow5_table() noexcept {
+                    bignum p(1);
+                    for (int e = 0; e <= max_exponent; ++e) {
+                        _store(e, p, p.bit_length() - 128);
+                        p.mul_small(5);
+                    }
+                    // r == floor(2^n / 5^m), so floor(2^(z + 127) / 5^m) for 2^(z - 1) < 5^m < 2^z is a slice of r
+                    constexpr int n = 1000;
+                    bignum r(1), p5(1);
+                    r.shl(n);
+                    for (int m = 1; m <= -min_exponent; ++m) {
+                        r.div_small(5);
+                        p5.mul_small(5);
+                        _store(-m, r, n - p5.bit_length() - 127);
+                    }
+                }
+
+                const uint128& operator[](int e) const noexcept {
+                    return _entries[e - min_exponent];
+                }
+
+            private:
+                void _store(int e, const bignum& v, int from) noexcept {
+                    bool sticky;
+                    uint128& entry = _entries[e - min_exponent];
+                    if (from >= 0) {
+                        entry.high = v.bits64(from + 64, sticky);
+                        entry.low = v.bits64(from, sticky);
+                    } else {
+                        bignum t = v;
+                        t.shl(-from);
+                        entry.high = t.bits64(64, sticky);
+                        entry.low = t.bits64(0, sticky);
+                    }
+                }
+            };
+
+            inline uint128 pow5_significand(int e, bool round_up) noexcept {
+                static const pow5_table table;
+                uint128 g = table[e];
+                if (round_up && ++g.low == 0) ++g.high;
+                return g;
+            }
+
+            inline int leading_zeros(std::uint64_t v) noexcept {
+#if defined(__GNUC__)
+                return __builtin_clzll(v);
+#else
+                int n = 0;
+                for (; (v >> 63) == 0; v <<= 1) ++n;
+                return n;
+#endif
+            }
+
+            // floor(e * log10(2)), exact for |e| <= 2620
+            inline int floor_log10_pow2(int e) noexcept {
+                return (e * 315653) >> 20;
+            }
+            // floor(e * log10(2) - log10(4/3)), exact for |e| <= 2936
+            inline int floor_log10_three_quarters_pow2(int e) noexcept {
+                return (e * 631305 - 261663) >> 21;
+            }
+            // floor(e * log2(10)), exact for |e| <= 1233
+            inline int floor_log2_pow10(int e) noexcept {
+                return (e * 1741647) >> 19;
+            }
+
+            // Eisel-Lemire: the bits of w * 10^q (w != 0) from a truncated 128-bit product. Returns false when
+            // the product cannot decide the rounding; exact arithmetic has to settle those.
+            // Underflow leaves bits == 0, overflow leaves the infinity pattern.
+            template <class F>
+            bool eisel_lemire(std::uint64_t w, int q, typename float_info<F>::bits_type& bits) noexcept {
+                using info = float_info<F>;
+                using bits_type = typename info::bits_type;
+                constexpr int mantissa_bits = info::mantissa_bits;
+                if (q < pow5_table::min_exponent || q > pow5_table::max_exponent) return false;
+
+                int lz = leading_zeros(w);
+                w <<= lz;
+                // the reciprocals of small powers are rounded up so that the product is exact for them
+                uint128 g = pow5_significand(q, q < 0 && q >= -27);
+                std::uint64_t high;
+                std::uint64_t low = umul128(w, g.high, high);
+                constexpr std::uint64_t precision_mask = ~std::uint64_t(0) >> (mantissa_bits + 3);
+                if ((high & precision_mask) == precision_mask) {
+                    std::uint64_t high2;
+                    umul128(w, g.low, high2);
+                    low += high2;
+                    high += low < high2;
+                    if ((high & precision_mask) == precision_mask && low == ~std::uint64_t(0) && (q < -27 || q > 55)) return false;
+                }
+
+                int upper = static_cast<int>(high >> 63);
+                int shift = upper + 64 - mantissa_bits - 3;
+                std::uint64_t mantissa = high >> shift;
+                int exponent = floor_log2_pow10(q) + 63 + upper - lz + info::exponent_bias;
+                if (exponent <= 0) {
+                    if (1 - exponent >= 64) {
+                        bits = 0;
+                        return true;
+                    }
+                    // subnormal; a carry out of the rounding lands exactly on the smallest normal's pattern
+                    mantissa >>= 1 - exponent;
+                    mantissa += mantissa & 1;
+                    bits = static_cast<bits_type>(mantissa >> 1);
+                    return true;
+                }
+                // exactly halfway: round to even instead of up
+                if (low <= 1 && q >= info::min_tie_exponent && q <= info::max_tie_exponent && (mantissa & 3) == 1 && (mantissa << shift) == high) {
+                    mantissa &= ~std::uint64_t(1);
+                }
+                mantissa += mantissa & 1;
+                mantissa >>= 1;
+                if (mantissa >= (std::uint64_t(2) << mantissa_bits)) {
+                    mantissa = std::uint64_t(1) << mantissa_bits;
+                    ++exponent;
+                }
+                mantissa &= ~(std::uint64_t(1) << mantissa_bits);
+                if (exponent >= info::max_exponent_field) {
+                    exponent = info::max_exponent_field;
+                    mantissa = 0;
+                }
+                bits = static_cast<bits_type>((static_cast<std::uint64_t>(exponent) << mantissa_bits) | mantissa);
+                return true;
+            }
+
+            inline bool match_ci(const char*& p, const char* last, const char* word) noexcept {
+                const char* q = p;
+                for (; *word != '\0'; ++word, ++q) {
+                    if (q == last || (*q | 0x20) != *word) return false;
+                }
+                p = q;
+                return true;
+            }
+
+            template <class F>
+            from_chars_result parse_special(const char* first, const char* p, const char* last, bool negative, F& value) noexcept {
+                if (match_ci(p, last, "inf")) {
+                    match_ci(p, last, "inity");
+                    value = negative ? -std::numeric_limits<F>::infinity() : std::numeric_limits<F>::infinity();
+                    return {p, std::errc()};
+                }
+                if (match_ci(p, last, "nan")) {
+                    if (p != last && *p == '(') {
+                        const char* q = p + 1;
+                        while (q != last && (digit_value(*q) < 36 || *q == '_')) ++q;
+                        if (q != last && *q == ')') p = q + 1;
+                    }
+                    value = negative ? -std::numeric_limits<F>::quiet_NaN() : std::numeric_limits<F>::quiet_NaN();
+                    return {p, std::errc()};
+                }
+                return {first, std::errc::invalid_argument};
+            }
+
+            // decimal or binary exponent after 'e' or 'p'; leaves p untouched when no digits follow
+            inline bool parse_exponent(const char*& p, const char* last, long& exponent) noexcept {
+                const char* q = p + 1;
+                bool negative = false;
+                if (q != last && (*q == '+' || *q == '-')) negative = *q++ == '-';
+                if (q == last || digit_value(*q) >= 10) return false;
+                long e = 0;
+                for (; q != last && digit_value(*q) < 10; ++q) {
+                    if (e < 100000) e = e * 10 + static_cast<long>(digit_value(*q));
+                }
+                exponent = negative ? -e : e;
+                p = q;
+                return true;
+            }
+
+            template <class F>
+            from_chars_result parse_hex(const char* first, const char* p, const char* last, bool negative, F& value) noexcept {
+                std::uint64_t m = 0;
+                long e = 0;
+                bool sticky = false, any = false;
+                int significant = 0;
+                for (; p != last && digit_value(*p) < 16; ++p) {
+                    any = true;
+                    unsigned d = digit_value(*p);
+                    if (significant < 16) {
+                        m = m * 16 + d;
+                        significant += m != 0;
+                    } else {
+                        e += 4;
+                        sticky |= d != 0;
+                    }
+                }
+                if (p != last && *p == '.') {
+                    const char* q = p + 1;
+                    for (; q != last && digit_value(*q) < 16; ++q) {
+                        any = true;
+                        unsigned d = digit_value(*q);
+                        if (significant < 16) {
+                            m = m * 16 + d;
+                            significant += m != 0;
+                            e -= 4;
+                        } else {
+                            sticky |= d != 0;
+                        }
+                    }
+                    if (any) p = q;
+                }
+                if (!any) return {first, std::errc::invalid_argument};
+                long exponent = 0;
+                if (p != last && (*p | 0x20) == 'p' && parse_exponent(p, last, exponent)) e += exponent;
+
+                if (m == 0) {
+                    value = negative ? -F(0) : F(0);
+                    return {p, std::errc()};
+                }
+                if (e > 100000) e = 100000;
+                if (e < -100000) e = -100000;
+                std::errc ec = round_to_float(m, static_cast<int>(e), sticky, negative, value);
+                return {p, ec};
+            }
+
+            // exact conversion of 0.d1 d2 ... dn * 10^magnitude, used when the fast path does not apply
+            template <class F>
+            std::errc convert_exact(const char* digits, const char* digits_end, int magnitude, bool negative, F& value) noexcept {
+                constexpr int max_digits = 800;
+                bignum d;
+                int n = 0;
+                std::uint32_t chunk = 0;
+                int chunk_digits = 0;
+                bool truncated = false;
+                for (const char* p = digits; p != digits_end; ++p) {
+                    if (*p == '.') continue;
+                    unsigned v = digit_value(*p);
+                    if (n == 0 && v == 0) continue;
+                    if (n == max_digits) {
+                        truncated |= v != 0;
+                        continue;
+                    }
+                    chunk = chunk * 10 + v;
+                    ++n;
+                    if (++chunk_digits == 9) {
+                        d.mul_small(1000000000u);
+                        d.add_small(chunk);
+                        chunk = 0;
+                        chunk_digits = 0;
+                    }
+                }
+                if (chunk_digits != 0) {
+                    std::uint32_t scale = 1;
+                    for (int i = 0; i < chunk_digits; ++i) scale *= 10;
+                    d.mul_small(scale);
+                    d.add_small(chunk);
+                }
+                // any nonzero tail beyond the kept digits only matters as "strictly above"; one more digit says exactly that
+                if (truncated) {
+                    d.mul_small(10);
+                    d.add_small(1);
+                    ++n;
+                }
+
+                int e10 = magnitude - n;
+                std::uint64_t q;
+                int e2;
+                bool sticky;
+                if (e10 >= 0) {
+                    d.mul_pow10(e10);
+                    int from = d.bit_length() - 64;
+                    if (from < 0) from = 0;
+                    q = d.bits64(from, sticky);
+                    e2 = from;
+                } else {
+                    bignum s(1);
+                    s.mul_pow10(-e10);
+                    // scale so that the quotient lands in [2^62, 2^64)
+                    int shift = s.bit_length() - d.bit_length() + 63;
+                    if (shift > 0) {
+                        d.shl(shift);
+                    } else {
+                        s.shl(-shift);
+                    }
+                    s.shl(63);
+                    q = 0;
+                    for (int bit = 63; bit >= 0; --bit) {
+                        if (compare(d, s) >= 0) {
+                            d.sub(s);
+                            q |= std::uint64_t(1) << bit;
+                        }
+                        s.shr1();
+                    }
+                    sticky = !d.is_zero();
+                    e2 = -shift;
+                }
+                return round_to_float(q, e2, sticky, negative, value);
+            }
+
+            template <class F>
+            from_chars_result parse_float(const char* first, const char* last, F& value, chars_format fmt) noexcept {
+                using info = float_info<F>;
+                const char* p = first;
+                bool negative = p != last && *p == '-';
+                p += negative;
+                if (p != last && ((*p | 0x20) == 'i' || (*p | 0x20) == 'n')) return parse_special(first, p, last, negative, value);
+                if (fmt == chars_format::hex) return parse_hex(first, p, last, negative, value);
+
+                // the first 19 significant digits go into w; e10 is the power of ten of w's last digit
+                const char* digits = p;
+                std::uint64_t w = 0;
+                int significant = 0;
+                long e10 = 0;
+                bool truncated = false, any = false;
+                for (; p != last && digit_value(*p) < 10; ++p) {
+                    any = true;
+                    unsigned d = digit_value(*p);
+                    if (significant < 19) {
+                        w = w * 10 + d;
+                        significant += w != 0;
+                    } else {
+                        ++e10;
+                        truncated |= d != 0;
+                    }
+                }
+                if (p != last && *p == '.') {
+                    const char* q = p + 1;
+                    for (; q != last && digit_value(*q) < 10; ++q) {
+                        any = true;
+                        unsigned d = digit_value(*q);
+                        if (significant < 19) {
+                            w = w * 10 + d;
+                            significant += w != 0;
+                            --e10;
+                        } else {
+                            truncated |= d != 0;
+                        }
+                    }
+                    if (any) p = q;
+                }
+                if (!any) return {first, std::errc::invalid_argument};
+                const char* digits_end = p;
+
+                long exponent = 0;
+                bool has_exponent = has(fmt, chars_format::scientific) && p != last && (*p | 0x20) == 'e' && parse_exponent(p, last, exponent);
+                if (fmt == chars_format::scientific && !has_exponent) return {first, std::errc::invalid_argument};
+                e10 += exponent;
+
+                if (w == 0) {
+                    value = negative ? -F(0) : F(0);
+                    return {p, std::errc()};
+                }
+                if (exact_float_arithmetic && !truncated && w <= info::exact_mantissa) {
+                    if (e10 >= -info::exact_pow10 && e10 <= info::exact_pow10) {
+                        F r = static_cast<F>(w);
+                        r = e10 < 0 ? r / info::pow10(static_cast<int>(-e10)) : r * info::pow10(static_cast<int>(e10));
+                        value = negative ? -r : r;
+                        return {p, std::errc()};
+                    }
+                    // 123e25: move powers of ten into w while it stays exact
+                    if (e10 > info::exact_pow10 && e10 <= info::exact_pow10 + 19) {
+                        std::uint64_t scaled = w;
+                        long e = e10;
+                        while (e > info::exact_pow10 && scaled <= info::exact_mantissa / 10) {
+                            scaled *= 10;
+                            --e;
+                        }
+                        if (e == info::exact_pow10) {
+                            F r = static_cast<F>(scaled) * info::pow10(info::exact_pow10);
+                            value = negative ? -r : r;
+                            return {p, std::errc()};
+                        }
+                    }
+                }
+
+                long magnitude = e10 + significant;
+                if (magnitude > info::overflow_magnitude) return {p, std::errc::result_out_of_range};
+                if (magnitude < info::underflow_magnitude) return {p, std::errc::result_out_of_range};
+
+                // with dropped digits the value lies in (w, w + 1) * 10^e10; both ends must agree
+                typename info::bits_type bits, upper_bits;
+                if (eisel_lemire<F>(w, static_cast<int>(e10), bits) &&
+                    (!truncated || (eisel_lemire<F>(w + 1, static_cast<int>(e10), upper_bits) && upper_bits == bits))) {
+                    if (bits == 0 || (bits >> info::mantissa_bits) == static_cast<typename info::bits_type>(info::max_exponent_field)) {
+                        return {p, std::errc::result_out_of_range};
+                    }
+                    if (negative) bits |= typename info::bits_type(1) << (sizeof(bits) * 8 - 1);
+                    value = from_bits<F>(bits);
+                    return {p, std::errc()};
+                }
+                std::errc ec = convert_exact(digits, digits_end, static_cast<int>(magnitude), negative, value);
+                return {p, ec};
+            }
+
+            struct decomposed {
+                std::uint64_t f;
+                int e;
+                bool unequal_gaps;
+            };
+
+            // positive finite nonzero v == f * 2^e; the gap below is half the gap above at a power of two
+            template <class F>
+            decomposed decompose(F v) noexcept {
+                using info = float_info<F>;
+                std::uint64_t bits = to_bits(v);
+                std::uint64_t fraction = bits & ((std::uint64_t(1) << info::mantissa_bits) - 1);
+                int field = static_cast<int>((bits >> info::mantissa_bits) & info::max_exponent_field);
+                if (field == 0) return {fraction, 1 - info::exponent_bias - info::mantissa_bits, false};
+                return {fraction | (std::uint64_t(1) << info::mantissa_bits), field - info::exponent_bias - info::mantissa_bits, fraction == 0 && field > 1};
+            }
+
+            inline int bit_length(std::uint64_t v) noexcept {
+                return v == 0 ? 0 : 64 - leading_zeros(v);
+            }
+
+            // a power of ten at most one below the decimal exponent k of f * 2^e (where 10^(k-1) <= v < 10^k)
+            inline int estimate_k(std::uint64_t f, int e) noexcept {
+                double l = (e + bit_length(f) - 1) * 0.30102999566398114 - 1e-10;
+                int k = static_cast<int>(l);
+                return k < l ? k + 1 : k;
+            }
+
+            // round_to_odd(g * cp / 2^128). g overestimates by at most one unit, so a product that is exact in
+            // real arithmetic leaves a fraction of at most cp.
+            inline std::uint64_t round_to_odd(uint128 g, std::uint64_t cp) noexcept {
+                std::uint64_t x1, y1;
+                std::uint64_t x0 = umul128(g.low, cp, x1);
+                std::uint64_t y0 = umul128(g.high, cp, y1);
+                std::uint64_t z = y0 + x1;
+                y1 += z < y0;
+                return y1 | (z != 0 || x0 > cp);
+            }
+
+            // Schubfach (R. Giulietti): the shortest decimal s * 10^e inside the rounding interval of positive
+            // finite v, the one closest to v when several have that length (ties to even)
+            template <class F>
+            void shortest_decimal(F v, std::uint64_t& s, int& e) noexcept {
+                constexpr int mantissa_bits = float_info<F>::mantissa_bits;
+                decomposed x = decompose(v);
+                std::uint64_t c = x.f;
+                int q = x.e;
+                // integers below 2^(mantissa_bits + 1) are their own shortest form
+                if (q <= 0 && q >= -mantissa_bits && (c & ((std::uint64_t(1) << -q) - 1)) == 0) {
+                    s = c >> -q;
+                    e = 0;
+                    return;
+                }
+
+                bool even = (c & 1) == 0;
+                std::uint64_t cbl = 4 * c - 2 + x.unequal_gaps, cb = 4 * c, cbr = 4 * c + 2;
+                int k = x.unequal_gaps ? floor_log10_three_quarters_pow2(q) : floor_log10_pow2(q);
+                int h = q + floor_log2_pow10(-k) + 1;
+                uint128 g = pow5_significand(-k, true);
+                // the interval bounds and v, scaled by 4 * 10^-k and rounded to odd
+                std::uint64_t vbl = round_to_odd(g, cbl << h);
+                std::uint64_t vb = round_to_odd(g, cb << h);
+                std::uint64_t vbr = round_to_odd(g, cbr << h);
+                std::uint64_t lower = vbl + !even, upper = vbr - !even;
+
+                s = vb / 4;
+                if (s >= 10) {
+                    std::uint64_t sp = s / 10;
+                    bool up_inside = lower <= 40 * sp, wp_inside = 40 * sp + 40 <= upper;
+                    if (up_inside != wp_inside) {
+                        s = sp + wp_inside;
+                        e = k + 1;
+                        return;
+                    }
+                }
+                bool u_inside = lower <= 4 * s, w_inside = 4 * s + 4 <= upper;
+                e = k;
+                if (u_inside != w_inside) {
+                    s += w_inside;
+                    return;
+                }
+                std::uint64_t mid = 4 * s + 2;
+                s += vb > mid || (vb == mid && (s & 1) != 0);
+            }
+
+            // v == 0.d1 d2 ... dn * 10^k on return
+            template <class F>
+            int shortest_digits(F v, char* digits, int& k) noexcept {
+                std::uint64_t s;
+                int e;
+                shortest_decimal(v, s, e);
+                while (s % 10 == 0) {
+                    s /= 10;
+                    ++e;
+                }
+                int n = count_digits10(s);
+                write_digits10(digits + n, s);
+                k = e + n;
+                return n;
+            }
+
+            // Correctly rounded (ties to even) digits of v: `count` significant digits, or digits down to
+            // 10^-count when `fixed`. Digits past the exact expansion are zero and are not stored.
+            // v == 0.d1 d2 ... dn * 10^k on return
+            template <class F>
+            int exact_digits(F v, bool fixed, int count, char* digits, int max_digits, int& k) noexcept {
+                decomposed x = decompose(v);
+                bignum r(x.f), s(1);
+                if (x.e >= 0) {
+                    r.shl(x.e);
+                } else {
+                    s.shl(-x.e);
+                }
+                k = estimate_k(x.f, x.e);
+                if (k >= 0) {
+                    s.mul_pow10(k);
+                } else {
+                    r.mul_pow10(-k);
+                }
+                while (compare(r, s) >= 0) {
+                    s.mul_small(10);
+                    ++k;
+                }
+
+                long wanted = fixed ? static_cast<long>(k) + count : count;
+                if (wanted < 0) return 0;
+                if (wanted == 0) {
+                    // only the rounding of 0.d1... to 0 or 1 unit of the last requested place remains
+                    bignum twice = r;
+                    twice.add(r);
+                    if (compare(twice, s) > 0) {
+                        digits[0] = '1';
+                        ++k;
+                        return 1;
+                    }
+                    return 0;
+                }
+
+                int n = 0;
+                while (n < wanted && n < max_digits && !r.is_zero()) {
+                    r.mul_small(10);
+                    int d = 0;
+                    while (compare(r, s) >= 0) {
+                        r.sub(s);
+                        ++d;
+                    }
+                    digits[n++] = static_cast<char>('0' + d);
+                }
+                if (r.is_zero()) return n;
+                int half = compare_sum(r, r, s);
+                if (half > 0 || (half == 0 && ((digits[n - 1] - '0') & 1) != 0)) {
+                    int i = n - 1;
+                    while (i >= 0 && digits[i] == '9') digits[i--] = '0';
+                    if (i < 0) {
+                        digits[0] = '1';
+                        ++k;
+                        // the digit count in fixed mode grows with k; the new last digit is a zero
+                        return 1;
+                    }
+                    ++digits[i];
+                }
+                while (n > 0 && digits[n - 1] == '0') --n;
+                return n;
+            }
+
+            class writer {
+            private:
+                char* _p;
+                char* _last;
+                bool _ok;
+
+            public:
+                writer(char* first, char* last) noexcept
+                        : _p(first), _last(last), _ok(true) {
+                }
+
+                void put(char c) noexcept {
+                    if (_p == _last) {
+                        _ok = false;
+                        return;
+                    }
+                    *_p++ = c;
+                }
+                void put(char c, long count) noexcept {
+                    if (count <= 0) return;
+                    if (_last - _p < count) {
+                        _ok = false;
+                        _p = _last;
+                        return;
+                    }
+                    std::memset(_p, c, static_cast<std::size_t>(count));
+                    _p += count;
+                }
+                void put(const char* s, long count) noexcept {
+                    if (count <= 0) return;
+                    if (_last - _p < count) {
+                        _ok = false;
+                        _p = _last;
+                        return;
+                    }
+                    std::memcpy(_p, s, static_cast<std::size_t>(count));
+                    _p += count;
+                }
+
+                to_chars_result result() const noexcept {
+                    if (!_ok) return {_last, std::errc::value_too_large};
+                    return {_p, std::errc()};
+                }
+            };
+
+            // n digits of 0.d1 d2 ... * 10^k; digits beyond n are zero. precision < 0 means "exactly the digits"
+            inline void write_fixed(writer& out, const char* digits, int n, int k, long precision) noexcept {
+                if (k <= 0) {
+                    out.put('0');
+                } else {
+                    out.put(digits, n < k ? n : k);
+                    out.put('0', k - n);
+                }
+                long fraction = precision >= 0 ? precision : n - k;
+                if (fraction <= 0) return;
+                out.put('.');
+                // zeros between the point and the first digit, then digits, then zeros past the last digit
+                long leading = k < 0 ? (-k < fraction ? -k : fraction) : 0;
+                long from = k > 0 ? k : 0;
+                long take = n - from < fraction - leading ? n - from : fraction - leading;
+                if (take < 0) take = 0;
+                out.put('0', leading);
+                out.put(digits + from, take);
+                out.put('0', fraction - leading - take);
+            }
+
+            inline void write_scientific(writer& out, const char* digits, int n, int k, long precision, char e = 'e', bool zero = false) noexcept {
+                out.put(n > 0 ? digits[0] : '0');
+                long fraction = precision >= 0 ? precision : n - 1;
+                if (fraction > 0) {
+                    out.put('.');
+                    long take = n - 1 < fraction ? n - 1 : fraction;
+                    out.put(digits + 1, take);
+                    out.put('0', fraction - (take > 0 ? take : 0));
+                }
+                int exponent = zero ? 0 : k - 1;
+                out.put(e);
+                out.put(exponent < 0 ? '-' : '+');
+                unsigned a = static_cast<unsigned>(exponent < 0 ? -exponent : exponent);
+                char buffer[4];
+                int len = count_digits10(a);
+                if (len < 2) {
+                    out.put('0');
+                }
+                write_digits10(buffer + len, a);
+                out.put(buffer, len);
+            }
+
+            inline long scientific_length(int n, int k) noexcept {
+                int exponent = k - 1 < 0 ? 1 - k : k - 1;
+                int exponent_digits = count_digits10(static_cast<unsigned>(exponent));
+                return n + (n > 1) + 2 + (exponent_digits < 2 ? 2 : exponent_digits);
+            }
+
+            inline long fixed_length(int n, int k) noexcept {
+                if (k <= 0) return 2 - k + n;
+                if (k >= n) return k;
+                return n + 1;
+            }
+
+            template <class F>
+            void write_hex(writer& out, F v, long precision) noexcept {
+                using info = float_info<F>;
+                constexpr int nibbles = (info::mantissa_bits + 3) / 4;
+                std::uint64_t bits = to_bits(v);
+                std::uint64_t fraction = (bits & ((std::uint64_t(1) << info::mantissa_bits) - 1)) << (nibbles * 4 - info::mantissa_bits);
+                int field = static_cast<int>((bits >> info::mantissa_bits) & info::max_exponent_field);
+                unsigned lead = field != 0;
+                int exponent = v == 0 ? 0 : (field != 0 ? field : 1) - info::exponent_bias;
+
+                if (precision >= 0 && precision < nibbles) {
+                    int dropped = (nibbles - static_cast<int>(precision)) * 4;
+                    std::uint64_t rest = fraction & ((std::uint64_t(1) << dropped) - 1);
+                    std::uint64_t half = std::uint64_t(1) << (dropped - 1);
+                    fraction >>= dropped;
+                    if (rest > half || (rest == half && (fraction & 1) != 0)) {
+                        ++fraction;
+                        if (fraction >> (precision * 4)) {
+                            fraction = 0;
+                            ++lead;
+                        }
+                    }
+                    fraction <<= dropped;
+                }
+                out.put(digit_chars()[lead]);
+                int shown = nibbles;
+                if (precision < 0) {
+                    while (shown > 0 && ((fraction >> ((nibbles - shown) * 4)) & 0xf) == 0) --shown;
+                } else if (precision < nibbles) {
+                    shown = static_cast<int>(precision);
+                }
+                if (shown > 0 || precision > 0) out.put('.');
+                for (int i = 0; i < shown; ++i) {
+                    out.put(digit_chars()[(fraction >> ((nibbles - 1 - i) * 4)) & 0xf]);
+                }
+                if (precision > nibbles) out.put('0', precision - nibbles);
+                out.put('p');
+                out.put(exponent < 0 ? '-' : '+');
+                unsigned a = static_cast<unsigned>(exponent < 0 ? -exponent : exponent);
+                char buffer[8];
+                int len = count_digits10(a);
+                write_digits10(buffer + len, a);
+                out.put(buffer, len);
+            }
+
+            // sign, infinities and NaN; returns false when v is finite
+            template <class F>
+            bool write_prefix(writer& out, F& v) noexcept {
+                if (std::signbit(v)) {
+                    out.put('-');
+                    v = -v;
+                }
+                if (v != v) {
+                    out.put("nan", 3);
+                    return true;
+                }
+                if (v == std::numeric_limits<F>::infinity()) {
+                    out.put("inf", 3);
+                    return true;
+                }
+                return false;
+            }
+
+            template <class F>
+            to_chars_result format_shortest(char* first, char* last, F v, chars_format fmt, bool plain) noexcept {
+                writer out(first, last);
+                if (write_prefix(out, v)) return out.result();
+                if (fmt == chars_format::hex) {
+                    write_hex(out, v, -1);
+                    return out.result();
+                }
+                if (v == 0) {
+                    if (fmt == chars_format::scientific) {
+                        out.put("0e+00", 5);
+                    } else {
+                        out.put('0');
+                    }
+                    return out.result();
+                }
+                char digits[float_info<F>::max_shortest_digits + 1];
+                int k;
+                int n = shortest_digits(v, digits, k);
+                bool use_fixed;
+                if (fmt == chars_format::fixed) {
+                    use_fixed = true;
+                } else if (fmt == chars_format::scientific) {
+                    use_fixed = false;
+                } else if (plain) {
+                    use_fixed = fixed_length(n, k) <= scientific_length(n, k);
+                } else {
+                    // %g with the shortest round-tripping precision
+                    use_fixed = k - 1 >= -4 && k - 1 < n;
+                }
+                if (use_fixed) {
+                    write_fixed(out, digits, n, k, -1);
+                } else {
+                    write_scientific(out, digits, n, k, -1);
+                }
+                return out.result();
+            }
+
+            template <class F>
+            to_chars_result format_precision(char* first, char* last, F v, chars_format fmt, int precision) noexcept {
+                writer out(first, last);
+                if (write_prefix(out, v)) return out.result();
+                if (precision < 0) precision = 6;
+                if (fmt == chars_format::hex) {
+                    write_hex(out, v, precision);
+                    return out.result();
+                }
+                // long enough for any double's exact expansion; later digits are zero
+                constexpr int max_digits = 800;
+                char digits[max_digits];
+                int k = 0, n = 0;
+                if (fmt == chars_format::fixed) {
+                    if (v != 0) n = exact_digits(v, true, precision, digits, max_digits, k);
+                    if (n == 0) k = 0;
+                    write_fixed(out, digits, n, k, precision);
+                    return out.result();
+                }
+                if (fmt == chars_format::scientific) {
+                    if (v != 0) n = exact_digits(v, false, precision + 1, digits, max_digits, k);
+                    write_scientific(out, digits, n, k, precision, 'e', v == 0);
+                    return out.result();
+                }
+                int p = precision == 0 ? 1 : precision;
+                if (v != 0) n = exact_digits(v, false, p, digits, max_digits, k);
+                int x = v == 0 ? 0 : k - 1;
+                if (x >= -4 && x < p) {
+                    write_fixed(out, digits, n, v == 0 ? 1 : k, -1);
+                } else {
+                    write_scientific(out, digits, n, k, -1);
+                }
+                return out.result();
+            }
+        } // namespace charconv
+    }     // namespace detail
+
+    template <class T, detail::charconv::enable_if_integer<T> = 0>
+    from_chars_result from_chars(const char* first, const char* last, T& value, int base = 10) noexcept {
+        return detail::charconv::parse_integer(first, last, value, static_cast<unsigned>(base), std::is_signed<T>());
+    }
+
+    template <class T, detail::charconv::enable_if_float<T> = 0>
+    from_chars_result from_chars(const char* first, const char* last, T& value, chars_format fmt = chars_format::general) noexcept {
+        return detail::charconv::parse_float(first, last, value, fmt);
+    }
+
+    template <class T, detail::charconv::enable_if_integer<T> = 0>
+    to_chars_result to_chars(char* first, char* last, T value, int base = 10) noexcept {
+        return detail::charconv::format_integer(first, last, value, static_cast<unsigned>(base), std::is_signed<T>());
+    }
+
+    to_chars_result to_chars(char*, char*, bool, int = 10) = delete;
+
+    // shortest representation that reads back as the same value
+    template <class T, detail::charconv::enable_if_float<T> = 0>
+    to_chars_result to_chars(char* first, char* last, T value) noexcept {
+        return detail::charconv::format_shortest(first, last, value, chars_format::general, true);
+    }
+
+    template <class T, detail::charconv::enable_if_float<T> = 0>
+    to_chars_result to_chars(char* first, char* last, T value, chars_format fmt) noexcept {
+        return detail::charconv::format_shortest(first, last, value, fmt, false);
+    }
+
+    template <class T, detail::charconv::enable_if_float<T> = 0>
+    to_chars_result to_chars(char* first, char* last, T value, chars_format fmt, int precision) noexcept {
+        return detail::charconv::format_precision(first, last, value, fmt, precision);
+    }
+
+    // the whole view must be a number; anything left over is invalid_argument
+    template <class T, detail::charconv::enable_if_integer<T> = 0>
+    std::errc from_chars(string_view s, T& value, int base = 10) noexcept {
+        T v;
+        from_chars_result r = from_chars(s.data(), s.data() + s.size(), v, base);
+        if (r.ec != std::errc()) return r.ec;
+        if (r.ptr != s.data() + s.size()) return std::errc::invalid_argument;
+        value = v;
+        return std::errc();
+    }
+
+    template <class T, detail::charconv::enable_if_float<T> = 0>
+    std::errc from_chars(string_view s, T& value, chars_format fmt = chars_format::general) noexcept {
+        T v;
+        from_chars_result r = from_chars(s.data(), s.data() + s.size(), v, fmt);
+        if (r.ec != std::errc()) return r.ec;
+        if (r.ptr != s.data() + s.size()) return std::errc::invalid_argument;
+        value = v;
+        return std::errc();
+    }
+
+    template <class T>
+    optional<T> from_chars(string_view s) noexcept {
+        T v;
+        if (from_chars(s, v) != std::errc()) return nullopt;
+        return v;
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_CHARCONV_HPP
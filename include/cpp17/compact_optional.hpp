@@ -0,0 +1,195 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_COMPACT_OPTIONAL_HPP
+#define LIBCPP17_COMPACT_OPTIONAL_HPP
+
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "detail/only.hpp"
+#include "optional.hpp"
+#include "string_view.hpp"
+
+namespace cpp17 {
+    // A policy supplies the value that encodes "no value" and a test for it:
+    //   static constexpr T empty_value() noexcept;
+    //   static constexpr bool is_empty(const T&) noexcept;
+
+    template <class T>
+    struct nan_policy {
+        static_assert(std::numeric_limits<T>::has_quiet_NaN, "nan_policy requires a type with a quiet NaN");
+
+        static constexpr T empty_value() noexcept {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+        static constexpr bool is_empty(const T& v) noexcept {
+            return v != v;
+        }
+    };
+
+    template <class T, T Sentinel>
+    struct sentinel_policy {
+        static constexpr T empty_value() noexcept {
+            return Sentinel;
+        }
+        static constexpr bool is_empty(const T& v) noexcept {
+            return v == Sentinel;
+        }
+    };
+
+    template <class T>
+    using minus_one_policy = sentinel_policy<T, static_cast<T>(-1)>;
+
+    template <class T>
+    struct max_value_policy {
+        static constexpr T empty_value() noexcept {
+            return std::numeric_limits<T>::max();
+        }
+        static constexpr bool is_empty(const T& v) noexcept {
+            return v == std::numeric_limits<T>::max();
+        }
+    };
+
+    template <class T>
+    struct null_policy {
+        static constexpr T empty_value() noexcept {
+            return nullptr;
+        }
+        static constexpr bool is_empty(const T& v) noexcept {
+            return v == nullptr;
+        }
+    };
+
+    // an empty view cannot be stored as a value under this policy
+    template <class CharT, class Traits = std::char_traits<CharT>>
+    struct empty_string_view_policy {
+        static constexpr basic_string_view<CharT, Traits> empty_value() noexcept {
+            return basic_string_view<CharT, Traits>();
+        }
+        static constexpr bool is_empty(const basic_string_view<CharT, Traits>& v) noexcept {
+            return v.empty();
+        }
+    };
+
+    template <class T, class Policy>
+    class compact_optional {
+    public:
+        using value_type = T;
+        using policy_type = Policy;
+
+    private:
+        T _value;
+
+    public:
+        constexpr compact_optional() noexcept
+                : _value(Policy::empty_value()) {
+        }
+        constexpr compact_optional(nullopt_t) noexcept
+                : compact_optional() {
+        }
+        constexpr compact_optional(const T& v)
+                : _value(v) {
+        }
+        constexpr compact_optional(T&& v)
+                : _value(std::move(v)) {
+        }
+        template <class... Args>
+        explicit constexpr compact_optional(in_place_t, Args&&... args)
+                : _value(std::forward<Args>(args)...) {
+        }
+
+        compact_optional& operator=(nullopt_t) noexcept {
+            reset();
+            return *this;
+        }
+        compact_optional& operator=(const T& v) {
+            _value = v;
+            return *this;
+        }
+        compact_optional& operator=(T&& v) {
+            _value = std::move(v);
+            return *this;
+        }
+
+    public:
+        template <class... Args>
+        T& emplace(Args&&... args) {
+            _value = T(std::forward<Args>(args)...);
+            return _value;
+        }
+        void reset() noexcept {
+            _value = Policy::empty_value();
+        }
+
+    public:
+        constexpr bool has_value() const noexcept {
+            return !Policy::is_empty(_value);
+        }
+        constexpr explicit operator bool() const noexcept {
+            return has_value();
+        }
+
+    public:
+        USE_OVER_CPP14(constexpr)
+        T* operator->() noexcept {
+            return &_value;
+        }
+        constexpr const T* operator->() const noexcept {
+            return &_value;
+        }
+
+        USE_OVER_CPP14(constexpr)
+        T& value() noexcept {
+            return _value;
+        }
+        constexpr const T& value() const noexcept {
+            return _value;
+        }
+
+        USE_OVER_CPP14(constexpr)
+        T& operator*() noexcept {
+            return _value;
+        }
+        constexpr const T& operator*() const noexcept {
+            return _value;
+        }
+
+    public:
+        template <class U>
+        constexpr T value_or(U&& v) const {
+            return has_value() ? _value : static_cast<T>(std::forward<U>(v));
+        }
+
+        optional<T> to_optional() const {
+            return has_value() ? optional<T>(_value) : optional<T>();
+        }
+
+    public:
+        void swap(compact_optional& rhs) {
+            using std::swap;
+            swap(_value, rhs._value);
+        }
+    };
+
+    template <class T, class Policy>
+    void swap(compact_optional<T, Policy>& lhs, compact_optional<T, Policy>& rhs) {
+        lhs.swap(rhs);
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_COMPACT_OPTIONAL_HPP
@@ -0,0 +1,82 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_CSTDDEF_HPP
+#define LIBCPP17_CSTDDEF_HPP
+
+#include <type_traits>
+
+#include "detail/only.hpp"
+
+namespace cpp17 {
+    // raw memory: bit operations but no arithmetic, and no implicit conversion to or from integers;
+    // like std::byte it may alias any object
+    enum class CPP17_MAY_ALIAS byte : unsigned char {
+    };
+
+    template <class IntegerType>
+    constexpr typename std::enable_if<std::is_integral<IntegerType>::value, IntegerType>::type to_integer(byte b) noexcept {
+        return static_cast<IntegerType>(b);
+    }
+
+    template <class IntegerType>
+    constexpr typename std::enable_if<std::is_integral<IntegerType>::value, byte>::type operator<<(byte b, IntegerType shift) noexcept {
+        return static_cast<byte>(static_cast<unsigned char>(static_cast<unsigned int>(b) << shift));
+    }
+    template <class IntegerType>
+    constexpr typename std::enable_if<std::is_integral<IntegerType>::value, byte>::type operator>>(byte b, IntegerType shift) noexcept {
+        return static_cast<byte>(static_cast<unsigned char>(static_cast<unsigned int>(b) >> shift));
+    }
+    template <class IntegerType>
+    USE_OVER_CPP14(constexpr)
+    typename std::enable_if<std::is_integral<IntegerType>::value, byte&>::type operator<<=(byte& b, IntegerType shift) noexcept {
+        return b = b << shift;
+    }
+    template <class IntegerType>
+    USE_OVER_CPP14(constexpr)
+    typename std::enable_if<std::is_integral<IntegerType>::value, byte&>::type operator>>=(byte& b, IntegerType shift) noexcept {
+        return b = b >> shift;
+    }
+
+    constexpr byte operator|(byte l, byte r) noexcept {
+        return static_cast<byte>(static_cast<unsigned char>(static_cast<unsigned int>(l) | static_cast<unsigned int>(r)));
+    }
+    constexpr byte operator&(byte l, byte r) noexcept {
+        return static_cast<byte>(static_cast<unsigned char>(static_cast<unsigned int>(l) & static_cast<unsigned int>(r)));
+    }
+    constexpr byte operator^(byte l, byte r) noexcept {
+        return static_cast<byte>(static_cast<unsigned char>(static_cast<unsigned int>(l) ^ static_cast<unsigned int>(r)));
+    }
+    constexpr byte operator~(byte b) noexcept {
+        return static_cast<byte>(static_cast<unsigned char>(~static_cast<unsigned int>(b)));
+    }
+
+    USE_OVER_CPP14(constexpr)
+    inline byte& operator|=(byte& l, byte r) noexcept {
+        return l = l | r;
+    }
+    USE_OVER_CPP14(constexpr)
+    inline byte& operator&=(byte& l, byte r) noexcept {
+        return l = l & r;
+    }
+    USE_OVER_CPP14(constexpr)
+    inline byte& operator^=(byte& l, byte r) noexcept {
+        return l = l ^ r;
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_CSTDDEF_HPP
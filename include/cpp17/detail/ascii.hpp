@@ -0,0 +1,76 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_ASCII_HPP
+#define LIBCPP17_ASCII_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace cpp17 {
+    namespace detail {
+        namespace ascii {
+            constexpr std::uint64_t ones = 0x0101010101010101ull;
+            constexpr std::uint64_t high = 0x8080808080808080ull;
+
+            inline unsigned char to_lower(unsigned char c) noexcept {
+                return static_cast<unsigned char>(c - 'A') < 26u ? static_cast<unsigned char>(c | 0x20) : c;
+            }
+
+            // folds 'A'-'Z' in all eight bytes at once; bytes outside ASCII pass through unchanged
+            inline std::uint64_t to_lower8(std::uint64_t x) noexcept {
+                std::uint64_t low7 = x & ~high;
+                std::uint64_t above_z = low7 + (0x7f - 'Z') * ones;
+                std::uint64_t from_a = low7 + (0x80 - 'A') * ones;
+                std::uint64_t upper = (above_z ^ from_a) & ~x & high;
+                return x | (upper >> 2);
+            }
+
+            inline std::uint64_t load8(const char* p) noexcept {
+                std::uint64_t v;
+                std::memcpy(&v, p, 8);
+                return v;
+            }
+
+            inline int compare_tail(const char* a, const char* b, std::size_t n) noexcept {
+                for (std::size_t i = 0; i < n; ++i) {
+                    int d = to_lower(static_cast<unsigned char>(a[i])) - to_lower(static_cast<unsigned char>(b[i]));
+                    if (d != 0) return d;
+                }
+                return 0;
+            }
+
+            inline bool equal(const char* a, const char* b, std::size_t n) noexcept {
+                std::size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    if (to_lower8(load8(a + i)) != to_lower8(load8(b + i))) return false;
+                }
+                return compare_tail(a + i, b + i, n - i) == 0;
+            }
+
+            inline int compare(const char* a, const char* b, std::size_t n) noexcept {
+                std::size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    if (to_lower8(load8(a + i)) != to_lower8(load8(b + i))) return compare_tail(a + i, b + i, 8);
+                }
+                return compare_tail(a + i, b + i, n - i);
+            }
+        } // namespace ascii
+    } // namespace detail
+} // namespace cpp17
+
+#endif //LIBCPP17_ASCII_HPP
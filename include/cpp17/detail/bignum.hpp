@@ -0,0 +1,206 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_BIGNUM_HPP
+#define LIBCPP17_BIGNUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cpp17 {
+    namespace detail {
+        // fixed-capacity unsigned big integer for exact float <-> decimal conversion;
+        // 6400 bits covers every intermediate the charconv algorithms produce
+        class bignum {
+        public:
+            static constexpr int capacity = 200;
+
+        private:
+            std::uint32_t _limbs[capacity];
+            int _size;
+
+        public:
+            bignum() noexcept
+                    : _size(0) {
+            }
+            explicit bignum(std::uint64_t v) noexcept
+                    : _size(0) {
+                while (v != 0) {
+                    _limbs[_size++] = static_cast<std::uint32_t>(v);
+                    v >>= 32;
+                }
+            }
+            // only the used limbs are copied
+            bignum(const bignum& rhs) noexcept
+                    : _size(rhs._size) {
+                for (int i = 0; i < _size; ++i) _limbs[i] = rhs._limbs[i];
+            }
+            bignum& operator=(const bignum& rhs) noexcept {
+                _size = rhs._size;
+                for (int i = 0; i < _size; ++i) _limbs[i] = rhs._limbs[i];
+                return *this;
+            }
+
+        public:
+            bool is_zero() const noexcept {
+                return _size == 0;
+            }
+
+            int bit_length() const noexcept {
+                if (_size == 0) return 0;
+                int bits = (_size - 1) * 32;
+                for (std::uint32_t top = _limbs[_size - 1]; top != 0; top >>= 1) ++bits;
+                return bits;
+            }
+
+            bool bit(int i) const noexcept {
+                return i / 32 < _size && ((_limbs[i / 32] >> (i % 32)) & 1);
+            }
+
+            // bits [from, from + 64) for from >= 0, and whether anything below `from` is set
+            std::uint64_t bits64(int from, bool& sticky) const noexcept {
+                std::uint64_t v = 0;
+                for (int i = 63; i >= 0; --i) {
+                    v = (v << 1) | (bit(from + i) ? 1 : 0);
+                }
+                int whole = from / 32;
+                sticky = whole < _size && (_limbs[whole] & ((std::uint32_t(1) << (from % 32)) - 1)) != 0;
+                for (int i = 0; i < whole && i < _size && !sticky; ++i) {
+                    sticky = _limbs[i] != 0;
+                }
+                return v;
+            }
+
+        public:
+            void mul_small(std::uint32_t m) noexcept {
+                std::uint64_t carry = 0;
+                for (int i = 0; i < _size; ++i) {
+                    std::uint64_t p = std::uint64_t(_limbs[i]) * m + carry;
+                    _limbs[i] = static_cast<std::uint32_t>(p);
+                    carry = p >> 32;
+                }
+                if (carry != 0) _limbs[_size++] = static_cast<std::uint32_t>(carry);
+            }
+
+            void add_small(std::uint32_t a) noexcept {
+                std::uint64_t carry = a;
+                for (int i = 0; i < _size && carry != 0; ++i) {
+                    std::uint64_t s = std::uint64_t(_limbs[i]) + carry;
+                    _limbs[i] = static_cast<std::uint32_t>(s);
+                    carry = s >> 32;
+                }
+                if (carry != 0) _limbs[_size++] = static_cast<std::uint32_t>(carry);
+            }
+
+            // floor division; returns the remainder
+            std::uint32_t div_small(std::uint32_t d) noexcept {
+                std::uint64_t rest = 0;
+                for (int i = _size - 1; i >= 0; --i) {
+                    std::uint64_t v = (rest << 32) | _limbs[i];
+                    _limbs[i] = static_cast<std::uint32_t>(v / d);
+                    rest = v % d;
+                }
+                _trim();
+                return static_cast<std::uint32_t>(rest);
+            }
+
+            void mul_pow5(int n) noexcept {
+                for (; n >= 13; n -= 13) {
+                    mul_small(1220703125u);
+                }
+                std::uint32_t m = 1;
+                for (; n > 0; --n) m *= 5;
+                if (m != 1) mul_small(m);
+            }
+
+            void mul_pow10(int n) noexcept {
+                mul_pow5(n);
+                shl(n);
+            }
+
+            void shl(int n) noexcept {
+                if (_size == 0 || n == 0) return;
+                int limbs = n / 32, bits = n % 32;
+                if (bits != 0) {
+                    std::uint32_t carry = 0;
+                    for (int i = 0; i < _size; ++i) {
+                        std::uint32_t v = _limbs[i];
+                        _limbs[i] = (v << bits) | carry;
+                        carry = v >> (32 - bits);
+                    }
+                    if (carry != 0) _limbs[_size++] = carry;
+                }
+                if (limbs != 0) {
+                    for (int i = _size - 1; i >= 0; --i) _limbs[i + limbs] = _limbs[i];
+                    for (int i = 0; i < limbs; ++i) _limbs[i] = 0;
+                    _size += limbs;
+                }
+            }
+
+            void shr1() noexcept {
+                for (int i = 0; i < _size; ++i) {
+                    _limbs[i] = (_limbs[i] >> 1) | (i + 1 < _size ? _limbs[i + 1] << 31 : 0);
+                }
+                _trim();
+            }
+
+            void add(const bignum& b) noexcept {
+                std::uint64_t carry = 0;
+                int n = _size > b._size ? _size : b._size;
+                for (int i = 0; i < n; ++i) {
+                    std::uint64_t s = carry + (i < _size ? _limbs[i] : 0) + (i < b._size ? b._limbs[i] : 0);
+                    _limbs[i] = static_cast<std::uint32_t>(s);
+                    carry = s >> 32;
+                }
+                _size = n;
+                if (carry != 0) _limbs[_size++] = static_cast<std::uint32_t>(carry);
+            }
+
+            // requires *this >= b
+            void sub(const bignum& b) noexcept {
+                std::int64_t borrow = 0;
+                for (int i = 0; i < _size; ++i) {
+                    std::int64_t d = std::int64_t(_limbs[i]) - (i < b._size ? b._limbs[i] : 0) - borrow;
+                    borrow = d < 0;
+                    _limbs[i] = static_cast<std::uint32_t>(d + (borrow << 32));
+                }
+                _trim();
+            }
+
+            friend int compare(const bignum& a, const bignum& b) noexcept {
+                if (a._size != b._size) return a._size < b._size ? -1 : 1;
+                for (int i = a._size - 1; i >= 0; --i) {
+                    if (a._limbs[i] != b._limbs[i]) return a._limbs[i] < b._limbs[i] ? -1 : 1;
+                }
+                return 0;
+            }
+
+            // compare(a + b, c)
+            friend int compare_sum(const bignum& a, const bignum& b, const bignum& c) noexcept {
+                bignum s = a;
+                s.add(b);
+                return compare(s, c);
+            }
+
+        private:
+            void _trim() noexcept {
+                while (_size > 0 && _limbs[_size - 1] == 0) --_size;
+            }
+        };
+    } // namespace detail
+} // namespace cpp17
+
+#endif //LIBCPP17_BIGNUM_HPP
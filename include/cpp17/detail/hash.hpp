@@ -0,0 +1,105 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_HASH_HPP
+#define LIBCPP17_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "int128.hpp"
+
+namespace cpp17 {
+    namespace detail {
+        // wyhash-style byte hash: 64x64->128 multiply-and-fold mixing, three independent lanes for long inputs.
+        // Values depend on byte order and are not meant to be persisted.
+        namespace wyhash {
+            constexpr std::uint64_t secret0 = 0x2d358dccaa6c78a5ull;
+            constexpr std::uint64_t secret1 = 0x8bb84b93962eacc9ull;
+            constexpr std::uint64_t secret2 = 0x4b33a62ed433d4a3ull;
+            constexpr std::uint64_t secret3 = 0x4d5a2da51de1aa47ull;
+
+            inline void multiply(std::uint64_t& a, std::uint64_t& b) noexcept {
+                a = umul128(a, b, b);
+            }
+
+            inline std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept {
+                multiply(a, b);
+                return a ^ b;
+            }
+
+            inline std::uint64_t read8(const unsigned char* p) noexcept {
+                std::uint64_t v;
+                std::memcpy(&v, p, 8);
+                return v;
+            }
+            inline std::uint64_t read4(const unsigned char* p) noexcept {
+                std::uint32_t v;
+                std::memcpy(&v, p, 4);
+                return v;
+            }
+            inline std::uint64_t read3(const unsigned char* p, std::size_t k) noexcept {
+                return (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[k >> 1]) << 8) | p[k - 1];
+            }
+        } // namespace wyhash
+
+        inline std::uint64_t hash_bytes(const void* data, std::size_t len, std::uint64_t seed = 0) noexcept {
+            using namespace wyhash;
+            auto p = static_cast<const unsigned char*>(data);
+            seed ^= mix(seed ^ secret0, secret1);
+            std::uint64_t a, b;
+            if (len <= 16) {
+                if (len >= 4) {
+                    std::size_t off = (len >> 3) << 2;
+                    a = (read4(p) << 32) | read4(p + off);
+                    b = (read4(p + len - 4) << 32) | read4(p + len - 4 - off);
+                } else if (len > 0) {
+                    a = read3(p, len);
+                    b = 0;
+                } else {
+                    a = b = 0;
+                }
+            } else {
+                std::size_t i = len;
+                if (i > 48) {
+                    std::uint64_t see1 = seed, see2 = seed;
+                    do {
+                        seed = mix(read8(p) ^ secret1, read8(p + 8) ^ seed);
+                        see1 = mix(read8(p + 16) ^ secret2, read8(p + 24) ^ see1);
+                        see2 = mix(read8(p + 32) ^ secret3, read8(p + 40) ^ see2);
+                        p += 48;
+                        i -= 48;
+                    } while (i > 48);
+                    seed ^= see1 ^ see2;
+                }
+                while (i > 16) {
+                    seed = mix(read8(p) ^ secret1, read8(p + 8) ^ seed);
+                    i -= 16;
+                    p += 16;
+                }
+                a = read8(p + i - 16);
+                b = read8(p + i - 8);
+            }
+            a ^= secret1;
+            b ^= seed;
+            multiply(a, b);
+            return mix(a ^ secret0 ^ len, b ^ secret1);
+        }
+    } // namespace detail
+} // namespace cpp17
+
+#endif //LIBCPP17_HASH_HPP
@@ -0,0 +1,51 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_INT128_HPP
+#define LIBCPP17_INT128_HPP
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace cpp17 {
+    namespace detail {
+        // full 64x64 -> 128 bit product: returns the low half, stores the high half in `high`
+        inline std::uint64_t umul128(std::uint64_t a, std::uint64_t b, std::uint64_t& high) noexcept {
+#if defined(__SIZEOF_INT128__)
+            unsigned __int128 r = a;
+            r *= b;
+            high = static_cast<std::uint64_t>(r >> 64);
+            return static_cast<std::uint64_t>(r);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            return _umul128(a, b, &high);
+#else
+            std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+            std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            std::uint64_t t = rl + (rm0 << 32), c = t < rl;
+            std::uint64_t lo = t + (rm1 << 32);
+            c += lo < t;
+            high = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+            return lo;
+#endif
+        }
+    } // namespace detail
+} // namespace cpp17
+
+#endif //LIBCPP17_INT128_HPP
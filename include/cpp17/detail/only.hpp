@@ -39,4 +39,31 @@
 #define USE_OVER_CPP17(value) /* cannot use in this version */
 #endif
 
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define CPP17_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+#endif
+#if !defined(CPP17_HAS_IS_CONSTANT_EVALUATED) && defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9
+#define CPP17_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+#if !defined(CPP17_HAS_IS_CONSTANT_EVALUATED) && defined(_MSC_VER) && _MSC_VER >= 1925
+#define CPP17_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+
+// Selects a constexpr-friendly path during constant evaluation. Without compiler support the
+// runtime path is always taken, so functions using it cannot be evaluated at compile time.
+#if CPP17_HAS_IS_CONSTANT_EVALUATED
+#define CPP17_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define CPP17_IS_CONSTANT_EVALUATED() false
+#endif
+
+// Lets a type read and write the object representation of other types, as unsigned char does.
+#if defined(__GNUC__) || defined(__clang__)
+#define CPP17_MAY_ALIAS __attribute__((__may_alias__))
+#else
+#define CPP17_MAY_ALIAS
+#endif
+
 #endif //LIBCPP17_ONLY_HPP
@@ -0,0 +1,184 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_SPECIAL_MEMBERS_HPP
+#define LIBCPP17_SPECIAL_MEMBERS_HPP
+
+#include <type_traits>
+
+#include "utility.hpp"
+
+namespace cpp17 {
+    namespace detail {
+        struct uninitialized_t {
+        };
+
+        enum class special { trivial, non_trivial, deleted };
+
+        template <class Base, bool Trivial>
+        struct destructor_layer : Base {
+            using Base::Base;
+        };
+        template <class Base>
+        struct destructor_layer<Base, false> : Base {
+            using Base::Base;
+            destructor_layer(const destructor_layer&) = default;
+            destructor_layer(destructor_layer&&) = default;
+            destructor_layer& operator=(const destructor_layer&) = default;
+            destructor_layer& operator=(destructor_layer&&) = default;
+            ~destructor_layer() {
+                this->_reset();
+            }
+        };
+
+        template <class Base, special S>
+        struct copy_ctor_layer : Base {
+            using Base::Base;
+        };
+        template <class Base>
+        struct copy_ctor_layer<Base, special::non_trivial> : Base {
+            using Base::Base;
+            copy_ctor_layer(const copy_ctor_layer& rhs)
+                    : Base(uninitialized_t()) {
+                this->_copy_construct(rhs);
+            }
+            copy_ctor_layer(copy_ctor_layer&&) = default;
+            copy_ctor_layer& operator=(const copy_ctor_layer&) = default;
+            copy_ctor_layer& operator=(copy_ctor_layer&&) = default;
+        };
+        template <class Base>
+        struct copy_ctor_layer<Base, special::deleted> : Base {
+            using Base::Base;
+            copy_ctor_layer(const copy_ctor_layer&) = delete;
+            copy_ctor_layer(copy_ctor_layer&&) = default;
+            copy_ctor_layer& operator=(const copy_ctor_layer&) = default;
+            copy_ctor_layer& operator=(copy_ctor_layer&&) = default;
+        };
+
+        template <class Base, special S, bool NoThrow>
+        struct move_ctor_layer : Base {
+            using Base::Base;
+        };
+        template <class Base, bool NoThrow>
+        struct move_ctor_layer<Base, special::non_trivial, NoThrow> : Base {
+            using Base::Base;
+            move_ctor_layer(const move_ctor_layer&) = default;
+            move_ctor_layer(move_ctor_layer&& rhs) noexcept(NoThrow)
+                    : Base(uninitialized_t()) {
+                this->_move_construct(rhs);
+            }
+            move_ctor_layer& operator=(const move_ctor_layer&) = default;
+            move_ctor_layer& operator=(move_ctor_layer&&) = default;
+        };
+        template <class Base, bool NoThrow>
+        struct move_ctor_layer<Base, special::deleted, NoThrow> : Base {
+            using Base::Base;
+            move_ctor_layer(const move_ctor_layer&) = default;
+            move_ctor_layer(move_ctor_layer&&) = delete;
+            move_ctor_layer& operator=(const move_ctor_layer&) = default;
+            move_ctor_layer& operator=(move_ctor_layer&&) = default;
+        };
+
+        template <class Base, special S>
+        struct copy_assign_layer : Base {
+            using Base::Base;
+        };
+        template <class Base>
+        struct copy_assign_layer<Base, special::non_trivial> : Base {
+            using Base::Base;
+            copy_assign_layer(const copy_assign_layer&) = default;
+            copy_assign_layer(copy_assign_layer&&) = default;
+            copy_assign_layer& operator=(const copy_assign_layer& rhs) {
+                this->_copy_assign(rhs);
+                return *this;
+            }
+            copy_assign_layer& operator=(copy_assign_layer&&) = default;
+        };
+        template <class Base>
+        struct copy_assign_layer<Base, special::deleted> : Base {
+            using Base::Base;
+            copy_assign_layer(const copy_assign_layer&) = default;
+            copy_assign_layer(copy_assign_layer&&) = default;
+            copy_assign_layer& operator=(const copy_assign_layer&) = delete;
+            copy_assign_layer& operator=(copy_assign_layer&&) = default;
+        };
+
+        template <class Base, special S, bool NoThrow>
+        struct move_assign_layer : Base {
+            using Base::Base;
+        };
+        template <class Base, bool NoThrow>
+        struct move_assign_layer<Base, special::non_trivial, NoThrow> : Base {
+            using Base::Base;
+            move_assign_layer(const move_assign_layer&) = default;
+            move_assign_layer(move_assign_layer&&) = default;
+            move_assign_layer& operator=(const move_assign_layer&) = default;
+            move_assign_layer& operator=(move_assign_layer&& rhs) noexcept(NoThrow) {
+                this->_move_assign(rhs);
+                return *this;
+            }
+        };
+        template <class Base, bool NoThrow>
+        struct move_assign_layer<Base, special::deleted, NoThrow> : Base {
+            using Base::Base;
+            move_assign_layer(const move_assign_layer&) = default;
+            move_assign_layer(move_assign_layer&&) = default;
+            move_assign_layer& operator=(const move_assign_layer&) = default;
+            move_assign_layer& operator=(move_assign_layer&&) = delete;
+        };
+
+        constexpr special select_special(bool possible, bool trivial) {
+            return !possible ? special::deleted : (trivial ? special::trivial : special::non_trivial);
+        }
+
+        template <class... Ts>
+        struct special_member_traits {
+            static constexpr bool trivially_destructible = all_of<std::is_trivially_destructible<Ts>::value...>::value;
+
+            static constexpr special copy_ctor = select_special(
+                    all_of<std::is_copy_constructible<Ts>::value...>::value,
+                    all_of<std::is_trivially_copy_constructible<Ts>::value...>::value);
+            static constexpr special move_ctor = select_special(
+                    all_of<std::is_move_constructible<Ts>::value...>::value,
+                    all_of<std::is_trivially_move_constructible<Ts>::value...>::value);
+            static constexpr special copy_assign = select_special(
+                    all_of<(std::is_copy_constructible<Ts>::value && std::is_copy_assignable<Ts>::value)...>::value,
+                    trivially_destructible && all_of<(std::is_trivially_copy_constructible<Ts>::value && std::is_trivially_copy_assignable<Ts>::value)...>::value);
+            static constexpr special move_assign = select_special(
+                    all_of<(std::is_move_constructible<Ts>::value && std::is_move_assignable<Ts>::value)...>::value,
+                    trivially_destructible && all_of<(std::is_trivially_move_constructible<Ts>::value && std::is_trivially_move_assignable<Ts>::value)...>::value);
+
+            static constexpr bool nothrow_move_ctor = all_of<std::is_nothrow_move_constructible<Ts>::value...>::value;
+            static constexpr bool nothrow_move_assign = all_of<(std::is_nothrow_move_constructible<Ts>::value && std::is_nothrow_move_assignable<Ts>::value)...>::value;
+        };
+
+        // Storage must provide a constructor from uninitialized_t and _reset, _copy_construct,
+        // _move_construct, _copy_assign and _move_assign. Each layer controls one special member so that
+        // it stays trivial (or deleted) whenever it is trivial (or deleted) for every one of Ts.
+        template <class Storage, class... Ts>
+        using special_member_base = move_assign_layer<
+                copy_assign_layer<
+                        move_ctor_layer<
+                                copy_ctor_layer<
+                                        destructor_layer<Storage, special_member_traits<Ts...>::trivially_destructible>,
+                                        special_member_traits<Ts...>::copy_ctor>,
+                                special_member_traits<Ts...>::move_ctor, special_member_traits<Ts...>::nothrow_move_ctor>,
+                        special_member_traits<Ts...>::copy_assign>,
+                special_member_traits<Ts...>::move_assign, special_member_traits<Ts...>::nothrow_move_assign>;
+    } // namespace detail
+} // namespace cpp17
+
+#endif //LIBCPP17_SPECIAL_MEMBERS_HPP
@@ -0,0 +1,229 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_STRING_SEARCH_HPP
+#define LIBCPP17_STRING_SEARCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cpp17 {
+    namespace detail {
+        // membership test for the find_*_of family: a 256-bit bitmap for byte-sized characters
+        template <class Traits, bool Bitmap = sizeof(typename Traits::char_type) == 1>
+        class char_set {
+        private:
+            using char_type = typename Traits::char_type;
+
+            std::uint64_t _bits[4];
+
+        public:
+            char_set(const char_type* s, std::size_t n) noexcept
+                    : _bits() {
+                for (std::size_t i = 0; i < n; ++i) {
+                    auto c = static_cast<unsigned char>(s[i]);
+                    _bits[c >> 6] |= std::uint64_t(1) << (c & 63);
+                }
+            }
+            bool contains(char_type c) const noexcept {
+                auto u = static_cast<unsigned char>(c);
+                return (_bits[u >> 6] >> (u & 63)) & 1;
+            }
+        };
+        template <class Traits>
+        class char_set<Traits, false> {
+        private:
+            using char_type = typename Traits::char_type;
+
+            const char_type* _s;
+            std::size_t _n;
+
+        public:
+            char_set(const char_type* s, std::size_t n) noexcept
+                    : _s(s), _n(n) {
+            }
+            bool contains(char_type c) const noexcept {
+                return Traits::find(_s, _n, c) != nullptr;
+            }
+        };
+
+        template <class Traits>
+        struct string_search {
+            using char_type = typename Traits::char_type;
+
+            static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+            // needles up to this length are found by scanning for their first character and comparing
+            static constexpr std::size_t short_needle = 16;
+
+            static std::size_t find(const char_type* h, std::size_t n, char_type c, std::size_t pos) noexcept {
+                if (pos >= n) return npos;
+                const char_type* p = Traits::find(h + pos, n - pos, c);
+                return p == nullptr ? npos : static_cast<std::size_t>(p - h);
+            }
+
+            static std::size_t find(const char_type* h, std::size_t n, const char_type* x, std::size_t m, std::size_t pos) noexcept {
+                if (m == 0) return pos <= n ? pos : npos;
+                if (pos > n || m > n - pos) return npos;
+                if (m == 1) return find(h, n, x[0], pos);
+                if (m <= short_needle) return _find_short(h, n, x, m, pos);
+
+                std::size_t r = _two_way(h + pos, n - pos, x, m);
+                return r == npos ? npos : r + pos;
+            }
+
+            static std::size_t rfind(const char_type* h, std::size_t n, char_type c, std::size_t pos) noexcept {
+                if (n == 0) return npos;
+                for (std::size_t i = pos < n ? pos + 1 : n; i > 0; --i) {
+                    if (Traits::eq(h[i - 1], c)) return i - 1;
+                }
+                return npos;
+            }
+
+            static std::size_t rfind(const char_type* h, std::size_t n, const char_type* x, std::size_t m, std::size_t pos) noexcept {
+                if (m > n) return npos;
+                std::size_t start = n - m < pos ? n - m : pos;
+                if (m == 0) return start;
+                for (std::size_t i = start + 1; i > 0;) {
+                    i = rfind(h, n, x[0], i - 1);
+                    if (i == npos) return npos;
+                    if (Traits::compare(h + i + 1, x + 1, m - 1) == 0) return i;
+                }
+                return npos;
+            }
+
+            // first position at or after pos whose membership in the set equals `member`
+            static std::size_t find_first_of(const char_type* h, std::size_t n, const char_type* set, std::size_t k, std::size_t pos, bool member) noexcept {
+                if (pos >= n) return npos;
+                if (member && k == 1) return find(h, n, set[0], pos);
+                char_set<Traits> cs(set, k);
+                for (std::size_t i = pos; i < n; ++i) {
+                    if (cs.contains(h[i]) == member) return i;
+                }
+                return npos;
+            }
+
+            // last position at or before pos whose membership in the set equals `member`
+            static std::size_t find_last_of(const char_type* h, std::size_t n, const char_type* set, std::size_t k, std::size_t pos, bool member) noexcept {
+                if (n == 0) return npos;
+                if (member && k == 1) return rfind(h, n, set[0], pos);
+                char_set<Traits> cs(set, k);
+                for (std::size_t i = pos < n ? pos + 1 : n; i > 0; --i) {
+                    if (cs.contains(h[i - 1]) == member) return i - 1;
+                }
+                return npos;
+            }
+
+        private:
+            static std::size_t _find_short(const char_type* h, std::size_t n, const char_type* x, std::size_t m, std::size_t pos) noexcept {
+                const char_type* last = h + (n - m);
+                for (const char_type* p = h + pos; p <= last; ++p) {
+                    p = Traits::find(p, static_cast<std::size_t>(last - p) + 1, x[0]);
+                    if (p == nullptr) return npos;
+                    if (Traits::compare(p + 1, x + 1, m - 1) == 0) return static_cast<std::size_t>(p - h);
+                }
+                return npos;
+            }
+
+            // maximal suffix of x under the character order (or its reverse), with its period
+            static std::ptrdiff_t _maximal_suffix(const char_type* x, std::ptrdiff_t m, std::ptrdiff_t& period, bool reversed) noexcept {
+                std::ptrdiff_t ms = -1;
+                std::ptrdiff_t j = 0;
+                std::ptrdiff_t k = 1;
+                period = 1;
+                while (j + k < m) {
+                    char_type a = x[j + k];
+                    char_type b = x[ms + k];
+                    if (reversed ? Traits::lt(b, a) : Traits::lt(a, b)) {
+                        j += k;
+                        k = 1;
+                        period = j - ms;
+                    } else if (Traits::eq(a, b)) {
+                        if (k != period) {
+                            ++k;
+                        } else {
+                            j += period;
+                            k = 1;
+                        }
+                    } else {
+                        ms = j;
+                        j = ms + 1;
+                        k = period = 1;
+                    }
+                }
+                return ms;
+            }
+
+            // advances j to the next window whose character at i matches x[i], using Traits::find (memchr for char)
+            static bool _skip_to_candidate(const char_type* x, std::ptrdiff_t m, const char_type* y, std::ptrdiff_t n, std::ptrdiff_t i, std::ptrdiff_t& j) noexcept {
+                if (Traits::eq(x[i], y[i + j])) return true;
+                const char_type* f = Traits::find(y + i + j, static_cast<std::size_t>(n - m - j + 1), x[i]);
+                if (f == nullptr) return false;
+                j = (f - y) - i;
+                return true;
+            }
+
+            // Crochemore-Perrin two-way matching: linear time, constant extra space
+            static std::size_t _two_way(const char_type* y, std::size_t size, const char_type* x, std::size_t needle) noexcept {
+                auto n = static_cast<std::ptrdiff_t>(size);
+                auto m = static_cast<std::ptrdiff_t>(needle);
+
+                std::ptrdiff_t p, q;
+                std::ptrdiff_t i = _maximal_suffix(x, m, p, false);
+                std::ptrdiff_t j = _maximal_suffix(x, m, q, true);
+                std::ptrdiff_t ell = i > j ? i : j;
+                std::ptrdiff_t per = i > j ? p : q;
+
+                if (Traits::compare(x, x + per, static_cast<std::size_t>(ell + 1)) == 0) {
+                    std::ptrdiff_t memory = -1;
+                    for (j = 0; j <= n - m;) {
+                        if (memory < 0 && !_skip_to_candidate(x, m, y, n, ell + 1, j)) return npos;
+                        i = (ell > memory ? ell : memory) + 1;
+                        while (i < m && Traits::eq(x[i], y[i + j])) ++i;
+                        if (i >= m) {
+                            i = ell;
+                            while (i > memory && Traits::eq(x[i], y[i + j])) --i;
+                            if (i <= memory) return static_cast<std::size_t>(j);
+                            j += per;
+                            memory = m - per - 1;
+                        } else {
+                            j += i - ell;
+                            memory = -1;
+                        }
+                    }
+                } else {
+                    per = (ell + 1 > m - ell - 1 ? ell + 1 : m - ell - 1) + 1;
+                    for (j = 0; j <= n - m;) {
+                        if (!_skip_to_candidate(x, m, y, n, ell + 1, j)) return npos;
+                        i = ell + 1;
+                        while (i < m && Traits::eq(x[i], y[i + j])) ++i;
+                        if (i >= m) {
+                            i = ell;
+                            while (i >= 0 && Traits::eq(x[i], y[i + j])) --i;
+                            if (i < 0) return static_cast<std::size_t>(j);
+                            j += per;
+                        } else {
+                            j += i - ell;
+                        }
+                    }
+                }
+                return npos;
+            }
+        };
+    } // namespace detail
+} // namespace cpp17
+
+#endif //LIBCPP17_STRING_SEARCH_HPP
@@ -0,0 +1,374 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_UNICODE_HPP
+#define LIBCPP17_UNICODE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// The SIMD validator is compiled in when the target has SSSE3, or on GCC and Clang for x86 behind a
+// run-time CPU check
+#if defined(__SSSE3__)
+#define CPP17_HAS_SSSE3 1
+#define CPP17_TARGET_SSSE3
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CPP17_HAS_SSSE3 1
+#define CPP17_DETECT_SSSE3 1
+#define CPP17_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+
+#if CPP17_HAS_SSSE3
+#include <tmmintrin.h>
+#endif
+
+#include "ascii.hpp"
+
+namespace cpp17 {
+    namespace detail {
+        namespace utf8 {
+            constexpr char32_t invalid = 0xFFFFFFFF;
+
+            // Shift DFA: the row of a byte packs the successor of every state in 6-bit fields, and a state is
+            // the bit offset of its field, so one transition is a load and a shift.
+            class dfa {
+            public:
+                static constexpr unsigned accept = 0;
+                static constexpr unsigned error = 6;
+
+            private:
+                static constexpr unsigned tail1 = 12;
+                static constexpr unsigned tail2 = 18;
+                static constexpr unsigned tail3 = 24;
+                static constexpr unsigned after_e0 = 30;
+                static constexpr unsigned after_ed = 36;
+                static constexpr unsigned after_f0 = 42;
+                static constexpr unsigned after_f4 = 48;
+
+                std::uint64_t _rows[256];
+
+            public:
+                dfa() noexcept {
+                    std::uint64_t all_error = 0;
+                    for (unsigned s = 0; s <= after_f4; s += 6) all_error |= std::uint64_t(error) << s;
+                    for (auto& row : _rows) row = all_error;
+
+                    _set(accept, 0x00, 0x7f, accept);
+                    _set(accept, 0xc2, 0xdf, tail1);
+                    _set(accept, 0xe0, 0xe0, after_e0);
+                    _set(accept, 0xe1, 0xec, tail2);
+                    _set(accept, 0xed, 0xed, after_ed);
+                    _set(accept, 0xee, 0xef, tail2);
+                    _set(accept, 0xf0, 0xf0, after_f0);
+                    _set(accept, 0xf1, 0xf3, tail3);
+                    _set(accept, 0xf4, 0xf4, after_f4);
+                    _set(tail1, 0x80, 0xbf, accept);
+                    _set(tail2, 0x80, 0xbf, tail1);
+                    _set(tail3, 0x80, 0xbf, tail2);
+                    // the second byte excludes overlong forms, surrogates and code points above U+10FFFF
+                    _set(after_e0, 0xa0, 0xbf, tail1);
+                    _set(after_ed, 0x80, 0x9f, tail1);
+                    _set(after_f0, 0x90, 0xbf, tail2);
+                    _set(after_f4, 0x80, 0x8f, tail2);
+                }
+
+                // only the low six bits of the result are the new state
+                std::uint64_t next(std::uint64_t state, unsigned char byte) const noexcept {
+                    return _rows[byte] >> (state & 63);
+                }
+
+            private:
+                void _set(unsigned from, unsigned first, unsigned last, unsigned to) noexcept {
+                    for (unsigned b = first; b <= last; ++b) {
+                        _rows[b] = (_rows[b] & ~(std::uint64_t(63) << from)) | (std::uint64_t(to) << from);
+                    }
+                }
+            };
+
+            inline const dfa& dfa_table() noexcept {
+                static const dfa table;
+                return table;
+            }
+
+            inline bool validate_scalar(const char* p, std::size_t n) noexcept {
+                const dfa& table = dfa_table();
+                std::uint64_t state = dfa::accept;
+                std::size_t i = 0;
+                while (i < n) {
+                    if ((state & 63) == dfa::accept) {
+                        while (i + 16 <= n && ((ascii::load8(p + i) | ascii::load8(p + i + 8)) & ascii::high) == 0) i += 16;
+                    } else if ((state & 63) == dfa::error) {
+                        return false;
+                    }
+                    std::size_t stop = n - i < 16 ? n : i + 16;
+                    for (; i < stop; ++i) state = table.next(state, static_cast<unsigned char>(p[i]));
+                }
+                return (state & 63) == dfa::accept;
+            }
+
+#if CPP17_HAS_SSSE3
+            // Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte": three nibble lookups
+            // classify every pair of adjacent bytes, and the bytes two and three back say where continuations
+            // are required.
+            class lookup_validator {
+            private:
+                __m128i _error;
+                __m128i _previous;
+                __m128i _incomplete;
+
+            public:
+                CPP17_TARGET_SSSE3 lookup_validator() noexcept
+                        : _error(_mm_setzero_si128()), _previous(_mm_setzero_si128()), _incomplete(_mm_setzero_si128()) {
+                }
+
+                // an all-ASCII block is only wrong if the previous one ended mid-sequence
+                CPP17_TARGET_SSSE3 void check_ascii() noexcept {
+                    _error = _mm_or_si128(_error, _incomplete);
+                }
+
+                CPP17_TARGET_SSSE3 void check(__m128i input) noexcept {
+                    const char too_short = 1 << 0;      // a lead followed by a lead or ASCII
+                    const char too_long = 1 << 1;       // ASCII followed by a continuation
+                    const char overlong_3 = 1 << 2;     // e0 80..9f
+                    const char too_large = 1 << 3;      // f4 90..bf and larger leads
+                    const char surrogate = 1 << 4;      // ed a0..bf
+                    const char overlong_2 = 1 << 5;     // c0..c1 leads
+                    const char too_large_1000 = 1 << 6; // f5.. 80..8f
+                    const char overlong_4 = 1 << 6;     // f0 80..8f
+                    const char two_conts = static_cast<char>(1 << 7); // a continuation after a continuation
+                    const char carry = too_short | too_long | two_conts;
+                    const __m128i low_nibble = _mm_set1_epi8(0x0f);
+
+                    __m128i prev1 = _mm_alignr_epi8(input, _previous, 15);
+                    __m128i byte_1_high = _mm_shuffle_epi8(
+                            _mm_setr_epi8(too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+                                          two_conts, two_conts, two_conts, two_conts,
+                                          too_short | overlong_2, too_short, too_short | overlong_3 | surrogate,
+                                          too_short | too_large | too_large_1000 | overlong_4),
+                            _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+                    const char large = carry | too_large | too_large_1000;
+                    __m128i byte_1_low = _mm_shuffle_epi8(
+                            _mm_setr_epi8(carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry,
+                                          carry | too_large, large, large, large,
+                                          large, large, large, large, large, large | surrogate, large, large),
+                            _mm_and_si128(prev1, low_nibble));
+                    const char continuation = too_long | overlong_2 | two_conts;
+                    __m128i byte_2_high = _mm_shuffle_epi8(
+                            _mm_setr_epi8(too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+                                          continuation | overlong_3 | too_large_1000 | overlong_4, continuation | overlong_3 | too_large,
+                                          continuation | surrogate | too_large, continuation | surrogate | too_large,
+                                          too_short, too_short, too_short, too_short),
+                            _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+                    __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+                    // third and fourth bytes of a sequence are the only continuations allowed after a continuation
+                    __m128i prev2 = _mm_alignr_epi8(input, _previous, 14);
+                    __m128i prev3 = _mm_alignr_epi8(input, _previous, 13);
+                    __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+                    __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+                    __m128i required = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(two_conts));
+                    _error = _mm_or_si128(_error, _mm_xor_si128(required, special));
+
+                    // a lead in the last three bytes that needs more bytes than the block has left
+                    _incomplete = _mm_subs_epu8(input, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                                     static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1)));
+                    _previous = input;
+                }
+
+                CPP17_TARGET_SSSE3 bool valid() const noexcept {
+                    __m128i error = _mm_or_si128(_error, _incomplete);
+                    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xffff;
+                }
+            };
+
+            CPP17_TARGET_SSSE3 inline bool validate_simd(const char* p, std::size_t n) noexcept {
+                lookup_validator v;
+                std::size_t i = 0;
+                // testing for ASCII per 64 bytes rather than per block keeps mixed text from mispredicting
+                for (; i + 64 <= n; i += 64) {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 16));
+                    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 32));
+                    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 48));
+                    if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) == 0) {
+                        v.check_ascii();
+                    } else {
+                        v.check(a);
+                        v.check(b);
+                        v.check(c);
+                        v.check(d);
+                    }
+                }
+                for (; i + 16 <= n; i += 16) {
+                    v.check(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+                }
+                if (i < n) {
+                    // zero padding reads as ASCII
+                    char tail[16] = {};
+                    std::memcpy(tail, p + i, n - i);
+                    v.check(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tail)));
+                }
+                return v.valid();
+            }
+#endif
+
+            inline bool validate(const char* p, std::size_t n) noexcept {
+#if CPP17_DETECT_SSSE3
+                static const bool ssse3 = (__builtin_cpu_init(), __builtin_cpu_supports("ssse3"));
+                return ssse3 ? validate_simd(p, n) : validate_scalar(p, n);
+#elif CPP17_HAS_SSSE3
+                return validate_simd(p, n);
+#else
+                return validate_scalar(p, n);
+#endif
+            }
+
+            // decodes one code point from n > 0 bytes and returns the bytes used; an ill-formed sequence
+            // yields `invalid` and consumes its maximal valid prefix (at least one byte), as Unicode recommends
+            inline std::size_t decode(const char* s, std::size_t n, char32_t& cp) noexcept {
+                auto p = reinterpret_cast<const unsigned char*>(s);
+                unsigned b = p[0];
+                if (b < 0x80) {
+                    cp = b;
+                    return 1;
+                }
+                std::size_t length;
+                unsigned low = 0x80, high = 0xbf;
+                char32_t c;
+                if (b < 0xc2) {
+                    cp = invalid;
+                    return 1;
+                } else if (b < 0xe0) {
+                    length = 2;
+                    c = b & 0x1f;
+                } else if (b < 0xf0) {
+                    length = 3;
+                    c = b & 0x0f;
+                    if (b == 0xe0) low = 0xa0;
+                    if (b == 0xed) high = 0x9f;
+                } else if (b < 0xf5) {
+                    length = 4;
+                    c = b & 0x07;
+                    if (b == 0xf0) low = 0x90;
+                    if (b == 0xf4) high = 0x8f;
+                } else {
+                    cp = invalid;
+                    return 1;
+                }
+                for (std::size_t i = 1; i < length; ++i) {
+                    if (i == n || p[i] < low || p[i] > high) {
+                        cp = invalid;
+                        return i;
+                    }
+                    c = (c << 6) | (p[i] & 0x3f);
+                    low = 0x80;
+                    high = 0xbf;
+                }
+                cp = c;
+                return length;
+            }
+
+            inline char* encode(char32_t cp, char* out) noexcept {
+                if (cp < 0x80) {
+                    *out++ = static_cast<char>(cp);
+                } else if (cp < 0x800) {
+                    *out++ = static_cast<char>(0xc0 | (cp >> 6));
+                    *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+                } else if (cp < 0x10000) {
+                    *out++ = static_cast<char>(0xe0 | (cp >> 12));
+                    *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+                    *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+                } else {
+                    *out++ = static_cast<char>(0xf0 | (cp >> 18));
+                    *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+                    *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+                    *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+                }
+                return out;
+            }
+
+            // UTF-8 to UTF-16 or UTF-32, widening runs of ASCII sixteen bytes at a time. Returns where decoding
+            // stopped: `end`, or the first ill-formed sequence.
+            template <class Out>
+            const char* decode_to(const char* p, const char* end, Out*& out) noexcept {
+                Out* o = out;
+                while (p != end) {
+                    // a local copy, since stores through `o` could otherwise alias the char input
+                    unsigned char block[16];
+                    while (end - p >= 16) {
+                        std::memcpy(block, p, 16);
+                        std::uint64_t a, b;
+                        std::memcpy(&a, block, 8);
+                        std::memcpy(&b, block + 8, 8);
+                        if (((a | b) & ascii::high) != 0) break;
+                        for (int i = 0; i < 16; ++i) o[i] = block[i];
+                        p += 16;
+                        o += 16;
+                    }
+                    while (p != end && static_cast<unsigned char>(*p) < 0x80) *o++ = static_cast<unsigned char>(*p++);
+                    if (p == end) break;
+                    char32_t cp;
+                    std::size_t n = decode(p, static_cast<std::size_t>(end - p), cp);
+                    if (cp == invalid) break;
+                    p += n;
+                    if (sizeof(Out) == 2 && cp >= 0x10000) {
+                        cp -= 0x10000;
+                        *o++ = static_cast<Out>(0xd800 + (cp >> 10));
+                        *o++ = static_cast<Out>(0xdc00 + (cp & 0x3ff));
+                    } else {
+                        *o++ = static_cast<Out>(cp);
+                    }
+                }
+                out = o;
+                return p;
+            }
+
+            // sum of the eight bytes of v, each at most 255
+            inline std::size_t byte_sum(std::uint64_t v) noexcept {
+                v = (v & 0x00ff00ff00ff00ffull) + ((v >> 8) & 0x00ff00ff00ff00ffull);
+                return static_cast<std::size_t>((v * 0x0001000100010001ull) >> 48);
+            }
+
+            // continuation bytes (10xxxxxx) and four-byte leads (11110xxx and above) in [p, p + n)
+            inline void count_bytes(const char* p, std::size_t n, std::size_t& continuations, std::size_t& four_byte_leads) noexcept {
+                std::size_t c = 0, f = 0, i = 0;
+                while (n - i >= 8) {
+                    // one counter per byte lane, folded before any lane can overflow
+                    std::uint64_t lanes_c = 0, lanes_f = 0;
+                    std::size_t stop = n - i >= 8 * 255 ? i + 8 * 255 : n - 7;
+                    for (; i < stop; i += 8) {
+                        std::uint64_t x = ascii::load8(p + i);
+                        lanes_c += (x & ~(x << 1) & ascii::high) >> 7;
+                        lanes_f += (x & (x << 1) & (x << 2) & (x << 3) & ascii::high) >> 7;
+                    }
+                    c += byte_sum(lanes_c);
+                    f += byte_sum(lanes_f);
+                }
+                for (; i < n; ++i) {
+                    auto b = static_cast<unsigned char>(p[i]);
+                    c += (b & 0xc0) == 0x80;
+                    f += b >= 0xf0;
+                }
+                continuations = c;
+                four_byte_leads = f;
+            }
+        } // namespace utf8
+    }     // namespace detail
+} // namespace cpp17
+
+#endif //LIBCPP17_UNICODE_HPP
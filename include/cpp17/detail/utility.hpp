@@ -6,8 +6,49 @@
 #define LIBCPP17_UTILITY_HPP
 
 #include <cstddef>
+#include <type_traits>
 
 namespace cpp17 {
+    namespace detail {
+        template <std::size_t... I>
+        struct index_sequence {
+            static constexpr std::size_t size() noexcept {
+                return sizeof...(I);
+            }
+        };
+
+        template <class L, class R>
+        struct concat_index_sequence;
+        template <std::size_t... L, std::size_t... R>
+        struct concat_index_sequence<index_sequence<L...>, index_sequence<R...>> {
+            using type = index_sequence<L..., (sizeof...(L) + R)...>;
+        };
+
+        template <std::size_t N>
+        struct make_index_sequence_impl
+                : concat_index_sequence<typename make_index_sequence_impl<N / 2>::type,
+                                        typename make_index_sequence_impl<N - N / 2>::type> {
+        };
+        template <>
+        struct make_index_sequence_impl<0> {
+            using type = index_sequence<>;
+        };
+        template <>
+        struct make_index_sequence_impl<1> {
+            using type = index_sequence<0>;
+        };
+
+        template <std::size_t N>
+        using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
+        template <bool... B>
+        struct bool_pack {
+        };
+        template <bool... B>
+        struct all_of : std::is_same<bool_pack<true, B...>, bool_pack<B..., true>> {
+        };
+    } // namespace detail
+
     template <class T>
     std::size_t size(const T& t) {
         return t.size();
@@ -17,6 +58,10 @@ namespace cpp17 {
         return N;
     }
 
+    template <class T>
+    auto data(T& t) -> decltype(t.data()) {
+        return t.data();
+    }
     template <class T>
     auto data(const T& t) -> decltype(t.data()) {
         return t.data();
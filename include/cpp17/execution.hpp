@@ -0,0 +1,144 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_EXECUTION_HPP
+#define LIBCPP17_EXECUTION_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "thread_pool.hpp"
+
+namespace cpp17 {
+    namespace execution {
+        class sequenced_policy {
+        public:
+            constexpr sequenced_policy() noexcept {
+            }
+        };
+
+        // grain is the number of elements one task handles (0 picks one from the input size);
+        // the unsequenced flavour runs the same code, whose inner loops are plain enough to vectorize
+        template <bool Unsequenced>
+        class basic_parallel_policy {
+        private:
+            std::size_t _grain;
+            thread_pool* _pool;
+
+        public:
+            constexpr basic_parallel_policy() noexcept
+                    : _grain(0), _pool(nullptr) {
+            }
+            constexpr basic_parallel_policy(std::size_t grain, thread_pool* pool) noexcept
+                    : _grain(grain), _pool(pool) {
+            }
+
+        public:
+            constexpr basic_parallel_policy with_grain(std::size_t grain) const noexcept {
+                return basic_parallel_policy(grain, _pool);
+            }
+            constexpr basic_parallel_policy on(thread_pool& pool) const noexcept {
+                return basic_parallel_policy(_grain, &pool);
+            }
+
+            constexpr std::size_t grain() const noexcept {
+                return _grain;
+            }
+            thread_pool& pool() const {
+                return _pool != nullptr ? *_pool : thread_pool::default_pool();
+            }
+        };
+
+        using parallel_policy = basic_parallel_policy<false>;
+        using parallel_unsequenced_policy = basic_parallel_policy<true>;
+
+        constexpr sequenced_policy seq{};
+        constexpr parallel_policy par{};
+        constexpr parallel_unsequenced_policy par_unseq{};
+    } // namespace execution
+
+    template <class T>
+    struct is_execution_policy : std::false_type {
+    };
+    template <>
+    struct is_execution_policy<execution::sequenced_policy> : std::true_type {
+    };
+    template <bool Unsequenced>
+    struct is_execution_policy<execution::basic_parallel_policy<Unsequenced>> : std::true_type {
+    };
+
+    namespace detail {
+        template <class Policy, class R>
+        using enable_if_execution_policy = typename std::enable_if<is_execution_policy<typename std::decay<Policy>::type>::value, R>::type;
+
+        // Elements [0, size) in chunks of grain; chunk boundaries depend only on the size and the grain,
+        // so reductions combine partial results in the same order whatever the number of threads.
+        struct chunking {
+            std::size_t size;
+            std::size_t grain;
+            std::size_t count;
+
+            std::size_t begin(std::size_t chunk) const noexcept {
+                return chunk * grain;
+            }
+            std::size_t end(std::size_t chunk) const noexcept {
+                return chunk + 1 == count ? size : (chunk + 1) * grain;
+            }
+        };
+
+        constexpr std::size_t min_grain = 2048;
+        // enough chunks per thread for stealing to even out uneven work
+        constexpr std::size_t chunks_per_thread = 8;
+
+        inline chunking make_chunking(const execution::sequenced_policy&, std::size_t size) noexcept {
+            return chunking{size, size, size != 0 ? 1u : 0u};
+        }
+        template <bool Unsequenced>
+        chunking make_chunking(const execution::basic_parallel_policy<Unsequenced>& policy, std::size_t size) {
+            std::size_t grain = policy.grain();
+            if (grain == 0) {
+                grain = size / (policy.pool().concurrency() * chunks_per_thread);
+                if (grain < min_grain) grain = min_grain;
+            }
+            // rounds up without size + grain - 1, which overflows for very large grains
+            return chunking{size, grain, size / grain + (size % grain != 0)};
+        }
+
+        // f(begin, end) over subranges of [0, count)
+        template <class F>
+        void parallel_for(const execution::sequenced_policy&, std::size_t count, F&& f) {
+            if (count != 0) f(std::size_t(0), count);
+        }
+        template <bool Unsequenced, class F>
+        void parallel_for(const execution::basic_parallel_policy<Unsequenced>& policy, std::size_t count, F&& f) {
+            policy.pool().parallel_for(count, std::forward<F>(f));
+        }
+
+        // f(chunk, begin, end) for every chunk
+        template <class Policy, class F>
+        void for_each_chunk(const Policy& policy, const chunking& chunks, F&& f) {
+            detail::parallel_for(policy, chunks.count, [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c < last; ++c) {
+                    f(c, chunks.begin(c), chunks.end(c));
+                }
+            });
+        }
+    } // namespace detail
+} // namespace cpp17
+
+#endif //LIBCPP17_EXECUTION_HPP
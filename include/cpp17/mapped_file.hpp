@@ -0,0 +1,390 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_MAPPED_FILE_HPP
+#define LIBCPP17_MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CPP17_HAS_MMAP 1
+#endif
+
+#include "span.hpp"
+#include "string_view.hpp"
+
+namespace cpp17 {
+    enum class access_advice {
+        normal,
+        sequential, // read ahead aggressively, drop pages soon after use
+        random,     // no read-ahead
+        willneed,   // start reading the range in now
+        dontneed,   // the range will not be used again soon
+    };
+
+    struct mapping_options {
+        access_advice advice = access_advice::normal;
+        // back the mapping with transparent huge pages where the kernel and file system allow it
+        bool huge_pages = false;
+        // fault every page in while mapping instead of on first touch
+        bool populate = false;
+    };
+
+    // Read-only view of a file, or of a window of it, through mmap. The mapping is private and lives
+    // until the object is closed, remapped or destroyed. Without mmap the window is read into memory.
+    class mapped_file {
+    public:
+        static constexpr std::size_t whole_file = static_cast<std::size_t>(-1);
+
+    private:
+#if CPP17_HAS_MMAP
+        int _fd;
+        void* _map;
+        std::size_t _map_length;
+#else
+        std::FILE* _file;
+        std::unique_ptr<char[]> _buffer;
+#endif
+        std::uint64_t _file_size;
+        std::uint64_t _offset;
+        const char* _data;
+        std::size_t _size;
+        mapping_options _options;
+
+    public:
+        mapped_file() noexcept
+                :
+#if CPP17_HAS_MMAP
+                  _fd(-1), _map(nullptr), _map_length(0),
+#else
+                  _file(nullptr),
+#endif
+                  _file_size(0), _offset(0), _data(""), _size(0) {
+        }
+        // maps [offset, offset + length) of the file, clipped to its end
+        explicit mapped_file(const std::string& path, std::uint64_t offset = 0, std::size_t length = whole_file, const mapping_options& options = mapping_options())
+                : mapped_file() {
+            open(path, offset, length, options);
+        }
+        mapped_file(const std::string& path, const mapping_options& options)
+                : mapped_file(path, 0, whole_file, options) {
+        }
+
+        mapped_file(mapped_file&& rhs) noexcept
+                : mapped_file() {
+            swap(rhs);
+        }
+        mapped_file& operator=(mapped_file&& rhs) noexcept {
+            mapped_file(std::move(rhs)).swap(*this);
+            return *this;
+        }
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        ~mapped_file() {
+            close();
+        }
+
+    public:
+        void open(const std::string& path, std::uint64_t offset = 0, std::size_t length = whole_file, const mapping_options& options = mapping_options()) {
+            close();
+#if CPP17_HAS_MMAP
+            int flags = O_RDONLY;
+#ifdef O_CLOEXEC
+            flags |= O_CLOEXEC;
+#endif
+            _fd = ::open(path.c_str(), flags);
+            if (_fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "mapped_file: cannot open " + path);
+            }
+            struct stat st;
+            if (::fstat(_fd, &st) != 0) {
+                int error = errno;
+                close();
+                throw std::system_error(error, std::generic_category(), "mapped_file: cannot stat " + path);
+            }
+            _file_size = static_cast<std::uint64_t>(st.st_size);
+#else
+            _file = std::fopen(path.c_str(), "rb");
+            if (_file == nullptr) {
+                throw std::system_error(errno, std::generic_category(), "mapped_file: cannot open " + path);
+            }
+            if (!_seek(0, SEEK_END)) {
+                close();
+                throw std::system_error(errno, std::generic_category(), "mapped_file: cannot size " + path);
+            }
+            _file_size = _tell();
+#endif
+            _options = options;
+            try {
+                remap(offset, length);
+            } catch (...) {
+                close();
+                throw;
+            }
+        }
+
+        void close() noexcept {
+            _unmap();
+#if CPP17_HAS_MMAP
+            if (_fd >= 0) ::close(_fd);
+            _fd = -1;
+#else
+            if (_file != nullptr) std::fclose(_file);
+            _file = nullptr;
+#endif
+            _file_size = 0;
+        }
+
+        bool is_open() const noexcept {
+#if CPP17_HAS_MMAP
+            return _fd >= 0;
+#else
+            return _file != nullptr;
+#endif
+        }
+
+        // replaces the current window, e.g. to walk a file larger than the address space budget
+        void remap(std::uint64_t offset, std::size_t length = whole_file) {
+            if (!is_open()) {
+                throw std::logic_error("mapped_file: remap of a closed file");
+            }
+            if (offset > _file_size) {
+                throw std::out_of_range("mapped_file: offset past the end of the file");
+            }
+            _unmap();
+            if (length > _file_size - offset) {
+                length = static_cast<std::size_t>(_file_size - offset);
+            }
+            _offset = offset;
+            if (length == 0) return;
+
+#if CPP17_HAS_MMAP
+            std::uint64_t start = offset - offset % page_size();
+            std::size_t delta = static_cast<std::size_t>(offset - start);
+            std::size_t map_length = delta + length;
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            if (_options.populate) flags |= MAP_POPULATE;
+#endif
+            void* hint = _options.huge_pages ? _huge_page_hint(start, map_length) : nullptr;
+            if (hint != nullptr) flags |= MAP_FIXED;
+            void* p = ::mmap(hint, map_length, PROT_READ, flags, _fd, static_cast<off_t>(start));
+            if (p == MAP_FAILED) {
+                int error = errno;
+                if (hint != nullptr) ::munmap(hint, map_length);
+                throw std::system_error(error, std::generic_category(), "mapped_file: mmap failed");
+            }
+            _map = p;
+            _map_length = map_length;
+            _data = static_cast<const char*>(p) + delta;
+            _size = length;
+#ifdef MADV_HUGEPAGE
+            if (_options.huge_pages) ::madvise(_map, _map_length, MADV_HUGEPAGE);
+#endif
+            if (_options.advice != access_advice::normal) advise(_options.advice);
+#else
+            std::unique_ptr<char[]> buffer(new char[length]);
+            if (!_seek(offset, SEEK_SET) || std::fread(buffer.get(), 1, length, _file) != length) {
+                throw std::system_error(errno, std::generic_category(), "mapped_file: read failed");
+            }
+            _buffer = std::move(buffer);
+            _data = _buffer.get();
+            _size = length;
+#endif
+        }
+
+        // hint how [offset, offset + length) of the window will be read; errors are ignored
+        void advise(access_advice advice, std::size_t offset = 0, std::size_t length = whole_file) const noexcept {
+#if CPP17_HAS_MMAP
+            if (_map == nullptr || offset >= _size) return;
+            if (length > _size - offset) length = _size - offset;
+            auto first = reinterpret_cast<std::uintptr_t>(_data + offset);
+            auto aligned = first - first % page_size();
+            ::madvise(reinterpret_cast<void*>(aligned), static_cast<std::size_t>(first - aligned) + length, _advice_flag(advice));
+#else
+            (void)advice;
+            (void)offset;
+            (void)length;
+#endif
+        }
+
+    public:
+        const char* data() const noexcept {
+            return _data;
+        }
+        std::size_t size() const noexcept {
+            return _size;
+        }
+        bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        span<const char> bytes() const noexcept {
+            return span<const char>(_data, _size);
+        }
+        span<const byte> byte_span() const noexcept {
+            return as_bytes(bytes());
+        }
+        string_view view() const noexcept {
+            return string_view(_data, _size);
+        }
+        operator string_view() const noexcept {
+            return view();
+        }
+
+        // position of data() in the file
+        std::uint64_t offset() const noexcept {
+            return _offset;
+        }
+        std::uint64_t file_size() const noexcept {
+            return _file_size;
+        }
+
+        static std::size_t page_size() noexcept {
+#if CPP17_HAS_MMAP
+            static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            return size;
+#else
+            return 4096;
+#endif
+        }
+
+    public:
+        void swap(mapped_file& rhs) noexcept {
+            using std::swap;
+#if CPP17_HAS_MMAP
+            swap(_fd, rhs._fd);
+            swap(_map, rhs._map);
+            swap(_map_length, rhs._map_length);
+#else
+            swap(_file, rhs._file);
+            swap(_buffer, rhs._buffer);
+#endif
+            swap(_file_size, rhs._file_size);
+            swap(_offset, rhs._offset);
+            swap(_data, rhs._data);
+            swap(_size, rhs._size);
+            swap(_options, rhs._options);
+        }
+
+    private:
+        void _unmap() noexcept {
+#if CPP17_HAS_MMAP
+            if (_map != nullptr) ::munmap(_map, _map_length);
+            _map = nullptr;
+            _map_length = 0;
+#else
+            _buffer.reset();
+#endif
+            _data = "";
+            _size = 0;
+            _offset = 0;
+        }
+
+#if CPP17_HAS_MMAP
+        static int _advice_flag(access_advice advice) noexcept {
+            switch (advice) {
+            case access_advice::sequential:
+                return MADV_SEQUENTIAL;
+            case access_advice::random:
+                return MADV_RANDOM;
+            case access_advice::willneed:
+                return MADV_WILLNEED;
+            case access_advice::dontneed:
+                return MADV_DONTNEED;
+            default:
+                return MADV_NORMAL;
+            }
+        }
+
+        // Huge pages can only back a file mapping whose address is congruent to its file offset modulo
+        // the huge page size, so reserve address space and pick such an address inside it. The slack
+        // is released again; the returned range stays reserved for a MAP_FIXED mapping.
+        static void* _huge_page_hint(std::uint64_t file_offset, std::size_t length) noexcept {
+            const std::size_t huge = std::size_t(2) << 20;
+            if (length < huge) return nullptr;
+            void* p = ::mmap(nullptr, length + huge, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) return nullptr;
+            auto base = reinterpret_cast<std::uintptr_t>(p);
+            std::uintptr_t want = static_cast<std::uintptr_t>(file_offset % huge);
+            std::uintptr_t address = base + ((want - base % huge) & (huge - 1));
+            if (address > base) ::munmap(p, address - base);
+            std::uintptr_t end = base + length + huge;
+            if (end > address + length) ::munmap(reinterpret_cast<void*>(address + length), end - (address + length));
+            return reinterpret_cast<void*>(address);
+        }
+#else
+        bool _seek(std::uint64_t offset, int origin) noexcept {
+#if defined(_WIN32)
+            return ::_fseeki64(_file, static_cast<long long>(offset), origin) == 0;
+#else
+            return std::fseek(_file, static_cast<long>(offset), origin) == 0;
+#endif
+        }
+        std::uint64_t _tell() noexcept {
+#if defined(_WIN32)
+            return static_cast<std::uint64_t>(::_ftelli64(_file));
+#else
+            return static_cast<std::uint64_t>(std::ftell(_file));
+#endif
+        }
+#endif
+    };
+
+    inline void swap(mapped_file& lhs, mapped_file& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    // Walks the file in windows of at most window_size bytes, calling f(string_view) on each. Every
+    // window but the last ends just after its last delimiter, so records terminated by the delimiter
+    // are never split; a record longer than a whole window is passed in pieces.
+    template <class F>
+    void for_each_window(const std::string& path, std::size_t window_size, char delimiter, F&& f, const mapping_options& options = mapping_options()) {
+        if (window_size == 0) {
+            throw std::invalid_argument("for_each_window: window_size must be positive");
+        }
+        mapped_file file(path, 0, window_size, options);
+        for (;;) {
+            string_view window = file.view();
+            std::uint64_t end = file.offset() + window.size();
+            if (end < file.file_size()) {
+                std::size_t cut = window.rfind(delimiter);
+                if (cut != string_view::npos) window = window.substr(0, cut + 1);
+            }
+            if (!window.empty()) f(window);
+            std::uint64_t next = file.offset() + window.size();
+            if (next >= file.file_size()) break;
+            file.remap(next, window_size);
+        }
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_MAPPED_FILE_HPP
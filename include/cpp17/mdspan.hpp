@@ -0,0 +1,782 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_MDSPAN_HPP
+#define LIBCPP17_MDSPAN_HPP
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "detail/dynamic_extent.hpp"
+#include "detail/only.hpp"
+#include "detail/utility.hpp"
+
+namespace cpp17 {
+    namespace detail {
+        template <std::size_t... V>
+        struct size_list {
+        };
+
+        template <std::size_t... Extents>
+        struct extent_table {
+            static constexpr std::size_t values[sizeof...(Extents) + 1] = {Extents..., 0};
+        };
+        template <std::size_t... Extents>
+        constexpr std::size_t extent_table<Extents...>::values[sizeof...(Extents) + 1];
+
+        constexpr std::size_t count_dynamic_before(const std::size_t* values, std::size_t r) noexcept {
+            return r == 0 ? 0 : count_dynamic_before(values, r - 1) + (values[r - 1] == dynamic_extent ? 1 : 0);
+        }
+
+        // position of each dynamic extent among the stored ones
+        template <class Sequence, std::size_t... Extents>
+        struct dynamic_index_table;
+        template <std::size_t... I, std::size_t... Extents>
+        struct dynamic_index_table<index_sequence<I...>, Extents...> {
+            static constexpr std::size_t values[sizeof...(I) + 1] = {count_dynamic_before(extent_table<Extents...>::values, I)..., 0};
+        };
+        template <std::size_t... I, std::size_t... Extents>
+        constexpr std::size_t dynamic_index_table<index_sequence<I...>, Extents...>::values[sizeof...(I) + 1];
+
+        // fully static extents take no space
+        template <class IndexType, std::size_t N>
+        struct dynamic_extents_storage {
+            IndexType values[N];
+
+            constexpr IndexType operator[](std::size_t i) const noexcept {
+                return values[i];
+            }
+            void set(std::size_t i, IndexType v) noexcept {
+                values[i] = v;
+            }
+        };
+        template <class IndexType>
+        struct dynamic_extents_storage<IndexType, 0> {
+            constexpr IndexType operator[](std::size_t) const noexcept {
+                return 0;
+            }
+            void set(std::size_t, IndexType) noexcept {
+            }
+        };
+
+        template <class IndexType, class... Sizes>
+        using are_index_convertible = all_of<std::is_convertible<Sizes, IndexType>::value...>;
+    } // namespace detail
+
+    namespace detail {
+        template <class IndexType, std::size_t... Extents>
+        using extents_base = dynamic_extents_storage<IndexType, count_dynamic_before(extent_table<Extents...>::values, sizeof...(Extents))>;
+    } // namespace detail
+
+    // fully static extents are an empty class
+    template <class IndexType, std::size_t... Extents>
+    class extents : private detail::extents_base<IndexType, Extents...> {
+        static_assert(std::is_integral<IndexType>::value, "extents: IndexType must be an integer type");
+
+        template <class, std::size_t...>
+        friend class extents;
+
+    public:
+        using index_type = IndexType;
+        using size_type = typename std::make_unsigned<IndexType>::type;
+        using rank_type = std::size_t;
+
+    private:
+        using _static_table = detail::extent_table<Extents...>;
+        using _dynamic_table = detail::dynamic_index_table<detail::make_index_sequence<sizeof...(Extents)>, Extents...>;
+        using _dynamic_storage = detail::extents_base<IndexType, Extents...>;
+        static constexpr rank_type _rank_dynamic = detail::count_dynamic_before(_static_table::values, sizeof...(Extents));
+
+    public:
+        static constexpr rank_type rank() noexcept {
+            return sizeof...(Extents);
+        }
+        static constexpr rank_type rank_dynamic() noexcept {
+            return _rank_dynamic;
+        }
+        static constexpr std::size_t static_extent(rank_type r) noexcept {
+            return _static_table::values[r];
+        }
+        // folds to a constant for a static extent once r is known
+        constexpr index_type extent(rank_type r) const noexcept {
+            return _static_table::values[r] == dynamic_extent ? _dynamic_storage::operator[](_dynamic_table::values[r]) : static_cast<index_type>(_static_table::values[r]);
+        }
+
+    public:
+        constexpr extents() noexcept
+                : _dynamic_storage() {
+        }
+        // the dynamic extents only
+        template <class... Sizes, typename std::enable_if<sizeof...(Sizes) == _rank_dynamic && sizeof...(Sizes) != 0 && detail::are_index_convertible<IndexType, Sizes...>::value, int>::type = 0>
+        explicit constexpr extents(Sizes... sizes) noexcept
+                : _dynamic_storage{{static_cast<index_type>(sizes)...}} {
+        }
+        // every extent; the static ones must match
+        template <class... Sizes, typename std::enable_if<sizeof...(Sizes) == sizeof...(Extents) && sizeof...(Sizes) != _rank_dynamic && detail::are_index_convertible<IndexType, Sizes...>::value, long>::type = 0>
+        explicit USE_OVER_CPP14(constexpr) extents(Sizes... sizes) noexcept
+                : _dynamic_storage() {
+            const index_type all[] = {static_cast<index_type>(sizes)...};
+            _assign(all, sizeof...(Sizes));
+        }
+        template <class OtherIndexType, std::size_t N, class = typename std::enable_if<N == _rank_dynamic || N == sizeof...(Extents)>::type>
+        explicit USE_OVER_CPP14(constexpr) extents(const std::array<OtherIndexType, N>& sizes) noexcept
+                : _dynamic_storage() {
+            index_type all[N + 1] = {};
+            for (std::size_t i = 0; i < N; ++i) all[i] = static_cast<index_type>(sizes[i]);
+            _assign(all, N);
+        }
+        template <class OtherIndexType, std::size_t... OtherExtents,
+                  class = typename std::enable_if<sizeof...(OtherExtents) == sizeof...(Extents) && detail::all_of<(OtherExtents == dynamic_extent || Extents == dynamic_extent || OtherExtents == Extents)...>::value>::type>
+        USE_OVER_CPP14(constexpr)
+        extents(const extents<OtherIndexType, OtherExtents...>& other) noexcept
+                : _dynamic_storage() {
+            for (rank_type r = 0; r < rank(); ++r) {
+                if (static_extent(r) == dynamic_extent) _dynamic_storage::set(_dynamic_table::values[r], static_cast<index_type>(other.extent(r)));
+            }
+        }
+
+    public:
+        template <class OtherIndexType, std::size_t... OtherExtents>
+        friend USE_OVER_CPP14(constexpr) bool operator==(const extents& lhs, const extents<OtherIndexType, OtherExtents...>& rhs) noexcept {
+            if (rank() != sizeof...(OtherExtents)) return false;
+            for (rank_type r = 0; r < rank(); ++r) {
+                if (static_cast<std::size_t>(lhs.extent(r)) != static_cast<std::size_t>(rhs.extent(r))) return false;
+            }
+            return true;
+        }
+        template <class OtherIndexType, std::size_t... OtherExtents>
+        friend USE_OVER_CPP14(constexpr) bool operator!=(const extents& lhs, const extents<OtherIndexType, OtherExtents...>& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+    private:
+        USE_OVER_CPP14(constexpr)
+        void _assign(const index_type* sizes, std::size_t n) noexcept {
+            for (rank_type r = 0; r < rank(); ++r) {
+                if (static_extent(r) != dynamic_extent) continue;
+                std::size_t d = _dynamic_table::values[r];
+                _dynamic_storage::set(d, n == rank() ? sizes[r] : sizes[d]);
+            }
+        }
+    };
+
+    template <class IndexType, std::size_t... Extents>
+    constexpr typename extents<IndexType, Extents...>::rank_type extents<IndexType, Extents...>::_rank_dynamic;
+
+    namespace detail {
+        template <class IndexType, std::size_t Rank, std::size_t... Extents>
+        struct make_dextents : make_dextents<IndexType, Rank - 1, dynamic_extent, Extents...> {
+        };
+        template <class IndexType, std::size_t... Extents>
+        struct make_dextents<IndexType, 0, Extents...> {
+            using type = extents<IndexType, Extents...>;
+        };
+    } // namespace detail
+
+    template <class IndexType, std::size_t Rank>
+    using dextents = typename detail::make_dextents<IndexType, Rank>::type;
+
+    // row-major: the last index is contiguous
+    struct layout_right {
+        template <class Extents>
+        class mapping;
+    };
+    // column-major: the first index is contiguous
+    struct layout_left {
+        template <class Extents>
+        class mapping;
+    };
+    // arbitrary non-negative strides, e.g. a submatrix or a transposed view
+    struct layout_stride {
+        template <class Extents>
+        class mapping;
+    };
+
+    namespace detail {
+        template <class Extents>
+        USE_OVER_CPP14(constexpr)
+        typename Extents::index_type extents_product(const Extents& e, std::size_t first, std::size_t last) noexcept {
+            typename Extents::index_type size = 1;
+            for (std::size_t r = first; r < last; ++r) size *= e.extent(r);
+            return size;
+        }
+    } // namespace detail
+
+    template <class Extents>
+    class layout_right::mapping {
+    public:
+        using extents_type = Extents;
+        using index_type = typename Extents::index_type;
+        using size_type = typename Extents::size_type;
+        using rank_type = typename Extents::rank_type;
+        using layout_type = layout_right;
+
+    private:
+        extents_type _extents;
+
+    public:
+        constexpr mapping() noexcept = default;
+        constexpr mapping(const extents_type& e) noexcept
+                : _extents(e) {
+        }
+        template <class OtherExtents, class = typename std::enable_if<std::is_constructible<extents_type, OtherExtents>::value>::type>
+        constexpr mapping(const mapping<OtherExtents>& other) noexcept
+                : _extents(other.extents()) {
+        }
+
+    public:
+        constexpr const extents_type& extents() const noexcept {
+            return _extents;
+        }
+        USE_OVER_CPP14(constexpr)
+        index_type required_span_size() const noexcept {
+            return detail::extents_product(_extents, 0, extents_type::rank());
+        }
+
+        template <class... Indices, class = typename std::enable_if<sizeof...(Indices) == Extents::rank() && detail::are_index_convertible<index_type, Indices...>::value>::type>
+        USE_OVER_CPP14(constexpr)
+        index_type operator()(Indices... indices) const noexcept {
+            const index_type i[] = {static_cast<index_type>(indices)..., 0};
+            index_type offset = 0;
+            for (rank_type r = 0; r < extents_type::rank(); ++r) offset = offset * _extents.extent(r) + i[r];
+            return offset;
+        }
+
+        USE_OVER_CPP14(constexpr)
+        index_type stride(rank_type r) const noexcept {
+            return detail::extents_product(_extents, r + 1, extents_type::rank());
+        }
+
+        static constexpr bool is_always_unique() noexcept {
+            return true;
+        }
+        static constexpr bool is_always_exhaustive() noexcept {
+            return true;
+        }
+        static constexpr bool is_always_strided() noexcept {
+            return true;
+        }
+        static constexpr bool is_unique() noexcept {
+            return true;
+        }
+        static constexpr bool is_exhaustive() noexcept {
+            return true;
+        }
+        static constexpr bool is_strided() noexcept {
+            return true;
+        }
+
+        friend USE_OVER_CPP14(constexpr) bool operator==(const mapping& lhs, const mapping& rhs) noexcept {
+            return lhs._extents == rhs._extents;
+        }
+        friend USE_OVER_CPP14(constexpr) bool operator!=(const mapping& lhs, const mapping& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+    };
+
+    template <class Extents>
+    class layout_left::mapping {
+    public:
+        using extents_type = Extents;
+        using index_type = typename Extents::index_type;
+        using size_type = typename Extents::size_type;
+        using rank_type = typename Extents::rank_type;
+        using layout_type = layout_left;
+
+    private:
+        extents_type _extents;
+
+    public:
+        constexpr mapping() noexcept = default;
+        constexpr mapping(const extents_type& e) noexcept
+                : _extents(e) {
+        }
+        template <class OtherExtents, class = typename std::enable_if<std::is_constructible<extents_type, OtherExtents>::value>::type>
+        constexpr mapping(const mapping<OtherExtents>& other) noexcept
+                : _extents(other.extents()) {
+        }
+
+    public:
+        constexpr const extents_type& extents() const noexcept {
+            return _extents;
+        }
+        USE_OVER_CPP14(constexpr)
+        index_type required_span_size() const noexcept {
+            return detail::extents_product(_extents, 0, extents_type::rank());
+        }
+
+        template <class... Indices, class = typename std::enable_if<sizeof...(Indices) == Extents::rank() && detail::are_index_convertible<index_type, Indices...>::value>::type>
+        USE_OVER_CPP14(constexpr)
+        index_type operator()(Indices... indices) const noexcept {
+            const index_type i[] = {static_cast<index_type>(indices)..., 0};
+            index_type offset = 0;
+            for (rank_type r = extents_type::rank(); r > 0; --r) offset = offset * _extents.extent(r - 1) + i[r - 1];
+            return offset;
+        }
+
+        USE_OVER_CPP14(constexpr)
+        index_type stride(rank_type r) const noexcept {
+            return detail::extents_product(_extents, 0, r);
+        }
+
+        static constexpr bool is_always_unique() noexcept {
+            return true;
+        }
+        static constexpr bool is_always_exhaustive() noexcept {
+            return true;
+        }
+        static constexpr bool is_always_strided() noexcept {
+            return true;
+        }
+        static constexpr bool is_unique() noexcept {
+            return true;
+        }
+        static constexpr bool is_exhaustive() noexcept {
+            return true;
+        }
+        static constexpr bool is_strided() noexcept {
+            return true;
+        }
+
+        friend USE_OVER_CPP14(constexpr) bool operator==(const mapping& lhs, const mapping& rhs) noexcept {
+            return lhs._extents == rhs._extents;
+        }
+        friend USE_OVER_CPP14(constexpr) bool operator!=(const mapping& lhs, const mapping& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+    };
+
+    template <class Extents>
+    class layout_stride::mapping {
+    public:
+        using extents_type = Extents;
+        using index_type = typename Extents::index_type;
+        using size_type = typename Extents::size_type;
+        using rank_type = typename Extents::rank_type;
+        using layout_type = layout_stride;
+
+    private:
+        extents_type _extents;
+        std::array<index_type, Extents::rank()> _strides;
+
+    public:
+        // layout_right strides
+        USE_OVER_CPP14(constexpr)
+        mapping() noexcept
+                : mapping(layout_right::mapping<extents_type>()) {
+        }
+        template <class OtherIndexType>
+        USE_OVER_CPP14(constexpr)
+        mapping(const extents_type& e, const std::array<OtherIndexType, Extents::rank()>& strides) noexcept
+                : _extents(e), _strides() {
+            for (rank_type r = 0; r < extents_type::rank(); ++r) _strides[r] = static_cast<index_type>(strides[r]);
+        }
+        // from any other strided mapping of the same shape, e.g. layout_right or layout_left
+        template <class Mapping, class = typename std::enable_if<std::is_constructible<extents_type, typename Mapping::extents_type>::value && Mapping::is_always_unique() && Mapping::is_always_strided()>::type>
+        USE_OVER_CPP14(constexpr)
+        mapping(const Mapping& other) noexcept
+                : _extents(other.extents()), _strides() {
+            for (rank_type r = 0; r < extents_type::rank(); ++r) _strides[r] = static_cast<index_type>(other.stride(r));
+        }
+
+    public:
+        constexpr const extents_type& extents() const noexcept {
+            return _extents;
+        }
+        constexpr std::array<index_type, Extents::rank()> strides() const noexcept {
+            return _strides;
+        }
+        USE_OVER_CPP14(constexpr)
+        index_type required_span_size() const noexcept {
+            index_type size = 1;
+            for (rank_type r = 0; r < extents_type::rank(); ++r) {
+                if (_extents.extent(r) == 0) return 0;
+                size += (_extents.extent(r) - 1) * _strides[r];
+            }
+            return size;
+        }
+
+        template <class... Indices, class = typename std::enable_if<sizeof...(Indices) == Extents::rank() && detail::are_index_convertible<index_type, Indices...>::value>::type>
+        USE_OVER_CPP14(constexpr)
+        index_type operator()(Indices... indices) const noexcept {
+            const index_type i[] = {static_cast<index_type>(indices)..., 0};
+            index_type offset = 0;
+            for (rank_type r = 0; r < extents_type::rank(); ++r) offset += i[r] * _strides[r];
+            return offset;
+        }
+
+        constexpr index_type stride(rank_type r) const noexcept {
+            return _strides[r];
+        }
+
+        static constexpr bool is_always_unique() noexcept {
+            return true;
+        }
+        static constexpr bool is_always_exhaustive() noexcept {
+            return false;
+        }
+        static constexpr bool is_always_strided() noexcept {
+            return true;
+        }
+        static constexpr bool is_unique() noexcept {
+            return true;
+        }
+        // no gaps: the elements exactly fill [0, required_span_size())
+        USE_OVER_CPP14(constexpr)
+        bool is_exhaustive() const noexcept {
+            return required_span_size() == detail::extents_product(_extents, 0, extents_type::rank());
+        }
+        static constexpr bool is_strided() noexcept {
+            return true;
+        }
+
+        friend USE_OVER_CPP14(constexpr) bool operator==(const mapping& lhs, const mapping& rhs) noexcept {
+            return lhs._extents == rhs._extents && lhs._strides == rhs._strides;
+        }
+        friend USE_OVER_CPP14(constexpr) bool operator!=(const mapping& lhs, const mapping& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+    };
+
+    template <class ElementType>
+    struct default_accessor {
+        using offset_policy = default_accessor;
+        using element_type = ElementType;
+        using reference = ElementType&;
+        using data_handle_type = ElementType*;
+
+        constexpr default_accessor() noexcept = default;
+        template <class OtherElementType, class = typename std::enable_if<std::is_convertible<OtherElementType (*)[], ElementType (*)[]>::value>::type>
+        constexpr default_accessor(default_accessor<OtherElementType>) noexcept {
+        }
+
+        constexpr reference access(data_handle_type p, std::size_t i) const noexcept {
+            return p[i];
+        }
+        constexpr data_handle_type offset(data_handle_type p, std::size_t i) const noexcept {
+            return p + i;
+        }
+    };
+
+    // Promises that the data handle is aligned to ByteAlignment, which lets the compiler use aligned
+    // vector loads. Offsetting loses the guarantee, so submdspan falls back to default_accessor.
+    template <class ElementType, std::size_t ByteAlignment>
+    struct aligned_accessor {
+        static_assert(ByteAlignment >= alignof(ElementType) && (ByteAlignment & (ByteAlignment - 1)) == 0, "aligned_accessor: ByteAlignment must be a power of two no smaller than alignof(ElementType)");
+
+        using offset_policy = default_accessor<ElementType>;
+        using element_type = ElementType;
+        using reference = ElementType&;
+        using data_handle_type = ElementType*;
+
+        static constexpr std::size_t byte_alignment = ByteAlignment;
+
+        constexpr aligned_accessor() noexcept = default;
+        template <class OtherElementType, std::size_t OtherByteAlignment, class = typename std::enable_if<std::is_convertible<OtherElementType (*)[], ElementType (*)[]>::value && OtherByteAlignment >= ByteAlignment>::type>
+        constexpr aligned_accessor(aligned_accessor<OtherElementType, OtherByteAlignment>) noexcept {
+        }
+
+        template <class OtherElementType, class = typename std::enable_if<std::is_convertible<ElementType (*)[], OtherElementType (*)[]>::value>::type>
+        constexpr operator default_accessor<OtherElementType>() const noexcept {
+            return default_accessor<OtherElementType>();
+        }
+
+        reference access(data_handle_type p, std::size_t i) const noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<data_handle_type>(__builtin_assume_aligned(p, ByteAlignment))[i];
+#else
+            return p[i];
+#endif
+        }
+        constexpr typename offset_policy::data_handle_type offset(data_handle_type p, std::size_t i) const noexcept {
+            return p + i;
+        }
+    };
+
+    template <class ElementType, class Extents, class LayoutPolicy = layout_right, class AccessorPolicy = default_accessor<ElementType>>
+    class mdspan {
+    public:
+        using extents_type = Extents;
+        using layout_type = LayoutPolicy;
+        using accessor_type = AccessorPolicy;
+        using mapping_type = typename LayoutPolicy::template mapping<Extents>;
+        using element_type = ElementType;
+        using value_type = typename std::remove_cv<ElementType>::type;
+        using index_type = typename Extents::index_type;
+        using size_type = typename Extents::size_type;
+        using rank_type = typename Extents::rank_type;
+        using data_handle_type = typename AccessorPolicy::data_handle_type;
+        using reference = typename AccessorPolicy::reference;
+
+    private:
+        data_handle_type _ptr;
+        mapping_type _map;
+        accessor_type _acc;
+
+    public:
+        constexpr mdspan()
+                : _ptr(), _map(), _acc() {
+        }
+        // the dynamic extents, or all of them
+        template <class... Sizes, class = typename std::enable_if<(sizeof...(Sizes) == Extents::rank_dynamic() || sizeof...(Sizes) == Extents::rank()) && detail::are_index_convertible<index_type, Sizes...>::value>::type>
+        explicit constexpr mdspan(data_handle_type p, Sizes... sizes)
+                : _ptr(std::move(p)), _map(extents_type(static_cast<index_type>(sizes)...)), _acc() {
+        }
+        template <class OtherIndexType, std::size_t N, class = typename std::enable_if<N == Extents::rank_dynamic() || N == Extents::rank()>::type>
+        constexpr mdspan(data_handle_type p, const std::array<OtherIndexType, N>& sizes)
+                : _ptr(std::move(p)), _map(extents_type(sizes)), _acc() {
+        }
+        constexpr mdspan(data_handle_type p, const extents_type& e)
+                : _ptr(std::move(p)), _map(e), _acc() {
+        }
+        constexpr mdspan(data_handle_type p, const mapping_type& m)
+                : _ptr(std::move(p)), _map(m), _acc() {
+        }
+        constexpr mdspan(data_handle_type p, const mapping_type& m, const accessor_type& a)
+                : _ptr(std::move(p)), _map(m), _acc(a) {
+        }
+
+        // e.g. mdspan<T, ...> -> mdspan<const T, ...>, or static -> dynamic extents
+        template <class OtherElementType, class OtherExtents, class OtherLayoutPolicy, class OtherAccessor,
+                  class = typename std::enable_if<std::is_constructible<mapping_type, const typename OtherLayoutPolicy::template mapping<OtherExtents>&>::value && std::is_constructible<accessor_type, const OtherAccessor&>::value && std::is_convertible<typename OtherAccessor::data_handle_type, data_handle_type>::value>::type>
+        constexpr mdspan(const mdspan<OtherElementType, OtherExtents, OtherLayoutPolicy, OtherAccessor>& other)
+                : _ptr(other.data_handle()), _map(other.mapping()), _acc(other.accessor()) {
+        }
+
+    public:
+        template <class... Indices, class = typename std::enable_if<sizeof...(Indices) == Extents::rank() && detail::are_index_convertible<index_type, Indices...>::value>::type>
+        USE_OVER_CPP14(constexpr)
+        reference operator()(Indices... indices) const {
+            return _acc.access(_ptr, static_cast<std::size_t>(_map(static_cast<index_type>(indices)...)));
+        }
+
+    public:
+        static constexpr rank_type rank() noexcept {
+            return Extents::rank();
+        }
+        static constexpr rank_type rank_dynamic() noexcept {
+            return Extents::rank_dynamic();
+        }
+        static constexpr std::size_t static_extent(rank_type r) noexcept {
+            return Extents::static_extent(r);
+        }
+        constexpr index_type extent(rank_type r) const noexcept {
+            return extents().extent(r);
+        }
+        USE_OVER_CPP14(constexpr)
+        size_type size() const noexcept {
+            return static_cast<size_type>(detail::extents_product(extents(), 0, rank()));
+        }
+        USE_OVER_CPP14(constexpr)
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        constexpr const extents_type& extents() const noexcept {
+            return _map.extents();
+        }
+        constexpr const data_handle_type& data_handle() const noexcept {
+            return _ptr;
+        }
+        constexpr const mapping_type& mapping() const noexcept {
+            return _map;
+        }
+        constexpr const accessor_type& accessor() const noexcept {
+            return _acc;
+        }
+
+        USE_OVER_CPP14(constexpr)
+        index_type stride(rank_type r) const {
+            return _map.stride(r);
+        }
+        static constexpr bool is_always_unique() {
+            return mapping_type::is_always_unique();
+        }
+        static constexpr bool is_always_exhaustive() {
+            return mapping_type::is_always_exhaustive();
+        }
+        static constexpr bool is_always_strided() {
+            return mapping_type::is_always_strided();
+        }
+        constexpr bool is_unique() const {
+            return _map.is_unique();
+        }
+        constexpr bool is_exhaustive() const {
+            return _map.is_exhaustive();
+        }
+        constexpr bool is_strided() const {
+            return _map.is_strided();
+        }
+
+    public:
+        void swap(mdspan& rhs) noexcept {
+            using std::swap;
+            swap(_ptr, rhs._ptr);
+            swap(_map, rhs._map);
+            swap(_acc, rhs._acc);
+        }
+    };
+
+    template <class ElementType, class Extents, class LayoutPolicy, class AccessorPolicy>
+    void swap(mdspan<ElementType, Extents, LayoutPolicy, AccessorPolicy>& lhs, mdspan<ElementType, Extents, LayoutPolicy, AccessorPolicy>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    // submdspan slice that keeps a whole dimension
+    struct full_extent_t {
+        explicit full_extent_t() = default;
+    };
+    constexpr full_extent_t full_extent{};
+
+    namespace detail {
+        enum slice_kind_value { slice_index, slice_full, slice_range };
+
+        // an integer picks one index and drops the dimension, full_extent keeps it,
+        // and a pair [first, second) keeps part of it
+        template <class Slice>
+        struct slice_kind : std::integral_constant<int, std::is_same<Slice, full_extent_t>::value ? slice_full : slice_index> {
+        };
+        template <class First, class Second>
+        struct slice_kind<std::pair<First, Second>> : std::integral_constant<int, slice_range> {
+        };
+
+        template <class IndexType, class Slice>
+        constexpr IndexType slice_first(const Slice& s) noexcept {
+            return static_cast<IndexType>(s);
+        }
+        template <class IndexType>
+        constexpr IndexType slice_first(full_extent_t) noexcept {
+            return 0;
+        }
+        template <class IndexType, class First, class Second>
+        constexpr IndexType slice_first(const std::pair<First, Second>& s) noexcept {
+            return static_cast<IndexType>(s.first);
+        }
+
+        // the size of a range; full_extent and integers are resolved by the caller
+        template <class IndexType, class Slice>
+        constexpr IndexType slice_size(const Slice&) noexcept {
+            return 0;
+        }
+        template <class IndexType, class First, class Second>
+        constexpr IndexType slice_size(const std::pair<First, Second>& s) noexcept {
+            return static_cast<IndexType>(s.second) - static_cast<IndexType>(s.first);
+        }
+
+        template <class IndexType, class Kept, class Source, class... Slices>
+        struct sub_extents_builder;
+        template <class IndexType, std::size_t... Kept>
+        struct sub_extents_builder<IndexType, size_list<Kept...>, size_list<>> {
+            using type = extents<IndexType, Kept...>;
+        };
+        template <class IndexType, std::size_t... Kept, std::size_t E0, std::size_t... E, class S0, class... S>
+        struct sub_extents_builder<IndexType, size_list<Kept...>, size_list<E0, E...>, S0, S...>
+                : sub_extents_builder<IndexType,
+                                      typename std::conditional<slice_kind<S0>::value == slice_index, size_list<Kept...>, size_list<Kept..., (slice_kind<S0>::value == slice_full ? E0 : dynamic_extent)>>::type,
+                                      size_list<E...>, S...> {
+        };
+
+        template <class Extents, class... Slices>
+        struct sub_extents;
+        template <class IndexType, std::size_t... Extents, class... Slices>
+        struct sub_extents<extents<IndexType, Extents...>, Slices...> : sub_extents_builder<IndexType, size_list<>, size_list<Extents...>, Slices...> {
+        };
+
+        // layout_right survives when every slice after the first kept dimension is full_extent
+        template <int State, class... Slices>
+        struct preserves_layout_right : std::true_type {
+        };
+        template <int State, class S0, class... S>
+        struct preserves_layout_right<State, S0, S...>
+                : std::conditional<State == 0,
+                                   preserves_layout_right<(slice_kind<S0>::value == slice_index ? 0 : 1), S...>,
+                                   typename std::conditional<slice_kind<S0>::value == slice_full, preserves_layout_right<1, S...>, std::false_type>::type>::type {
+        };
+
+        // layout_left survives when every slice before the last kept dimension is full_extent
+        template <int State, class... Slices>
+        struct preserves_layout_left : std::true_type {
+        };
+        template <int State, class S0, class... S>
+        struct preserves_layout_left<State, S0, S...>
+                : std::conditional<State == 0,
+                                   preserves_layout_left<(slice_kind<S0>::value == slice_full ? 0 : 1), S...>,
+                                   typename std::conditional<slice_kind<S0>::value == slice_index, preserves_layout_left<1, S...>, std::false_type>::type>::type {
+        };
+
+        template <class LayoutPolicy, class... Slices>
+        struct sub_layout {
+            using type = layout_stride;
+        };
+        template <class... Slices>
+        struct sub_layout<layout_right, Slices...> {
+            using type = typename std::conditional<preserves_layout_right<0, Slices...>::value, layout_right, layout_stride>::type;
+        };
+        template <class... Slices>
+        struct sub_layout<layout_left, Slices...> {
+            using type = typename std::conditional<preserves_layout_left<0, Slices...>::value, layout_left, layout_stride>::type;
+        };
+
+        template <class LayoutPolicy, class Extents>
+        struct sub_mapping {
+            template <class Strides>
+            static typename LayoutPolicy::template mapping<Extents> make(const Extents& e, const Strides&) noexcept {
+                return typename LayoutPolicy::template mapping<Extents>(e);
+            }
+        };
+        template <class Extents>
+        struct sub_mapping<layout_stride, Extents> {
+            template <class Strides>
+            static layout_stride::mapping<Extents> make(const Extents& e, const Strides& strides) noexcept {
+                return layout_stride::mapping<Extents>(e, strides);
+            }
+        };
+    } // namespace detail
+
+    // A view of part of m: one slice per dimension, each an index, full_extent or a [first, second) pair.
+    // Static extents of fully kept dimensions stay static, and layout_right/layout_left are kept when
+    // the result is still contiguous in the fast dimension; otherwise the result uses layout_stride.
+    template <class ElementType, class Extents, class LayoutPolicy, class AccessorPolicy, class... Slices>
+    mdspan<ElementType, typename detail::sub_extents<Extents, Slices...>::type, typename detail::sub_layout<LayoutPolicy, Slices...>::type, typename AccessorPolicy::offset_policy>
+    submdspan(const mdspan<ElementType, Extents, LayoutPolicy, AccessorPolicy>& m, Slices... slices) {
+        static_assert(sizeof...(Slices) == Extents::rank(), "submdspan: one slice per dimension");
+        using index_type = typename Extents::index_type;
+        using sub_extents_type = typename detail::sub_extents<Extents, Slices...>::type;
+        using sub_layout_type = typename detail::sub_layout<LayoutPolicy, Slices...>::type;
+
+        const index_type firsts[] = {detail::slice_first<index_type>(slices)..., 0};
+        const index_type sizes[] = {detail::slice_size<index_type>(slices)..., 0};
+        const int kinds[] = {detail::slice_kind<Slices>::value..., 0};
+
+        std::array<index_type, sub_extents_type::rank()> sub_sizes = {}, sub_strides = {};
+        index_type offset = 0;
+        for (std::size_t r = 0, k = 0; r < Extents::rank(); ++r) {
+            offset += firsts[r] * m.stride(r);
+            if (kinds[r] == detail::slice_index) continue;
+            sub_sizes[k] = kinds[r] == detail::slice_full ? m.extent(r) : sizes[r];
+            sub_strides[k] = m.stride(r);
+            ++k;
+        }
+        return {m.accessor().offset(m.data_handle(), static_cast<std::size_t>(offset)),
+                detail::sub_mapping<sub_layout_type, sub_extents_type>::make(sub_extents_type(sub_sizes), sub_strides),
+                typename AccessorPolicy::offset_policy(m.accessor())};
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_MDSPAN_HPP
@@ -0,0 +1,666 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_MEMORY_RESOURCE_HPP
+#define LIBCPP17_MEMORY_RESOURCE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace cpp17 {
+    namespace pmr {
+        class memory_resource {
+        public:
+            virtual ~memory_resource() = default;
+
+            void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+                return do_allocate(bytes, alignment);
+            }
+            void deallocate(void* p, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+                do_deallocate(p, bytes, alignment);
+            }
+            bool is_equal(const memory_resource& other) const noexcept {
+                return do_is_equal(other);
+            }
+
+        private:
+            virtual void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+            virtual void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) = 0;
+            virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+        };
+
+        inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+            return &lhs == &rhs || lhs.is_equal(rhs);
+        }
+        inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+        namespace detail {
+            class new_delete_memory_resource final : public memory_resource {
+            private:
+                void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                    if (alignment <= alignof(std::max_align_t)) {
+                        return ::operator new(bytes);
+                    }
+                    // over-aligned: keep the original pointer just before the aligned block
+                    void* raw = ::operator new(bytes + alignment + sizeof(void*));
+                    auto addr = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+                    addr = (addr + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+                    reinterpret_cast<void**>(addr)[-1] = raw;
+                    return reinterpret_cast<void*>(addr);
+                }
+                void do_deallocate(void* p, std::size_t, std::size_t alignment) override {
+                    if (alignment <= alignof(std::max_align_t)) {
+                        ::operator delete(p);
+                    } else {
+                        ::operator delete(static_cast<void**>(p)[-1]);
+                    }
+                }
+                bool do_is_equal(const memory_resource& other) const noexcept override {
+                    return this == &other;
+                }
+            };
+
+            class null_resource final : public memory_resource {
+            private:
+                void* do_allocate(std::size_t, std::size_t) override {
+                    throw std::bad_alloc();
+                }
+                void do_deallocate(void*, std::size_t, std::size_t) override {
+                }
+                bool do_is_equal(const memory_resource& other) const noexcept override {
+                    return this == &other;
+                }
+            };
+
+            inline std::atomic<memory_resource*>& default_resource();
+
+            inline std::size_t align_up(std::size_t n, std::size_t alignment) noexcept {
+                return (n + alignment - 1) & ~(alignment - 1);
+            }
+        } // namespace detail
+
+        inline memory_resource* new_delete_resource() noexcept {
+            static detail::new_delete_memory_resource r;
+            return &r;
+        }
+        inline memory_resource* null_memory_resource() noexcept {
+            static detail::null_resource r;
+            return &r;
+        }
+
+        namespace detail {
+            inline std::atomic<memory_resource*>& default_resource() {
+                static std::atomic<memory_resource*> r(new_delete_resource());
+                return r;
+            }
+        } // namespace detail
+
+        inline memory_resource* get_default_resource() noexcept {
+            return detail::default_resource().load(std::memory_order_acquire);
+        }
+        inline memory_resource* set_default_resource(memory_resource* r) noexcept {
+            if (r == nullptr) r = new_delete_resource();
+            return detail::default_resource().exchange(r, std::memory_order_acq_rel);
+        }
+
+        namespace detail {
+            template <class T>
+            struct is_pair : std::false_type {};
+            template <class T1, class T2>
+            struct is_pair<std::pair<T1, T2>> : std::true_type {};
+
+            // how T takes an allocator: 0 it does not, 1 after allocator_arg, 2 as the last argument
+            template <class T, class Alloc, class... Args>
+            struct uses_allocator_kind
+                    : std::integral_constant<int, !std::uses_allocator<T, Alloc>::value ? 0 : std::is_constructible<T, std::allocator_arg_t, const Alloc&, Args...>::value ? 1 : 2> {};
+        } // namespace detail
+
+        template <class T>
+        class polymorphic_allocator {
+        public:
+            using value_type = T;
+
+        private:
+            memory_resource* _resource;
+
+        public:
+            polymorphic_allocator() noexcept
+                    : _resource(get_default_resource()) {
+            }
+            polymorphic_allocator(memory_resource* r)
+                    : _resource(r) {
+            }
+            polymorphic_allocator(const polymorphic_allocator&) = default;
+            template <class U>
+            polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept
+                    : _resource(other.resource()) {
+            }
+
+            polymorphic_allocator& operator=(const polymorphic_allocator&) = delete;
+
+        public:
+            T* allocate(std::size_t n) {
+                return static_cast<T*>(_resource->allocate(n * sizeof(T), alignof(T)));
+            }
+            void deallocate(T* p, std::size_t n) {
+                _resource->deallocate(p, n * sizeof(T), alignof(T));
+            }
+
+            // uses-allocator construction: elements that take an allocator get this one, so nested
+            // containers and both members of a pair allocate from the same resource
+            template <class U, class... Args>
+            void construct(U* p, Args&&... args) {
+                _construct(detail::is_pair<U>(), p, std::forward<Args>(args)...);
+            }
+            template <class U>
+            void destroy(U* p) {
+                p->~U();
+            }
+
+            polymorphic_allocator select_on_container_copy_construction() const {
+                return polymorphic_allocator();
+            }
+
+            memory_resource* resource() const noexcept {
+                return _resource;
+            }
+
+        private:
+            template <class U, class... Args>
+            void _construct(std::false_type, U* p, Args&&... args) {
+                _construct_element(detail::uses_allocator_kind<U, polymorphic_allocator, Args...>(), p, std::forward<Args>(args)...);
+            }
+            template <class U, class... Args>
+            void _construct(std::true_type, U* p, Args&&... args) {
+                _construct_pair(p, std::forward<Args>(args)...);
+            }
+
+            template <class U, class... Args>
+            void _construct_element(std::integral_constant<int, 0>, U* p, Args&&... args) {
+                new (p) U(std::forward<Args>(args)...);
+            }
+            template <class U, class... Args>
+            void _construct_element(std::integral_constant<int, 1>, U* p, Args&&... args) {
+                new (p) U(std::allocator_arg, *this, std::forward<Args>(args)...);
+            }
+            template <class U, class... Args>
+            void _construct_element(std::integral_constant<int, 2>, U* p, Args&&... args) {
+                new (p) U(std::forward<Args>(args)..., *this);
+            }
+
+            template <class T1, class T2, class... Args1, class... Args2>
+            void _construct_pair(std::pair<T1, T2>* p, std::piecewise_construct_t, std::tuple<Args1...> x, std::tuple<Args2...> y) {
+                new (p) std::pair<T1, T2>(std::piecewise_construct,
+                                          _element_args<T1>(detail::uses_allocator_kind<T1, polymorphic_allocator, Args1...>(), std::move(x)),
+                                          _element_args<T2>(detail::uses_allocator_kind<T2, polymorphic_allocator, Args2...>(), std::move(y)));
+            }
+            template <class T1, class T2>
+            void _construct_pair(std::pair<T1, T2>* p) {
+                _construct_pair(p, std::piecewise_construct, std::tuple<>(), std::tuple<>());
+            }
+            template <class T1, class T2, class U1, class U2>
+            void _construct_pair(std::pair<T1, T2>* p, U1&& x, U2&& y) {
+                _construct_pair(p, std::piecewise_construct, std::forward_as_tuple(std::forward<U1>(x)), std::forward_as_tuple(std::forward<U2>(y)));
+            }
+            template <class T1, class T2, class U1, class U2>
+            void _construct_pair(std::pair<T1, T2>* p, const std::pair<U1, U2>& other) {
+                _construct_pair(p, std::piecewise_construct, std::forward_as_tuple(other.first), std::forward_as_tuple(other.second));
+            }
+            template <class T1, class T2, class U1, class U2>
+            void _construct_pair(std::pair<T1, T2>* p, std::pair<U1, U2>&& other) {
+                _construct_pair(p, std::piecewise_construct, std::forward_as_tuple(std::forward<U1>(other.first)), std::forward_as_tuple(std::forward<U2>(other.second)));
+            }
+
+            template <class U, class... Args>
+            std::tuple<Args...> _element_args(std::integral_constant<int, 0>, std::tuple<Args...>&& args) const {
+                return std::move(args);
+            }
+            template <class U, class... Args>
+            std::tuple<std::allocator_arg_t, const polymorphic_allocator&, Args...> _element_args(std::integral_constant<int, 1>, std::tuple<Args...>&& args) const {
+                return std::tuple_cat(std::tuple<std::allocator_arg_t, const polymorphic_allocator&>(std::allocator_arg, *this), std::move(args));
+            }
+            template <class U, class... Args>
+            std::tuple<Args..., const polymorphic_allocator&> _element_args(std::integral_constant<int, 2>, std::tuple<Args...>&& args) const {
+                return std::tuple_cat(std::move(args), std::tuple<const polymorphic_allocator&>(*this));
+            }
+        };
+
+        template <class T, class U>
+        bool operator==(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept {
+            return *lhs.resource() == *rhs.resource();
+        }
+        template <class T, class U>
+        bool operator!=(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+        class monotonic_buffer_resource : public memory_resource {
+        private:
+            struct _chunk {
+                _chunk* next;
+                std::size_t size;
+            };
+
+            memory_resource* _upstream;
+            void* _initial_buffer;
+            std::size_t _initial_size;
+            char* _current;
+            std::size_t _available;
+            std::size_t _initial_next_size;
+            std::size_t _next_size;
+            _chunk* _chunks;
+
+        public:
+            explicit monotonic_buffer_resource(memory_resource* upstream)
+                    : monotonic_buffer_resource(1024, upstream) {
+            }
+            monotonic_buffer_resource(std::size_t initial_size, memory_resource* upstream)
+                    : _upstream(upstream), _initial_buffer(nullptr), _initial_size(0), _current(nullptr), _available(0), _initial_next_size(initial_size > 0 ? initial_size : 1), _next_size(_initial_next_size), _chunks(nullptr) {
+            }
+            monotonic_buffer_resource(void* buffer, std::size_t buffer_size, memory_resource* upstream)
+                    : _upstream(upstream), _initial_buffer(buffer), _initial_size(buffer_size), _current(static_cast<char*>(buffer)), _available(buffer_size), _initial_next_size(buffer_size > 0 ? buffer_size * 2 : 1024), _next_size(_initial_next_size), _chunks(nullptr) {
+            }
+            monotonic_buffer_resource()
+                    : monotonic_buffer_resource(get_default_resource()) {
+            }
+            explicit monotonic_buffer_resource(std::size_t initial_size)
+                    : monotonic_buffer_resource(initial_size, get_default_resource()) {
+            }
+            monotonic_buffer_resource(void* buffer, std::size_t buffer_size)
+                    : monotonic_buffer_resource(buffer, buffer_size, get_default_resource()) {
+            }
+
+            monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+            monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+            ~monotonic_buffer_resource() override {
+                release();
+            }
+
+        public:
+            void release() {
+                while (_chunks != nullptr) {
+                    _chunk* next = _chunks->next;
+                    _upstream->deallocate(_chunks, _chunks->size, alignof(std::max_align_t));
+                    _chunks = next;
+                }
+                _current = static_cast<char*>(_initial_buffer);
+                _available = _initial_size;
+                _next_size = _initial_next_size;
+            }
+            memory_resource* upstream_resource() const {
+                return _upstream;
+            }
+
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                if (bytes == 0) bytes = 1;
+                void* p = _current;
+                if (std::align(alignment, bytes, p, _available) == nullptr) {
+                    _grow(bytes, alignment);
+                    p = _current;
+                    std::align(alignment, bytes, p, _available);
+                }
+                _current = static_cast<char*>(p) + bytes;
+                _available -= bytes;
+                return p;
+            }
+            void do_deallocate(void*, std::size_t, std::size_t) override {
+            }
+            bool do_is_equal(const memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+
+            void _grow(std::size_t bytes, std::size_t alignment) {
+                std::size_t header = detail::align_up(sizeof(_chunk), alignof(std::max_align_t));
+                std::size_t needed = header + bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+                std::size_t size = _next_size > needed ? _next_size : needed;
+                auto c = static_cast<_chunk*>(_upstream->allocate(size, alignof(std::max_align_t)));
+                c->next = _chunks;
+                c->size = size;
+                _chunks = c;
+                _current = reinterpret_cast<char*>(c) + header;
+                _available = size - header;
+                _next_size = size * 2;
+            }
+        };
+
+        struct pool_options {
+            std::size_t max_blocks_per_chunk = 0;
+            std::size_t largest_required_pool_block = 0;
+        };
+
+        class unsynchronized_pool_resource : public memory_resource {
+            friend class synchronized_pool_resource;
+
+        private:
+            static constexpr std::size_t _min_block = 8;
+            static constexpr std::size_t _default_max_blocks = 1024;
+            static constexpr std::size_t _default_largest_block = 4096;
+
+            struct _free_block {
+                _free_block* next;
+            };
+            struct _chunk {
+                _chunk* next;
+                std::size_t size;
+            };
+            struct _large_block {
+                _large_block* prev;
+                _large_block* next;
+            };
+            struct _pool {
+                _free_block* free_list = nullptr;
+                _chunk* chunks = nullptr;
+                std::size_t next_blocks = 16;
+            };
+
+            memory_resource* _upstream;
+            pool_options _options;
+            std::size_t _pool_count;
+            std::unique_ptr<_pool[]> _pools;
+            _large_block* _large;
+
+        public:
+            unsynchronized_pool_resource(const pool_options& opts, memory_resource* upstream)
+                    : _upstream(upstream), _options(opts), _pool_count(0), _pools(), _large(nullptr) {
+                if (_options.max_blocks_per_chunk == 0) _options.max_blocks_per_chunk = _default_max_blocks;
+                if (_options.largest_required_pool_block == 0) _options.largest_required_pool_block = _default_largest_block;
+                std::size_t largest = _min_block;
+                _pool_count = 1;
+                while (largest < _options.largest_required_pool_block) {
+                    largest *= 2;
+                    ++_pool_count;
+                }
+                _options.largest_required_pool_block = largest;
+                _pools.reset(new _pool[_pool_count]);
+            }
+            unsynchronized_pool_resource()
+                    : unsynchronized_pool_resource(pool_options(), get_default_resource()) {
+            }
+            explicit unsynchronized_pool_resource(memory_resource* upstream)
+                    : unsynchronized_pool_resource(pool_options(), upstream) {
+            }
+            explicit unsynchronized_pool_resource(const pool_options& opts)
+                    : unsynchronized_pool_resource(opts, get_default_resource()) {
+            }
+
+            unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+            unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+            ~unsynchronized_pool_resource() override {
+                release();
+            }
+
+        public:
+            void release() {
+                for (std::size_t i = 0; i < _pool_count; ++i) {
+                    _pool& pool = _pools[i];
+                    while (pool.chunks != nullptr) {
+                        _chunk* next = pool.chunks->next;
+                        _upstream->deallocate(pool.chunks, pool.chunks->size, alignof(std::max_align_t));
+                        pool.chunks = next;
+                    }
+                    pool = _pool();
+                }
+                while (_large != nullptr) {
+                    _large_block* next = _large->next;
+                    // the size and alignment of a large block are stored right after its links
+                    auto info = reinterpret_cast<std::size_t*>(_large + 1);
+                    _upstream->deallocate(_large, info[0], info[1]);
+                    _large = next;
+                }
+            }
+            memory_resource* upstream_resource() const {
+                return _upstream;
+            }
+            pool_options options() const {
+                return _options;
+            }
+
+        private:
+            std::size_t _pool_index(std::size_t bytes, std::size_t alignment) const noexcept {
+                std::size_t size = bytes > alignment ? bytes : alignment;
+                std::size_t block = _min_block;
+                std::size_t index = 0;
+                while (block < size) {
+                    block *= 2;
+                    ++index;
+                }
+                return index;
+            }
+
+            bool _is_pooled(std::size_t bytes, std::size_t alignment) const noexcept {
+                return _pool_index(bytes, alignment) < _pool_count && alignment <= alignof(std::max_align_t);
+            }
+
+            // detaches the free blocks of one size class so that another pool can reuse them
+            _free_block* _take_free(std::size_t index) noexcept {
+                _free_block* list = _pools[index].free_list;
+                _pools[index].free_list = nullptr;
+                return list;
+            }
+            void _give_free(std::size_t index, _free_block* list) noexcept {
+                if (list == nullptr) return;
+                _free_block*& head = _pools[index].free_list;
+                if (head != nullptr) {
+                    _free_block* tail = list;
+                    while (tail->next != nullptr) tail = tail->next;
+                    tail->next = head;
+                }
+                head = list;
+            }
+
+            // pool blocks are only aligned to the block size up to max_align_t; anything stricter goes to upstream
+            static std::size_t _large_alignment(std::size_t alignment) noexcept {
+                return alignment > alignof(std::max_align_t) ? alignment : alignof(std::max_align_t);
+            }
+            static std::size_t _large_header(std::size_t alignment) noexcept {
+                std::size_t header = sizeof(_large_block) + 2 * sizeof(std::size_t);
+                return detail::align_up(header, alignment);
+            }
+
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                std::size_t index = _pool_index(bytes, alignment);
+                if (index >= _pool_count || alignment > alignof(std::max_align_t)) {
+                    return _allocate_large(bytes, alignment);
+                }
+                _pool& pool = _pools[index];
+                if (pool.free_list == nullptr) {
+                    _refill(pool, _min_block << index);
+                }
+                _free_block* b = pool.free_list;
+                pool.free_list = b->next;
+                return b;
+            }
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+                std::size_t index = _pool_index(bytes, alignment);
+                if (index >= _pool_count || alignment > alignof(std::max_align_t)) {
+                    _deallocate_large(p, alignment);
+                    return;
+                }
+                _pool& pool = _pools[index];
+                auto b = static_cast<_free_block*>(p);
+                b->next = pool.free_list;
+                pool.free_list = b;
+            }
+            bool do_is_equal(const memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+
+            void _refill(_pool& pool, std::size_t block_size) {
+                std::size_t header = detail::align_up(sizeof(_chunk), alignof(std::max_align_t));
+                std::size_t count = pool.next_blocks;
+                std::size_t size = header + count * block_size;
+                auto c = static_cast<_chunk*>(_upstream->allocate(size, alignof(std::max_align_t)));
+                c->next = pool.chunks;
+                c->size = size;
+                pool.chunks = c;
+
+                char* first = reinterpret_cast<char*>(c) + header;
+                for (std::size_t i = count; i > 0; --i) {
+                    auto b = reinterpret_cast<_free_block*>(first + (i - 1) * block_size);
+                    b->next = pool.free_list;
+                    pool.free_list = b;
+                }
+                if (pool.next_blocks < _options.max_blocks_per_chunk) {
+                    pool.next_blocks *= 2;
+                }
+            }
+
+            void* _allocate_large(std::size_t bytes, std::size_t alignment) {
+                alignment = _large_alignment(alignment);
+                std::size_t header = _large_header(alignment);
+                std::size_t size = header + bytes;
+                auto l = static_cast<_large_block*>(_upstream->allocate(size, alignment));
+                auto info = reinterpret_cast<std::size_t*>(l + 1);
+                info[0] = size;
+                info[1] = alignment;
+                l->prev = nullptr;
+                l->next = _large;
+                if (_large != nullptr) _large->prev = l;
+                _large = l;
+                return reinterpret_cast<char*>(l) + header;
+            }
+            void _deallocate_large(void* p, std::size_t alignment) {
+                alignment = _large_alignment(alignment);
+                auto l = reinterpret_cast<_large_block*>(static_cast<char*>(p) - _large_header(alignment));
+                if (l->prev != nullptr) {
+                    l->prev->next = l->next;
+                } else {
+                    _large = l->next;
+                }
+                if (l->next != nullptr) l->next->prev = l->prev;
+                auto info = reinterpret_cast<std::size_t*>(l + 1);
+                _upstream->deallocate(l, info[0], info[1]);
+            }
+        };
+
+        class synchronized_pool_resource : public memory_resource {
+        private:
+            static constexpr std::size_t _shard_count = 16;
+
+            // A block freed on another thread lands in that thread's shard, so a shard that runs out of
+            // blocks first takes the free list of the same size class from the other shards and only
+            // then goes upstream; all shards share the size classes and are released together.
+            // Oversized blocks always use shard 0.
+            struct _shard {
+                std::mutex mutex;
+                std::unique_ptr<unsynchronized_pool_resource> pool;
+                char padding[64];
+            };
+
+            std::unique_ptr<_shard[]> _shards;
+
+            static std::size_t _this_shard() {
+                static thread_local std::size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % _shard_count;
+                return index;
+            }
+            _shard& _select(std::size_t bytes, std::size_t alignment) {
+                return _shards[_shards[0].pool->_is_pooled(bytes, alignment) ? _this_shard() : 0];
+            }
+
+        public:
+            synchronized_pool_resource(const pool_options& opts, memory_resource* upstream)
+                    : _shards(new _shard[_shard_count]) {
+                for (std::size_t i = 0; i < _shard_count; ++i) {
+                    _shards[i].pool.reset(new unsynchronized_pool_resource(opts, upstream));
+                }
+            }
+            synchronized_pool_resource()
+                    : synchronized_pool_resource(pool_options(), get_default_resource()) {
+            }
+            explicit synchronized_pool_resource(memory_resource* upstream)
+                    : synchronized_pool_resource(pool_options(), upstream) {
+            }
+            explicit synchronized_pool_resource(const pool_options& opts)
+                    : synchronized_pool_resource(opts, get_default_resource()) {
+            }
+
+            synchronized_pool_resource(const synchronized_pool_resource&) = delete;
+            synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+
+        public:
+            void release() {
+                for (std::size_t i = 0; i < _shard_count; ++i) {
+                    std::lock_guard<std::mutex> lock(_shards[i].mutex);
+                    _shards[i].pool->release();
+                }
+            }
+            memory_resource* upstream_resource() const {
+                return _shards[0].pool->upstream_resource();
+            }
+            pool_options options() const {
+                return _shards[0].pool->options();
+            }
+
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                if (!_shards[0].pool->_is_pooled(bytes, alignment)) {
+                    std::lock_guard<std::mutex> lock(_shards[0].mutex);
+                    return _shards[0].pool->allocate(bytes, alignment);
+                }
+                _shard& shard = _shards[_this_shard()];
+                std::size_t index = shard.pool->_pool_index(bytes, alignment);
+                {
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    if (shard.pool->_pools[index].free_list != nullptr) {
+                        return shard.pool->allocate(bytes, alignment);
+                    }
+                }
+                // shards are locked one at a time, so two shards stealing from each other cannot deadlock
+                unsynchronized_pool_resource::_free_block* stolen = nullptr;
+                for (std::size_t i = 0; i < _shard_count && stolen == nullptr; ++i) {
+                    if (&_shards[i] == &shard) continue;
+                    std::lock_guard<std::mutex> lock(_shards[i].mutex);
+                    stolen = _shards[i].pool->_take_free(index);
+                }
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.pool->_give_free(index, stolen);
+                return shard.pool->allocate(bytes, alignment);
+            }
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+                _shard& shard = _select(bytes, alignment);
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.pool->deallocate(p, bytes, alignment);
+            }
+            bool do_is_equal(const memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+        template <class CharT, class Traits = std::char_traits<CharT>>
+        using basic_string = std::basic_string<CharT, Traits, polymorphic_allocator<CharT>>;
+
+        using string = basic_string<char>;
+        using wstring = basic_string<wchar_t>;
+        using u16string = basic_string<char16_t>;
+        using u32string = basic_string<char32_t>;
+    } // namespace pmr
+} // namespace cpp17
+
+#endif //LIBCPP17_MEMORY_RESOURCE_HPP
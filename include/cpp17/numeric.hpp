@@ -0,0 +1,141 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_NUMERIC_HPP
+#define LIBCPP17_NUMERIC_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "execution.hpp"
+#include "span.hpp"
+
+namespace cpp17 {
+    namespace detail {
+        struct plus {
+            template <class T, class U>
+            constexpr auto operator()(T&& lhs, U&& rhs) const -> decltype(std::forward<T>(lhs) + std::forward<U>(rhs)) {
+                return std::forward<T>(lhs) + std::forward<U>(rhs);
+            }
+        };
+        struct multiplies {
+            template <class T, class U>
+            constexpr auto operator()(T&& lhs, U&& rhs) const -> decltype(std::forward<T>(lhs) * std::forward<U>(rhs)) {
+                return std::forward<T>(lhs) * std::forward<U>(rhs);
+            }
+        };
+
+        // one partial result per chunk, folded left to right into init
+        template <class Policy, class T, class Reduce, class Element>
+        T reduce_indices(const Policy& policy, std::size_t size, T init, Reduce reduce, Element element) {
+            auto chunks = make_chunking(policy, size);
+            std::vector<T> partials(chunks.count, init);
+            for_each_chunk(policy, chunks, [&](std::size_t c, std::size_t begin, std::size_t end) {
+                T sum = element(begin);
+                for (std::size_t i = begin + 1; i < end; ++i) {
+                    sum = reduce(std::move(sum), element(i));
+                }
+                partials[c] = std::move(sum);
+            });
+            for (auto& p : partials) {
+                init = reduce(std::move(init), std::move(p));
+            }
+            return init;
+        }
+
+        template <class Policy, class T, std::size_t N, class U, std::size_t M, class Op>
+        span<U> inclusive_scan(const Policy& policy, span<T, N> in, span<U, M> out, Op op, const U* init) {
+            if (out.size() < in.size()) throw std::invalid_argument("output span is shorter than the input");
+            auto chunks = make_chunking(policy, in.size());
+            // carries[c] is the total of everything before chunk c + 1
+            std::vector<U> carries;
+            if (chunks.count > 1) {
+                std::vector<U> partials(chunks.count - 1, in[0]);
+                for_each_chunk(policy, chunking{chunks.grain * (chunks.count - 1), chunks.grain, chunks.count - 1}, [&](std::size_t c, std::size_t begin, std::size_t end) {
+                    U sum = in[begin];
+                    for (std::size_t i = begin + 1; i < end; ++i) {
+                        sum = op(std::move(sum), in[i]);
+                    }
+                    partials[c] = std::move(sum);
+                });
+                carries.reserve(partials.size());
+                carries.push_back(init != nullptr ? op(*init, partials[0]) : partials[0]);
+                for (std::size_t c = 1; c < partials.size(); ++c) {
+                    carries.push_back(op(carries.back(), partials[c]));
+                }
+            }
+            for_each_chunk(policy, chunks, [&](std::size_t c, std::size_t begin, std::size_t end) {
+                const U* carry = c != 0 ? &carries[c - 1] : init;
+                U sum = carry != nullptr ? op(*carry, in[begin]) : U(in[begin]);
+                out[begin] = sum;
+                for (std::size_t i = begin + 1; i < end; ++i) {
+                    sum = op(std::move(sum), in[i]);
+                    out[i] = sum;
+                }
+            });
+            return out.first(in.size());
+        }
+    } // namespace detail
+
+    template <class Policy, class T, std::size_t N, class U, class Reduce, class Transform>
+    detail::enable_if_execution_policy<Policy, U> transform_reduce(Policy&& policy, span<T, N> s, U init, Reduce reduce, Transform transform) {
+        return detail::reduce_indices(policy, s.size(), std::move(init), reduce, [&](std::size_t i) -> U {
+            return transform(s[i]);
+        });
+    }
+
+    template <class Policy, class T1, std::size_t N1, class T2, std::size_t N2, class U, class Reduce, class Transform>
+    detail::enable_if_execution_policy<Policy, U> transform_reduce(Policy&& policy, span<T1, N1> s1, span<T2, N2> s2, U init, Reduce reduce, Transform transform) {
+        if (s2.size() < s1.size()) throw std::invalid_argument("second span is shorter than the first");
+        return detail::reduce_indices(policy, s1.size(), std::move(init), reduce, [&](std::size_t i) -> U {
+            return transform(s1[i], s2[i]);
+        });
+    }
+
+    // inner product
+    template <class Policy, class T1, std::size_t N1, class T2, std::size_t N2, class U>
+    detail::enable_if_execution_policy<Policy, U> transform_reduce(Policy&& policy, span<T1, N1> s1, span<T2, N2> s2, U init) {
+        return cpp17::transform_reduce(policy, s1, s2, std::move(init), detail::plus(), detail::multiplies());
+    }
+
+    template <class Policy, class T, std::size_t N, class U, class Reduce>
+    detail::enable_if_execution_policy<Policy, U> reduce(Policy&& policy, span<T, N> s, U init, Reduce reduce) {
+        return detail::reduce_indices(policy, s.size(), std::move(init), reduce, [&](std::size_t i) -> U {
+            return s[i];
+        });
+    }
+
+    template <class Policy, class T, std::size_t N, class U>
+    detail::enable_if_execution_policy<Policy, U> reduce(Policy&& policy, span<T, N> s, U init) {
+        return cpp17::reduce(policy, s, std::move(init), detail::plus());
+    }
+
+    // out may alias in; returns the written part of out
+    template <class Policy, class T, std::size_t N, class U, std::size_t M, class Op = detail::plus>
+    detail::enable_if_execution_policy<Policy, span<U>> inclusive_scan(Policy&& policy, span<T, N> in, span<U, M> out, Op op = Op()) {
+        return detail::inclusive_scan(policy, in, out, op, static_cast<const U*>(nullptr));
+    }
+
+    template <class Policy, class T, std::size_t N, class U, std::size_t M, class Op>
+    detail::enable_if_execution_policy<Policy, span<U>> inclusive_scan(Policy&& policy, span<T, N> in, span<U, M> out, Op op, U init) {
+        return detail::inclusive_scan(policy, in, out, op, &init);
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_NUMERIC_HPP
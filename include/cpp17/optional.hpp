@@ -17,10 +17,13 @@
 #ifndef CPP17_OPTIONAL_HPP
 #define CPP17_OPTIONAL_HPP
 
+#include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 
 #include "detail/only.hpp"
+#include "detail/special_members.hpp"
 
 
 namespace cpp17 {
@@ -35,81 +38,139 @@ namespace cpp17 {
     constexpr nullopt_t nullopt{0};
     constexpr in_place_t in_place{};
 
+    namespace detail {
+        namespace optional {
+            template <class T, bool TriviallyDestructible = std::is_trivially_destructible<T>::value>
+            union storage_union {
+                char dummy;
+                T value;
+
+                constexpr storage_union() noexcept
+                        : dummy() {
+                }
+                template <class... Args>
+                constexpr storage_union(in_place_t, Args&&... args)
+                        : value(std::forward<Args>(args)...) {
+                }
+            };
+            template <class T>
+            union storage_union<T, false> {
+                char dummy;
+                T value;
+
+                constexpr storage_union() noexcept
+                        : dummy() {
+                }
+                template <class... Args>
+                constexpr storage_union(in_place_t, Args&&... args)
+                        : value(std::forward<Args>(args)...) {
+                }
+                ~storage_union() {
+                }
+            };
+
+            template <class T>
+            class storage {
+            public:
+                storage_union<T> _u;
+                bool _engaged;
+
+            public:
+                constexpr storage(uninitialized_t) noexcept
+                        : _u(), _engaged(false) {
+                }
+                template <class... Args>
+                constexpr storage(in_place_t, Args&&... args)
+                        : _u(in_place, std::forward<Args>(args)...), _engaged(true) {
+                }
+
+            public:
+                template <class... Args>
+                void _construct(Args&&... args) {
+                    ::new (static_cast<void*>(std::addressof(_u.value))) T(std::forward<Args>(args)...);
+                    _engaged = true;
+                }
+                void _reset() noexcept {
+                    if (_engaged) {
+                        _u.value.~T();
+                        _engaged = false;
+                    }
+                }
+                template <class U>
+                void _assign(U&& v) {
+                    if (_engaged) {
+                        _u.value = std::forward<U>(v);
+                    } else {
+                        _construct(std::forward<U>(v));
+                    }
+                }
+
+                void _copy_construct(const storage& rhs) {
+                    if (rhs._engaged) _construct(rhs._u.value);
+                }
+                void _move_construct(storage& rhs) {
+                    if (rhs._engaged) _construct(std::move(rhs._u.value));
+                }
+                void _copy_assign(const storage& rhs) {
+                    if (rhs._engaged) {
+                        _assign(rhs._u.value);
+                    } else {
+                        _reset();
+                    }
+                }
+                void _move_assign(storage& rhs) {
+                    if (rhs._engaged) {
+                        _assign(std::move(rhs._u.value));
+                    } else {
+                        _reset();
+                    }
+                }
+            };
+        } // namespace optional
+    } // namespace detail
+
     template <class T>
-    class optional {
+    class optional : private detail::special_member_base<detail::optional::storage<T>, T> {
     public:
         using value_type = T;
 
     private:
-        typename std::aligned_storage<sizeof(T), alignof(T)>::type _cb;
-        T* _buf;
+        using _base = detail::special_member_base<detail::optional::storage<T>, T>;
 
     public:
         constexpr optional() noexcept
-                : _cb(), _buf(nullptr) {
+                : _base(detail::uninitialized_t()) {
         }
         constexpr optional(nullopt_t) noexcept
                 : optional() {
         }
         constexpr optional(const T& v)
-                : _cb(), _buf(new (&_cb) T(v)) {
+                : _base(in_place, v) {
         }
         constexpr optional(T&& v)
-                : _cb(), _buf(new (&_cb) T(std::move(v))) {
+                : _base(in_place, std::move(v)) {
         }
         template <class... Args>
         explicit constexpr optional(in_place_t, Args&&... args)
-                : _cb(), _buf(new (&_cb) T(std::forward<Args>(args)...)) {
-        }
-
-        USE_OVER_CPP14(constexpr)
-        optional(const optional& rhs) noexcept(
-                std::is_nothrow_copy_constructible<T>::value)
-                : optional() {
-            if (rhs.has_value()) {
-                emplace(rhs.value());
-            }
-        }
-        USE_OVER_CPP14(constexpr)
-        optional(optional&& rhs) noexcept(
-                std::is_nothrow_move_constructible<T>::value)
-                : _cb(), _buf() {
-            if (rhs.has_value()) {
-                emplace(std::move(*rhs._buf));
-            }
+                : _base(in_place, std::forward<Args>(args)...) {
         }
 
-        ~optional() {
-            reset();
-        }
+        optional(const optional&) = default;
+        optional(optional&&) = default;
 
-        optional& operator=(const optional& rhs) noexcept(
-                std::is_nothrow_copy_assignable<T>::value) {
-            reset();
-            if (rhs.has_value()) {
-                emplace(rhs.value());
-            }
-            return *this;
-        }
-        optional& operator=(optional&& rhs) noexcept(
-                std::is_nothrow_move_assignable<T>::value) {
-            reset();
-            if (rhs.has_value()) {
-                emplace(std::move(*rhs._buf));
-            }
-            return *this;
-        }
+        optional& operator=(const optional&) = default;
+        optional& operator=(optional&&) = default;
 
-        optional& operator=(nullopt_t) {
+        optional& operator=(nullopt_t) noexcept {
             reset();
             return *this;
         }
         optional& operator=(const T& v) {
-            emplace(v);
+            this->_assign(v);
             return *this;
         }
         optional& operator=(T&& v) {
-            emplace(std::move(v));
+            this->_assign(std::move(v));
             return *this;
         }
 
@@ -117,69 +178,57 @@ namespace cpp17 {
         template <class... Args>
         T& emplace(Args&&... args) {
             reset();
-            _buf = new (&_cb)T(std::forward<Args>(args)...);
-            return *_buf;
+            this->_construct(std::forward<Args>(args)...);
+            return this->_u.value;
         }
-        void reset() {
-            if (has_value()) {
-                _buf->~T();
-                _buf = nullptr;
-            }
+        void reset() noexcept {
+            this->_reset();
         }
 
     public:
-        bool has_value() const noexcept {
-            return _buf != nullptr;
+        constexpr bool has_value() const noexcept {
+            return this->_engaged;
         }
-        explicit operator bool() const noexcept {
+        constexpr explicit operator bool() const noexcept {
             return has_value();
         }
 
     public:
-        constexpr T* operator->() noexcept {
-            return _buf;
+        USE_OVER_CPP14(constexpr)
+        T* operator->() noexcept {
+            return std::addressof(this->_u.value);
         }
-
-#if OVER_CPP14
         constexpr const T* operator->() const noexcept {
-            return _buf;
+            return &this->_u.value;
         }
-#endif
 
     public:
-#if OVER_CPP14
-        constexpr T& value() & noexcept {
-            return *_buf;
+        USE_OVER_CPP14(constexpr)
+        T& value() & noexcept {
+            return this->_u.value;
         }
-#endif
-
         constexpr const T& value() const& noexcept {
-            return *_buf;
+            return this->_u.value;
         }
-
-#if OVER_CPP14
-        constexpr T&& value() && noexcept {
-            return std::move(*_buf);
+        USE_OVER_CPP14(constexpr)
+        T&& value() && noexcept {
+            return std::move(this->_u.value);
         }
-#endif
         constexpr const T&& value() const&& noexcept {
-            return std::move(*_buf);
+            return std::move(this->_u.value);
         }
 
-#if OVER_CPP14
-        constexpr T& operator*() & noexcept {
+        USE_OVER_CPP14(constexpr)
+        T& operator*() & noexcept {
             return value();
         }
-#endif
         constexpr const T& operator*() const& noexcept {
             return value();
         }
-
-#if OVER_CPP14
-        constexpr T&& operator*() && noexcept {
+        USE_OVER_CPP14(constexpr)
+        T&& operator*() && noexcept {
             return std::move(value());
         }
-#endif
         constexpr const T&& operator*() const&& noexcept {
             return std::move(value());
         }
@@ -189,12 +238,11 @@ namespace cpp17 {
         constexpr T value_or(U&& v) const& {
             return has_value() ? value() : static_cast<T>(std::forward<U>(v));
         }
-#if OVER_CPP14
         template <class U>
-        constexpr T value_or(U&& v) && {
-            return has_value() ? value() : static_cast<T>(std::forward<U>(v));
+        USE_OVER_CPP14(constexpr)
+        T value_or(U&& v) && {
+            return has_value() ? std::move(value()) : static_cast<T>(std::forward<U>(v));
         }
-#endif
 
     public:
         void swap(optional& rhs) {
@@ -203,12 +251,12 @@ namespace cpp17 {
                 if (rhs.has_value()) {
                     swap(value(), rhs.value());
                 } else {
-                    rhs.value() = std::move(value());
+                    rhs.emplace(std::move(value()));
                     reset();
                 }
             } else {
                 if (rhs.has_value()) {
-                    value() = std::move(rhs.value());
+                    emplace(std::move(rhs.value()));
                     rhs.reset();
                 }
             }
@@ -0,0 +1,431 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_RING_BUFFER_HPP
+#define LIBCPP17_RING_BUFFER_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CPP17_HAS_MMAP 1
+#endif
+
+#include "span.hpp"
+
+namespace cpp17 {
+    // The part of a ring buffer that is ready to read or to write: `first` runs up to the end of the
+    // storage and `second` continues at its start. `second` is empty unless the region wraps.
+    template <class T>
+    struct ring_regions {
+        span<T> first;
+        span<T> second;
+
+        std::size_t size() const noexcept {
+            return first.size() + second.size();
+        }
+        bool empty() const noexcept {
+            return first.empty() && second.empty();
+        }
+    };
+
+    struct ring_buffer_options {
+        // Map the storage twice, back to back, so that every region is one contiguous span.
+        // The capacity is then rounded up to a whole number of pages.
+        bool mirrored = false;
+    };
+
+    namespace detail {
+        inline std::size_t ring_capacity(std::size_t n) {
+            if (n == 0) throw std::invalid_argument("ring_buffer: capacity must be positive");
+            std::size_t capacity = 1;
+            while (capacity < n) {
+                if (capacity > static_cast<std::size_t>(-1) / 2) throw std::length_error("ring_buffer: capacity too large");
+                capacity *= 2;
+            }
+            return capacity;
+        }
+
+        // power-of-two number of elements, optionally mapped twice in a row
+        template <class T>
+        class ring_storage {
+        private:
+            T* _data;
+            std::size_t _capacity;
+            bool _mirrored;
+
+        public:
+            ring_storage() noexcept
+                    : _data(nullptr), _capacity(0), _mirrored(false) {
+            }
+            ring_storage(std::size_t capacity, const ring_buffer_options& options)
+                    : ring_storage() {
+                _capacity = ring_capacity(capacity);
+                if (!options.mirrored) {
+                    _data = new T[_capacity]();
+                    return;
+                }
+#if CPP17_HAS_MMAP
+                const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+                while (_capacity * sizeof(T) % page != 0) _capacity *= 2;
+                _data = static_cast<T*>(_map_mirrored(_capacity * sizeof(T)));
+                _mirrored = true;
+#else
+                throw std::system_error(std::make_error_code(std::errc::not_supported), "ring_buffer: mirrored mapping is not available");
+#endif
+            }
+
+            ring_storage(ring_storage&& rhs) noexcept
+                    : ring_storage() {
+                swap(rhs);
+            }
+            ring_storage& operator=(ring_storage&& rhs) noexcept {
+                ring_storage(std::move(rhs)).swap(*this);
+                return *this;
+            }
+
+            ~ring_storage() {
+                if (_data == nullptr) return;
+#if CPP17_HAS_MMAP
+                if (_mirrored) {
+                    ::munmap(_data, 2 * _capacity * sizeof(T));
+                    return;
+                }
+#endif
+                delete[] _data;
+            }
+
+        public:
+            T* data() const noexcept {
+                return _data;
+            }
+            std::size_t capacity() const noexcept {
+                return _capacity;
+            }
+            bool mirrored() const noexcept {
+                return _mirrored;
+            }
+
+            // count elements from position pos, as one span when mirrored or when they do not wrap
+            ring_regions<T> regions(std::size_t pos, std::size_t count) const noexcept {
+                std::size_t at = pos & (_capacity - 1);
+                std::size_t head = _mirrored || count <= _capacity - at ? count : _capacity - at;
+                return {{_data + at, head}, {_data, count - head}};
+            }
+
+            void swap(ring_storage& rhs) noexcept {
+                std::swap(_data, rhs._data);
+                std::swap(_capacity, rhs._capacity);
+                std::swap(_mirrored, rhs._mirrored);
+            }
+
+        private:
+#if CPP17_HAS_MMAP
+            static int _anonymous_file(std::size_t bytes) {
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+                int fd = ::memfd_create("cpp17_ring_buffer", MFD_CLOEXEC);
+#else
+                static std::atomic<unsigned> counter(0);
+                std::string name = "/cpp17_ring_" + std::to_string(::getpid()) + "_" + std::to_string(counter++);
+                int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+                if (fd >= 0) ::shm_unlink(name.c_str());
+#endif
+                if (fd < 0) throw std::system_error(errno, std::generic_category(), "ring_buffer: cannot create the shared memory");
+                if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                    int error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), "ring_buffer: cannot size the shared memory");
+                }
+                return fd;
+            }
+
+            // reserve twice the size, then map the same memory over both halves
+            static void* _map_mirrored(std::size_t bytes) {
+                int fd = _anonymous_file(bytes);
+                void* base = ::mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                int error = errno;
+                if (base != MAP_FAILED) {
+                    auto p = static_cast<char*>(base);
+                    if (::mmap(p, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+                        ::mmap(p + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) {
+                        ::close(fd);
+                        return base;
+                    }
+                    error = errno;
+                    ::munmap(base, 2 * bytes);
+                }
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "ring_buffer: mirrored mmap failed");
+            }
+#endif
+        };
+
+        template <class T>
+        std::size_t copy_into(const ring_regions<T>& to, span<const T> from) noexcept {
+            std::size_t n = from.size() < to.size() ? from.size() : to.size();
+            std::size_t head = n < to.first.size() ? n : to.first.size();
+            if (head != 0) std::memcpy(to.first.data(), from.data(), head * sizeof(T));
+            if (n != head) std::memcpy(to.second.data(), from.data() + head, (n - head) * sizeof(T));
+            return n;
+        }
+
+        template <class T>
+        std::size_t copy_from(const ring_regions<T>& from, span<T> to) noexcept {
+            std::size_t n = from.size() < to.size() ? from.size() : to.size();
+            std::size_t head = n < from.first.size() ? n : from.first.size();
+            if (head != 0) std::memcpy(to.data(), from.first.data(), head * sizeof(T));
+            if (n != head) std::memcpy(to.data() + head, from.second.data(), (n - head) * sizeof(T));
+            return n;
+        }
+    } // namespace detail
+
+    // Fixed-capacity FIFO of trivially copyable elements. Producers fill writable() in place, for
+    // example with readv, and commit what they wrote; consumers read readable() in place, for example
+    // with writev, and consume what they used. Nothing is moved when the positions wrap around.
+    template <class T>
+    class ring_buffer {
+        static_assert(std::is_trivially_copyable<T>::value, "ring_buffer: T must be trivially copyable");
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+    private:
+        detail::ring_storage<T> _storage;
+        size_type _head;
+        size_type _tail;
+
+    public:
+        // the capacity is rounded up to a power of two
+        explicit ring_buffer(size_type capacity, const ring_buffer_options& options = ring_buffer_options())
+                : _storage(capacity, options), _head(0), _tail(0) {
+        }
+
+        ring_buffer(ring_buffer&& rhs) noexcept
+                : _storage(std::move(rhs._storage)), _head(rhs._head), _tail(rhs._tail) {
+            rhs._head = rhs._tail = 0;
+        }
+        ring_buffer& operator=(ring_buffer&& rhs) noexcept {
+            ring_buffer(std::move(rhs)).swap(*this);
+            return *this;
+        }
+
+    public:
+        size_type capacity() const noexcept {
+            return _storage.capacity();
+        }
+        size_type size() const noexcept {
+            return _tail - _head;
+        }
+        size_type available() const noexcept {
+            return capacity() - size();
+        }
+        bool empty() const noexcept {
+            return _tail == _head;
+        }
+        bool full() const noexcept {
+            return size() == capacity();
+        }
+        bool mirrored() const noexcept {
+            return _storage.mirrored();
+        }
+
+    public:
+        ring_regions<T> readable() const noexcept {
+            return _storage.regions(_head, size());
+        }
+        ring_regions<T> writable() const noexcept {
+            return _storage.regions(_tail, available());
+        }
+
+        // n elements of writable() now hold data
+        void commit(size_type n) {
+            if (n > available()) throw std::length_error("ring_buffer: commit past the free space");
+            _tail += n;
+        }
+        // the first n elements of readable() are done with
+        void consume(size_type n) {
+            if (n > size()) throw std::length_error("ring_buffer: consume past the stored data");
+            _head += n;
+        }
+
+    public:
+        bool try_push(const T& value) noexcept {
+            if (full()) return false;
+            _storage.data()[_tail & (capacity() - 1)] = value;
+            ++_tail;
+            return true;
+        }
+        bool try_pop(T& value) noexcept {
+            if (empty()) return false;
+            value = _storage.data()[_head & (capacity() - 1)];
+            ++_head;
+            return true;
+        }
+
+        // copies as much as fits and returns the number of elements copied
+        size_type push(span<const T> values) noexcept {
+            size_type n = detail::copy_into(writable(), values);
+            _tail += n;
+            return n;
+        }
+        size_type pop(span<T> out) noexcept {
+            size_type n = detail::copy_from(readable(), out);
+            _head += n;
+            return n;
+        }
+
+        void clear() noexcept {
+            _head = _tail = 0;
+        }
+
+        void swap(ring_buffer& rhs) noexcept {
+            _storage.swap(rhs._storage);
+            std::swap(_head, rhs._head);
+            std::swap(_tail, rhs._tail);
+        }
+    };
+
+    template <class T>
+    void swap(ring_buffer<T>& lhs, ring_buffer<T>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    // Lock-free ring_buffer for one producer thread and one consumer thread. Each side keeps a stale
+    // copy of the other side's position and only reloads it when that copy says there is not enough
+    // room or data, so in steady state the two threads touch each other's cache line once per batch.
+    template <class T>
+    class spsc_ring_buffer {
+        static_assert(std::is_trivially_copyable<T>::value, "spsc_ring_buffer: T must be trivially copyable");
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+    private:
+        detail::ring_storage<T> _storage;
+        char _padding0[64];
+        // consumer side
+        std::atomic<size_type> _head;
+        size_type _cached_tail;
+        char _padding1[64];
+        // producer side
+        std::atomic<size_type> _tail;
+        size_type _cached_head;
+        char _padding2[64];
+
+    public:
+        explicit spsc_ring_buffer(size_type capacity, const ring_buffer_options& options = ring_buffer_options())
+                : _storage(capacity, options), _head(0), _cached_tail(0), _tail(0), _cached_head(0) {
+        }
+
+        spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+        spsc_ring_buffer& operator=(const spsc_ring_buffer&) = delete;
+
+    public:
+        size_type capacity() const noexcept {
+            return _storage.capacity();
+        }
+        bool mirrored() const noexcept {
+            return _storage.mirrored();
+        }
+        // a snapshot; exact only when called from one side while the other is idle
+        size_type size() const noexcept {
+            return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+        }
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+    public:
+        // Producer: room to write, reloading the consumer position only when the last known
+        // free space is below min. The result may understate the free space.
+        ring_regions<T> writable(size_type min = 1) noexcept {
+            size_type tail = _tail.load(std::memory_order_relaxed);
+            if (capacity() - (tail - _cached_head) < min) _cached_head = _head.load(std::memory_order_acquire);
+            return _storage.regions(tail, capacity() - (tail - _cached_head));
+        }
+        // publishes n elements written into writable()
+        void commit(size_type n) {
+            size_type tail = _tail.load(std::memory_order_relaxed);
+            if (n > capacity() - (tail - _cached_head)) throw std::length_error("spsc_ring_buffer: commit past the free space");
+            _tail.store(tail + n, std::memory_order_release);
+        }
+
+        bool try_push(const T& value) noexcept {
+            size_type tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _cached_head == capacity()) {
+                _cached_head = _head.load(std::memory_order_acquire);
+                if (tail - _cached_head == capacity()) return false;
+            }
+            _storage.data()[tail & (capacity() - 1)] = value;
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+        size_type push(span<const T> values) noexcept {
+            size_type n = detail::copy_into(writable(values.size()), values);
+            _tail.store(_tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+            return n;
+        }
+
+    public:
+        // Consumer: data to read, reloading the producer position only when fewer than min
+        // elements are known. The result may understate what is stored.
+        ring_regions<T> readable(size_type min = 1) noexcept {
+            size_type head = _head.load(std::memory_order_relaxed);
+            if (_cached_tail - head < min) _cached_tail = _tail.load(std::memory_order_acquire);
+            return _storage.regions(head, _cached_tail - head);
+        }
+        // releases n elements read from readable() back to the producer
+        void consume(size_type n) {
+            size_type head = _head.load(std::memory_order_relaxed);
+            if (n > _cached_tail - head) throw std::length_error("spsc_ring_buffer: consume past the stored data");
+            _head.store(head + n, std::memory_order_release);
+        }
+
+        bool try_pop(T& value) noexcept {
+            size_type head = _head.load(std::memory_order_relaxed);
+            if (_cached_tail == head) {
+                _cached_tail = _tail.load(std::memory_order_acquire);
+                if (_cached_tail == head) return false;
+            }
+            value = _storage.data()[head & (capacity() - 1)];
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+        size_type pop(span<T> out) noexcept {
+            size_type n = detail::copy_from(readable(out.size()), out);
+            _head.store(_head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+            return n;
+        }
+    };
+} // namespace cpp17
+
+#endif //LIBCPP17_RING_BUFFER_HPP
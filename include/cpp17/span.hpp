@@ -18,15 +18,98 @@
 #define LIBCPP17_SPAN_HPP
 
 #include <array>
+#include <cassert>
 #include <cstddef>
 #include <iterator>
 #include <type_traits>
+#include <utility>
 
+#include <cpp17/cstddef.hpp>
 #include <cpp17/detail/dynamic_extent.hpp>
 #include <cpp17/detail/utility.hpp>
 
 namespace cpp17 {
+    namespace detail {
+        // U elements can be viewed as T elements only when that adds qualifiers, as in std::span
+        template <class U, class T>
+        using is_span_compatible = std::is_convertible<U (*)[], T (*)[]>;
+
+        template <class Container, class T, class = void>
+        struct is_span_container : std::false_type {
+        };
+        template <class Container, class T>
+        struct is_span_container<Container, T, decltype((void)cpp17::data(std::declval<Container&>()), (void)cpp17::size(std::declval<Container&>()))>
+                : is_span_compatible<typename std::remove_pointer<decltype(cpp17::data(std::declval<Container&>()))>::type, T> {
+        };
+
+        // element count known from the type alone, or dynamic_extent
+        template <class Container>
+        struct static_size : std::integral_constant<std::size_t, dynamic_extent> {
+        };
+        template <class T, std::size_t N>
+        struct static_size<T[N]> : std::integral_constant<std::size_t, N> {
+        };
+        template <class T, std::size_t N>
+        struct static_size<std::array<T, N>> : std::integral_constant<std::size_t, N> {
+        };
+
+        template <std::size_t Extent, std::size_t N>
+        struct is_extent_compatible : std::integral_constant<bool, Extent == dynamic_extent || N == dynamic_extent || N == Extent> {
+        };
+        // a run-time length becomes part of the type only on request, as in std::span
+        template <std::size_t Extent, std::size_t N>
+        struct is_explicit_extent : std::integral_constant<bool, Extent != dynamic_extent && N == dynamic_extent> {
+        };
+
+        // a static extent is part of the type, so only the pointer is stored
+        template <class T, std::size_t Extent>
+        class span_storage {
+        private:
+            T* _data;
+
+        public:
+            constexpr span_storage(T* data, std::size_t length) noexcept
+                    : _data((assert(length == Extent), data)) {
+            }
+
+            constexpr T* data() const noexcept {
+                return _data;
+            }
+            static constexpr std::size_t size() noexcept {
+                return Extent;
+            }
+        };
+
+        template <class T>
+        class span_storage<T, dynamic_extent> {
+        private:
+            T* _data;
+            std::size_t _length;
+
+        public:
+            constexpr span_storage(T* data, std::size_t length) noexcept
+                    : _data(data), _length(length) {
+            }
+
+            constexpr T* data() const noexcept {
+                return _data;
+            }
+            constexpr std::size_t size() const noexcept {
+                return _length;
+            }
+        };
+    } // namespace detail
+
     template <class T, std::size_t Extent = dynamic_extent>
+    class span;
+
+    namespace detail {
+        template <class T, std::size_t N>
+        struct static_size<span<T, N>> : std::integral_constant<std::size_t, N> {
+        };
+    } // namespace detail
+
+    template <class T, std::size_t Extent>
     class span {
     public:
         using element_type = T;
@@ -47,41 +130,56 @@ namespace cpp17 {
         static constexpr index_type extent = Extent;
 
     private:
-        const_pointer _data;
-        index_type _length;
+        detail::span_storage<element_type, Extent> _storage;
 
     public:
+        // only an empty span can be default constructed
+        template <std::size_t E = Extent, class = typename std::enable_if<E == 0 || E == dynamic_extent>::type>
         constexpr span() noexcept
-                : _data(nullptr), _length(0) {
+                : _storage(nullptr, 0) {
         }
-        constexpr span(const_pointer ptr, index_type count)
-                : _data(ptr), _length(count) {
+        // for a static extent, count must equal Extent
+        constexpr span(pointer ptr, index_type count)
+                : _storage(ptr, count) {
         }
-        constexpr span(const_pointer first, const_pointer last)
+        constexpr span(pointer first, pointer last)
                 : span(first, last - first) {
         }
 
-        template <std::size_t N>
+        template <std::size_t N, class = typename std::enable_if<Extent == dynamic_extent || N == Extent>::type>
         constexpr span(element_type (&a)[N]) noexcept
                 : span(a, N) {
         }
-        template <std::size_t N>
-        constexpr span(std::array<value_type, N>& arr)
-                : span(arr.data(), arr.size()) {
-        }
-        template <std::size_t N>
-        constexpr span(const std::array<value_type, N>& arr)
-                : span(arr.data(), arr.size()) {
-        }
 
-        template <class Container>
+        // covers std::array, std::vector, std::string and arrays of less qualified elements;
+        // a const container only binds to a span of const elements. A container without a static
+        // size converts to a static extent only explicitly, and its size must equal Extent.
+        template <class Container, typename std::enable_if<detail::is_span_container<Container, element_type>::value && detail::is_extent_compatible<Extent, detail::static_size<typename std::remove_const<Container>::type>::value>::value && !detail::is_explicit_extent<Extent, detail::static_size<typename std::remove_const<Container>::type>::value>::value, int>::type = 0>
         constexpr span(Container& c)
                 : span(cpp17::data(c), cpp17::size(c)) {
         }
-        template <class Container>
+        template <class Container, typename std::enable_if<detail::is_span_container<Container, element_type>::value && detail::is_explicit_extent<Extent, detail::static_size<typename std::remove_const<Container>::type>::value>::value, int>::type = 0>
+        explicit constexpr span(Container& c)
+                : span(cpp17::data(c), cpp17::size(c)) {
+        }
+        template <class Container, typename std::enable_if<detail::is_span_container<const Container, element_type>::value && detail::is_extent_compatible<Extent, detail::static_size<typename std::remove_const<Container>::type>::value>::value && !detail::is_explicit_extent<Extent, detail::static_size<typename std::remove_const<Container>::type>::value>::value, int>::type = 0>
         constexpr span(const Container& c)
                 : span(cpp17::data(c), cpp17::size(c)) {
         }
+        template <class Container, typename std::enable_if<detail::is_span_container<const Container, element_type>::value && detail::is_explicit_extent<Extent, detail::static_size<typename std::remove_const<Container>::type>::value>::value, int>::type = 0>
+        explicit constexpr span(const Container& c)
+                : span(cpp17::data(c), cpp17::size(c)) {
+        }
+
+        // span<T> -> span<const T>, and between static and dynamic extents
+        template <class U, std::size_t N, typename std::enable_if<detail::is_span_compatible<U, element_type>::value && detail::is_extent_compatible<Extent, N>::value && !detail::is_explicit_extent<Extent, N>::value, int>::type = 0>
+        constexpr span(const span<U, N>& s) noexcept
+                : span(s.data(), s.size()) {
+        }
+        template <class U, std::size_t N, typename std::enable_if<detail::is_span_compatible<U, element_type>::value && detail::is_explicit_extent<Extent, N>::value, int>::type = 0>
+        explicit constexpr span(const span<U, N>& s) noexcept
+                : span(s.data(), s.size()) {
+        }
 
         constexpr span(const span&) noexcept = default;
         constexpr span(span&&) noexcept = default;
@@ -94,6 +192,7 @@ namespace cpp17 {
     public:
         template <std::size_t Count>
         constexpr span<element_type, Count> first() const {
+            static_assert(Extent == dynamic_extent || Count <= Extent, "span::first: Count exceeds the extent");
             return {data(), Count};
         }
 
@@ -104,6 +203,7 @@ namespace cpp17 {
     public:
         template <std::size_t Count>
         constexpr span<element_type, Count> last() const {
+            static_assert(Extent == dynamic_extent || Count <= Extent, "span::last: Count exceeds the extent");
             return {data() + (size() - Count), Count};
         }
 
@@ -114,16 +214,18 @@ namespace cpp17 {
     public:
         template <std::size_t Offset, std::size_t Count = dynamic_extent>
         constexpr span<element_type, Count != dynamic_extent ? Count : (Extent != dynamic_extent ? Extent - Offset : dynamic_extent)> subspan() const {
+            static_assert(Extent == dynamic_extent || Offset <= Extent, "span::subspan: Offset exceeds the extent");
+            static_assert(Extent == dynamic_extent || Count == dynamic_extent || Count <= Extent - Offset, "span::subspan: Offset + Count exceeds the extent");
             return {data() + Offset, Count != dynamic_extent ? Count : size() - Offset};
         }
 
         constexpr span<element_type, dynamic_extent> subspan(index_type offset, index_type count = dynamic_extent) const {
-            return {data() + offset, count != dynamic_extent ? size() - offset : count};
+            return {data() + offset, count != dynamic_extent ? count : size() - offset};
         }
 
     public:
         constexpr index_type size() const noexcept {
-            return _length;
+            return _storage.size();
         }
         constexpr index_type size_bytes() const noexcept {
             return size() * sizeof(element_type);
@@ -133,24 +235,24 @@ namespace cpp17 {
         }
 
     public:
-        constexpr const_reference operator[](index_type i) const {
+        constexpr reference operator[](index_type i) const {
             return data()[i];
         }
-        constexpr const_reference front() const {
+        constexpr reference front() const {
             return (*this)[0];
         }
-        constexpr const_reference back() const {
+        constexpr reference back() const {
             return (*this)[size() - 1];
         }
-        constexpr const_pointer data() const noexcept {
-            return _data;
+        constexpr pointer data() const noexcept {
+            return _storage.data();
         }
 
     public:
-        constexpr const_iterator begin() const noexcept {
+        constexpr iterator begin() const noexcept {
             return data();
         }
-        constexpr const_iterator end() const noexcept {
+        constexpr iterator end() const noexcept {
             return data() + size();
         }
         constexpr const_iterator cbegin() const noexcept {
@@ -162,18 +264,34 @@ namespace cpp17 {
 
     public:
         constexpr reverse_iterator rbegin() const noexcept {
-            return std::reverse_iterator<iterator>(end());
+            return reverse_iterator(end());
         }
         constexpr reverse_iterator rend() const noexcept {
-            return std::reverse_iterator<iterator>(begin());
+            return reverse_iterator(begin());
         }
         constexpr const_reverse_iterator crbegin() const noexcept {
-            return std::reverse_iterator<const_iterator>(cend());
+            return const_reverse_iterator(cend());
         }
         constexpr const_reverse_iterator crend() const noexcept {
-            return std::reverse_iterator<const_iterator>(cbegin());
+            return const_reverse_iterator(cbegin());
         }
     };
+
+    namespace detail {
+        template <class T, std::size_t Extent>
+        struct bytes_extent : std::integral_constant<std::size_t, Extent == dynamic_extent ? dynamic_extent : Extent * sizeof(T)> {
+        };
+    } // namespace detail
+
+    // the object representation of the elements, without copying
+    template <class T, std::size_t Extent>
+    span<const byte, detail::bytes_extent<T, Extent>::value> as_bytes(span<T, Extent> s) noexcept {
+        return {reinterpret_cast<const byte*>(s.data()), s.size_bytes()};
+    }
+    template <class T, std::size_t Extent, class = typename std::enable_if<!std::is_const<T>::value>::type>
+    span<byte, detail::bytes_extent<T, Extent>::value> as_writable_bytes(span<T, Extent> s) noexcept {
+        return {reinterpret_cast<byte*>(s.data()), s.size_bytes()};
+    }
 } // namespace cpp17
 
 #endif //LIBCPP17_SPAN_HPP
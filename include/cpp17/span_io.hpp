@@ -0,0 +1,337 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_SPAN_IO_HPP
+#define LIBCPP17_SPAN_IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+#include "bit.hpp"
+#include "cstddef.hpp"
+#include "span.hpp"
+#include "string_view.hpp"
+
+namespace cpp17 {
+    namespace detail {
+        template <class T>
+        struct is_wire_type : std::integral_constant<bool, (std::is_arithmetic<T>::value || std::is_enum<T>::value) && !std::is_same<T, bool>::value> {
+        };
+
+        // unaligned load / store in the given byte order
+        template <class T, endian E>
+        T load(const byte* p) noexcept {
+            typename uint_of_size<sizeof(T)>::type u;
+            std::memcpy(&u, p, sizeof(T));
+            if (E != endian::native) u = bswap(u);
+            T v;
+            std::memcpy(&v, &u, sizeof(T));
+            return v;
+        }
+        template <class T, endian E>
+        void store(byte* p, T v) noexcept {
+            typename uint_of_size<sizeof(T)>::type u;
+            std::memcpy(&u, &v, sizeof(T));
+            if (E != endian::native) u = bswap(u);
+            std::memcpy(p, &u, sizeof(T));
+        }
+
+        template <class... Ts>
+        struct size_sum : std::integral_constant<std::size_t, 0> {
+        };
+        template <class T, class... Ts>
+        struct size_sum<T, Ts...> : std::integral_constant<std::size_t, sizeof(T) + size_sum<Ts...>::value> {
+        };
+
+        constexpr std::size_t max_varint_size = 10;
+
+        inline std::size_t varint_size(std::uint64_t v) noexcept {
+            std::size_t n = 1;
+            for (; v > 0x7f; v >>= 7) ++n;
+            return n;
+        }
+    } // namespace detail
+
+    // Sequential decoder over a byte buffer. Every read checks the bounds and throws std::out_of_range
+    // when the data runs out; require(n) checks once for a group of fields, which may then use the
+    // *_unchecked reads. Strings and sub-spans point into the buffer and are valid as long as it is.
+    template <endian Endian>
+    class basic_span_reader {
+    public:
+        static constexpr endian byte_order = Endian;
+
+    private:
+        const byte* _begin;
+        const byte* _p;
+        const byte* _end;
+
+    public:
+        constexpr basic_span_reader() noexcept
+                : _begin(nullptr), _p(nullptr), _end(nullptr) {
+        }
+        explicit constexpr basic_span_reader(span<const byte> data) noexcept
+                : _begin(data.data()), _p(data.data()), _end(data.data() + data.size()) {
+        }
+
+    public:
+        std::size_t position() const noexcept {
+            return static_cast<std::size_t>(_p - _begin);
+        }
+        std::size_t remaining() const noexcept {
+            return static_cast<std::size_t>(_end - _p);
+        }
+        bool empty() const noexcept {
+            return _p == _end;
+        }
+        span<const byte> remaining_bytes() const noexcept {
+            return {_p, remaining()};
+        }
+
+        void require(std::size_t n) const {
+            if (n > remaining()) throw std::out_of_range("span_reader: read past the end of the data");
+        }
+
+    public:
+        template <class T, endian E = Endian>
+        T read() {
+            static_assert(detail::is_wire_type<T>::value, "span_reader: T must be an arithmetic or enum type");
+            require(sizeof(T));
+            return read_unchecked<T, E>();
+        }
+        // the caller has already required sizeof(T) bytes
+        template <class T, endian E = Endian>
+        T read_unchecked() noexcept {
+            T v = detail::load<T, E>(_p);
+            _p += sizeof(T);
+            return v;
+        }
+
+        // a fixed group of fields with one bounds check
+        template <class... Ts>
+        std::tuple<Ts...> read_fields() {
+            require(detail::size_sum<Ts...>::value);
+            // braced initialization evaluates the reads left to right
+            return std::tuple<Ts...>{read_unchecked<Ts>()...};
+        }
+
+        // unsigned LEB128
+        template <class T = std::uint64_t>
+        T read_varint() {
+            static_assert(std::is_unsigned<T>::value, "span_reader::read_varint: T must be unsigned");
+            std::uint64_t v = _read_leb128(false);
+            if (v > std::numeric_limits<T>::max()) throw std::overflow_error("span_reader: varint does not fit the type");
+            return static_cast<T>(v);
+        }
+        // signed LEB128
+        template <class T = std::int64_t>
+        T read_signed_varint() {
+            static_assert(std::is_signed<T>::value && std::is_integral<T>::value, "span_reader::read_signed_varint: T must be a signed integer");
+            auto v = static_cast<std::int64_t>(_read_leb128(true));
+            if (v < std::numeric_limits<T>::min() || v > std::numeric_limits<T>::max()) throw std::overflow_error("span_reader: varint does not fit the type");
+            return static_cast<T>(v);
+        }
+
+        span<const byte> read_bytes(std::size_t n) {
+            require(n);
+            span<const byte> s(_p, n);
+            _p += n;
+            return s;
+        }
+        // a reader over the next n bytes
+        basic_span_reader read_reader(std::size_t n) {
+            return basic_span_reader(read_bytes(n));
+        }
+        string_view read_chars(std::size_t n) {
+            auto s = read_bytes(n);
+            return {reinterpret_cast<const char*>(s.data()), n};
+        }
+        // a string preceded by its length as a Length
+        template <class Length = std::uint32_t, endian E = Endian>
+        string_view read_string() {
+            static_assert(std::is_unsigned<Length>::value, "span_reader::read_string: Length must be unsigned");
+            return read_chars(_to_size(read<Length, E>()));
+        }
+        // a string preceded by its length as an unsigned varint
+        string_view read_varint_string() {
+            return read_chars(_to_size(read_varint()));
+        }
+
+        void skip(std::size_t n) {
+            require(n);
+            _p += n;
+        }
+
+    private:
+        template <class U>
+        std::size_t _to_size(U n) const {
+            if (static_cast<std::uint64_t>(n) > remaining()) throw std::out_of_range("span_reader: read past the end of the data");
+            return static_cast<std::size_t>(n);
+        }
+
+        // Decodes up to ten bytes, sign-extending from the last one for signed varints. The loop
+        // only checks the bounds when fewer than ten bytes are left.
+        std::uint64_t _read_leb128(bool is_signed) {
+            const byte* p = _p;
+            const byte* limit = remaining() >= detail::max_varint_size ? p + detail::max_varint_size : _end;
+            std::uint64_t v = 0;
+            unsigned shift = 0;
+            for (;;) {
+                if (p == limit) {
+                    if (limit == _end) throw std::out_of_range("span_reader: truncated varint");
+                    throw std::overflow_error("span_reader: varint longer than 64 bits");
+                }
+                auto b = to_integer<unsigned>(*p++);
+                // the tenth byte holds only bit 63, or its sign extension
+                if (shift == 63 && (is_signed ? b != 0 && b != 0x7f : b > 1)) {
+                    throw std::overflow_error("span_reader: varint longer than 64 bits");
+                }
+                v |= std::uint64_t(b & 0x7f) << shift;
+                shift += 7;
+                if ((b & 0x80) == 0) {
+                    if (is_signed && shift < 64 && (b & 0x40) != 0) v |= ~std::uint64_t(0) << shift;
+                    break;
+                }
+            }
+            _p = p;
+            return v;
+        }
+    };
+
+    // Sequential encoder into a fixed buffer; writes that do not fit throw std::length_error and
+    // leave the writer unchanged.
+    template <endian Endian>
+    class basic_span_writer {
+    public:
+        static constexpr endian byte_order = Endian;
+
+    private:
+        byte* _begin;
+        byte* _p;
+        byte* _end;
+
+    public:
+        constexpr basic_span_writer() noexcept
+                : _begin(nullptr), _p(nullptr), _end(nullptr) {
+        }
+        explicit constexpr basic_span_writer(span<byte> buffer) noexcept
+                : _begin(buffer.data()), _p(buffer.data()), _end(buffer.data() + buffer.size()) {
+        }
+
+    public:
+        std::size_t position() const noexcept {
+            return static_cast<std::size_t>(_p - _begin);
+        }
+        std::size_t remaining() const noexcept {
+            return static_cast<std::size_t>(_end - _p);
+        }
+        // everything written so far
+        span<byte> written() const noexcept {
+            return {_begin, position()};
+        }
+
+        void require(std::size_t n) const {
+            if (n > remaining()) throw std::length_error("span_writer: write past the end of the buffer");
+        }
+
+    public:
+        template <endian E = Endian, class T>
+        void write(T v) {
+            static_assert(detail::is_wire_type<T>::value, "span_writer: T must be an arithmetic or enum type");
+            require(sizeof(T));
+            write_unchecked<E>(v);
+        }
+        // the caller has already required sizeof(T) bytes
+        template <endian E = Endian, class T>
+        void write_unchecked(T v) noexcept {
+            detail::store<T, E>(_p, v);
+            _p += sizeof(T);
+        }
+
+        // a fixed group of fields with one bounds check
+        template <class... Ts>
+        void write_fields(Ts... values) {
+            require(detail::size_sum<Ts...>::value);
+            int order[] = {0, (write_unchecked(values), 0)...};
+            (void)order;
+        }
+
+        void write_varint(std::uint64_t v) {
+            byte buffer[detail::max_varint_size];
+            std::size_t n = 0;
+            do {
+                buffer[n++] = static_cast<byte>((v & 0x7f) | (v > 0x7f ? 0x80 : 0));
+                v >>= 7;
+            } while (v != 0);
+            write_bytes(span<const byte>(buffer, n));
+        }
+        void write_signed_varint(std::int64_t v) {
+            byte buffer[detail::max_varint_size];
+            std::size_t n = 0;
+            for (;;) {
+                auto b = static_cast<unsigned>(v & 0x7f);
+                // arithmetic shift keeps the sign
+                v = v < 0 ? ~(~v >> 7) : v >> 7;
+                bool done = (v == 0 && (b & 0x40) == 0) || (v == -1 && (b & 0x40) != 0);
+                buffer[n++] = static_cast<byte>(done ? b : b | 0x80);
+                if (done) break;
+            }
+            write_bytes(span<const byte>(buffer, n));
+        }
+
+        void write_bytes(span<const byte> bytes) {
+            require(bytes.size());
+            if (!bytes.empty()) std::memcpy(_p, bytes.data(), bytes.size());
+            _p += bytes.size();
+        }
+        void write_chars(string_view s) {
+            write_bytes(span<const byte>(reinterpret_cast<const byte*>(s.data()), s.size()));
+        }
+        template <class Length = std::uint32_t, endian E = Endian>
+        void write_string(string_view s) {
+            static_assert(std::is_unsigned<Length>::value, "span_writer::write_string: Length must be unsigned");
+            if (s.size() > std::numeric_limits<Length>::max()) throw std::length_error("span_writer: string too long for its length prefix");
+            require(sizeof(Length) + s.size());
+            write_unchecked<E>(static_cast<Length>(s.size()));
+            write_chars(s);
+        }
+        void write_varint_string(string_view s) {
+            require(detail::varint_size(s.size()) + s.size());
+            write_varint(s.size());
+            write_chars(s);
+        }
+
+        // the next n bytes, left as they are, for example to fill in a length once it is known
+        span<byte> skip(std::size_t n) {
+            require(n);
+            span<byte> s(_p, n);
+            _p += n;
+            return s;
+        }
+    };
+
+    using span_reader = basic_span_reader<endian::little>;
+    using span_writer = basic_span_writer<endian::little>;
+    using big_endian_span_reader = basic_span_reader<endian::big>;
+    using big_endian_span_writer = basic_span_writer<endian::big>;
+} // namespace cpp17
+
+#endif //LIBCPP17_SPAN_IO_HPP
@@ -0,0 +1,478 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_SPAN_VIEWS_HPP
+#define LIBCPP17_SPAN_VIEWS_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "span.hpp"
+
+namespace cpp17 {
+    namespace detail {
+        // Keeps the position as an index and forms the element address only when dereferenced,
+        // so the end iterator never points further than one past the last element.
+        template <class T>
+        class strided_iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = typename std::remove_cv<T>::type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+        private:
+            T* _base;
+            difference_type _index;
+            difference_type _stride;
+
+        public:
+            constexpr strided_iterator() noexcept
+                    : _base(nullptr), _index(0), _stride(1) {
+            }
+            constexpr strided_iterator(T* base, difference_type index, difference_type stride) noexcept
+                    : _base(base), _index(index), _stride(stride) {
+            }
+
+        public:
+            constexpr reference operator*() const noexcept {
+                return _base[_index * _stride];
+            }
+            constexpr pointer operator->() const noexcept {
+                return _base + _index * _stride;
+            }
+            constexpr reference operator[](difference_type n) const noexcept {
+                return _base[(_index + n) * _stride];
+            }
+
+            strided_iterator& operator++() noexcept {
+                ++_index;
+                return *this;
+            }
+            strided_iterator operator++(int) noexcept {
+                auto tmp = *this;
+                ++_index;
+                return tmp;
+            }
+            strided_iterator& operator--() noexcept {
+                --_index;
+                return *this;
+            }
+            strided_iterator operator--(int) noexcept {
+                auto tmp = *this;
+                --_index;
+                return tmp;
+            }
+            strided_iterator& operator+=(difference_type n) noexcept {
+                _index += n;
+                return *this;
+            }
+            strided_iterator& operator-=(difference_type n) noexcept {
+                _index -= n;
+                return *this;
+            }
+
+            friend strided_iterator operator+(strided_iterator it, difference_type n) noexcept {
+                return it += n;
+            }
+            friend strided_iterator operator+(difference_type n, strided_iterator it) noexcept {
+                return it += n;
+            }
+            friend strided_iterator operator-(strided_iterator it, difference_type n) noexcept {
+                return it -= n;
+            }
+            friend difference_type operator-(const strided_iterator& lhs, const strided_iterator& rhs) noexcept {
+                return lhs._index - rhs._index;
+            }
+
+            friend bool operator==(const strided_iterator& lhs, const strided_iterator& rhs) noexcept {
+                return lhs._index == rhs._index;
+            }
+            friend bool operator!=(const strided_iterator& lhs, const strided_iterator& rhs) noexcept {
+                return lhs._index != rhs._index;
+            }
+            friend bool operator<(const strided_iterator& lhs, const strided_iterator& rhs) noexcept {
+                return lhs._index < rhs._index;
+            }
+            friend bool operator>(const strided_iterator& lhs, const strided_iterator& rhs) noexcept {
+                return rhs < lhs;
+            }
+            friend bool operator<=(const strided_iterator& lhs, const strided_iterator& rhs) noexcept {
+                return !(rhs < lhs);
+            }
+            friend bool operator>=(const strided_iterator& lhs, const strided_iterator& rhs) noexcept {
+                return !(lhs < rhs);
+            }
+        };
+
+        // iterates a view by index; elements are sub-views returned by value
+        template <class View>
+        class view_iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = typename View::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+        private:
+            View _view;
+            std::size_t _index;
+
+        public:
+            constexpr view_iterator() noexcept
+                    : _view(), _index(0) {
+            }
+            constexpr view_iterator(const View& view, std::size_t index) noexcept
+                    : _view(view), _index(index) {
+            }
+
+        public:
+            constexpr reference operator*() const noexcept {
+                return _view[_index];
+            }
+            constexpr reference operator[](difference_type n) const noexcept {
+                return _view[_index + n];
+            }
+
+            view_iterator& operator++() noexcept {
+                ++_index;
+                return *this;
+            }
+            view_iterator operator++(int) noexcept {
+                auto tmp = *this;
+                ++_index;
+                return tmp;
+            }
+            view_iterator& operator--() noexcept {
+                --_index;
+                return *this;
+            }
+            view_iterator operator--(int) noexcept {
+                auto tmp = *this;
+                --_index;
+                return tmp;
+            }
+            view_iterator& operator+=(difference_type n) noexcept {
+                _index += n;
+                return *this;
+            }
+            view_iterator& operator-=(difference_type n) noexcept {
+                _index -= n;
+                return *this;
+            }
+
+            friend view_iterator operator+(view_iterator it, difference_type n) noexcept {
+                return it += n;
+            }
+            friend view_iterator operator+(difference_type n, view_iterator it) noexcept {
+                return it += n;
+            }
+            friend view_iterator operator-(view_iterator it, difference_type n) noexcept {
+                return it -= n;
+            }
+            friend difference_type operator-(const view_iterator& lhs, const view_iterator& rhs) noexcept {
+                return static_cast<difference_type>(lhs._index) - static_cast<difference_type>(rhs._index);
+            }
+
+            friend bool operator==(const view_iterator& lhs, const view_iterator& rhs) noexcept {
+                return lhs._index == rhs._index;
+            }
+            friend bool operator!=(const view_iterator& lhs, const view_iterator& rhs) noexcept {
+                return lhs._index != rhs._index;
+            }
+            friend bool operator<(const view_iterator& lhs, const view_iterator& rhs) noexcept {
+                return lhs._index < rhs._index;
+            }
+            friend bool operator>(const view_iterator& lhs, const view_iterator& rhs) noexcept {
+                return lhs._index > rhs._index;
+            }
+            friend bool operator<=(const view_iterator& lhs, const view_iterator& rhs) noexcept {
+                return lhs._index <= rhs._index;
+            }
+            friend bool operator>=(const view_iterator& lhs, const view_iterator& rhs) noexcept {
+                return lhs._index >= rhs._index;
+            }
+        };
+
+        inline std::size_t check_view_size(std::size_t n, const char* what) {
+            if (n == 0) throw std::invalid_argument(what);
+            return n;
+        }
+    } // namespace detail
+
+    // every stride-th element, starting at data
+    template <class T>
+    class strided_span {
+    public:
+        using element_type = T;
+        using value_type = typename std::remove_cv<T>::type;
+        using index_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = element_type*;
+        using reference = element_type&;
+
+        using iterator = detail::strided_iterator<T>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+
+    private:
+        pointer _data;
+        index_type _size;
+        index_type _stride;
+
+    public:
+        constexpr strided_span() noexcept
+                : _data(nullptr), _size(0), _stride(1) {
+        }
+        constexpr strided_span(pointer data, index_type count, index_type stride) noexcept
+                : _data(data), _size(count), _stride(stride) {
+        }
+
+        template <class U, std::size_t N, class = typename std::enable_if<detail::is_span_compatible<U, element_type>::value>::type>
+        constexpr strided_span(const span<U, N>& s) noexcept
+                : strided_span(s.data(), s.size(), 1) {
+        }
+        template <class U, class = typename std::enable_if<detail::is_span_compatible<U, element_type>::value>::type>
+        constexpr strided_span(const strided_span<U>& s) noexcept
+                : strided_span(s.data(), s.size(), s.stride()) {
+        }
+
+    public:
+        constexpr index_type size() const noexcept {
+            return _size;
+        }
+        constexpr index_type stride() const noexcept {
+            return _stride;
+        }
+        constexpr bool empty() const noexcept {
+            return _size == 0;
+        }
+
+    public:
+        constexpr reference operator[](index_type i) const {
+            return _data[i * _stride];
+        }
+        constexpr reference front() const {
+            return _data[0];
+        }
+        constexpr reference back() const {
+            return (*this)[_size - 1];
+        }
+        constexpr pointer data() const noexcept {
+            return _data;
+        }
+
+    public:
+        constexpr strided_span first(index_type count) const {
+            return {_data, count, _stride};
+        }
+        constexpr strided_span last(index_type count) const {
+            return {at(_size - count), count, _stride};
+        }
+        constexpr strided_span subspan(index_type offset, index_type count = dynamic_extent) const {
+            return {at(offset), count != dynamic_extent ? count : _size - offset, _stride};
+        }
+
+    public:
+        constexpr iterator begin() const noexcept {
+            return iterator(_data, 0, static_cast<difference_type>(_stride));
+        }
+        constexpr iterator end() const noexcept {
+            return iterator(_data, static_cast<difference_type>(_size), static_cast<difference_type>(_stride));
+        }
+        constexpr reverse_iterator rbegin() const noexcept {
+            return reverse_iterator(end());
+        }
+        constexpr reverse_iterator rend() const noexcept {
+            return reverse_iterator(begin());
+        }
+
+    private:
+        // element i, or one past the last element for i == size()
+        constexpr pointer at(index_type i) const noexcept {
+            return i < _size ? _data + i * _stride : _size != 0 ? &back() + 1 : _data;
+        }
+    };
+
+    // Consecutive chunks of a span. With a dynamic chunk size the last chunk may be shorter;
+    // with a static one every chunk is a span<T, N> and the leftover elements are in remainder().
+    template <class T, std::size_t N = dynamic_extent>
+    class chunk_view {
+    public:
+        using value_type = span<T, N>;
+        using size_type = std::size_t;
+        using iterator = detail::view_iterator<chunk_view>;
+
+    private:
+        span<T> _data;
+        size_type _chunk;
+
+    public:
+        constexpr chunk_view() noexcept
+                : _data(), _chunk(N != dynamic_extent ? N : 1) {
+        }
+        constexpr chunk_view(span<T> data, size_type chunk) noexcept
+                : _data(data), _chunk(chunk) {
+        }
+
+    public:
+        constexpr size_type size() const noexcept {
+            return N != dynamic_extent ? _data.size() / N : (_data.size() + _chunk - 1) / _chunk;
+        }
+        constexpr bool empty() const noexcept {
+            return size() == 0;
+        }
+        constexpr size_type chunk_size() const noexcept {
+            return N != dynamic_extent ? N : _chunk;
+        }
+
+        constexpr value_type operator[](size_type i) const {
+            return {_data.data() + i * chunk_size(), N != dynamic_extent ? N : (i + 1 < size() ? _chunk : _data.size() - i * _chunk)};
+        }
+        constexpr span<T> remainder() const {
+            return _data.subspan(size() * chunk_size() < _data.size() ? size() * chunk_size() : _data.size());
+        }
+
+        constexpr iterator begin() const noexcept {
+            return iterator(*this, 0);
+        }
+        constexpr iterator end() const noexcept {
+            return iterator(*this, size());
+        }
+    };
+
+    // every run of consecutive elements of the window size, each starting one element after the previous
+    template <class T, std::size_t N = dynamic_extent>
+    class window_view {
+    public:
+        using value_type = span<T, N>;
+        using size_type = std::size_t;
+        using iterator = detail::view_iterator<window_view>;
+
+    private:
+        span<T> _data;
+        size_type _window;
+
+    public:
+        constexpr window_view() noexcept
+                : _data(), _window(N != dynamic_extent ? N : 1) {
+        }
+        constexpr window_view(span<T> data, size_type window) noexcept
+                : _data(data), _window(window) {
+        }
+
+    public:
+        constexpr size_type size() const noexcept {
+            return _data.size() >= window_size() ? _data.size() - window_size() + 1 : 0;
+        }
+        constexpr bool empty() const noexcept {
+            return size() == 0;
+        }
+        constexpr size_type window_size() const noexcept {
+            return N != dynamic_extent ? N : _window;
+        }
+
+        constexpr value_type operator[](size_type i) const {
+            return {_data.data() + i, window_size()};
+        }
+
+        constexpr iterator begin() const noexcept {
+            return iterator(*this, 0);
+        }
+        constexpr iterator end() const noexcept {
+            return iterator(*this, size());
+        }
+    };
+
+    // The channels of interleaved frames [c0 c1 ... ck-1 c0 c1 ...]: channel c is a strided_span
+    // over every k-th element starting at c. A trailing partial frame belongs to no channel.
+    template <class T>
+    class interleaved_view {
+    public:
+        using value_type = strided_span<T>;
+        using size_type = std::size_t;
+        using iterator = detail::view_iterator<interleaved_view>;
+
+    private:
+        span<T> _data;
+        size_type _channels;
+
+    public:
+        constexpr interleaved_view() noexcept
+                : _data(), _channels(1) {
+        }
+        constexpr interleaved_view(span<T> data, size_type channels) noexcept
+                : _data(data), _channels(channels) {
+        }
+
+    public:
+        constexpr size_type size() const noexcept {
+            return _channels;
+        }
+        constexpr bool empty() const noexcept {
+            return _channels == 0;
+        }
+        constexpr size_type frames() const noexcept {
+            return _data.size() / _channels;
+        }
+
+        constexpr value_type operator[](size_type channel) const {
+            return {_data.data() + channel, frames(), _channels};
+        }
+        // frame i as a contiguous span of one element per channel
+        constexpr span<T> frame(size_type i) const {
+            return _data.subspan(i * _channels, _channels);
+        }
+
+        constexpr iterator begin() const noexcept {
+            return iterator(*this, 0);
+        }
+        constexpr iterator end() const noexcept {
+            return iterator(*this, size());
+        }
+    };
+
+    template <class T, std::size_t Extent>
+    chunk_view<T> chunks(span<T, Extent> s, std::size_t n) {
+        return {s, detail::check_view_size(n, "cpp17::chunks: chunk size must not be zero")};
+    }
+    template <std::size_t N, class T, std::size_t Extent>
+    chunk_view<T, N> chunks(span<T, Extent> s) noexcept {
+        static_assert(N != 0 && N != dynamic_extent, "cpp17::chunks: invalid chunk size");
+        return {s, N};
+    }
+
+    template <class T, std::size_t Extent>
+    window_view<T> windows(span<T, Extent> s, std::size_t n) {
+        return {s, detail::check_view_size(n, "cpp17::windows: window size must not be zero")};
+    }
+    template <std::size_t N, class T, std::size_t Extent>
+    window_view<T, N> windows(span<T, Extent> s) noexcept {
+        static_assert(N != 0 && N != dynamic_extent, "cpp17::windows: invalid window size");
+        return {s, N};
+    }
+
+    template <class T, std::size_t Extent>
+    interleaved_view<T> interleaved(span<T, Extent> s, std::size_t channels) {
+        return {s, detail::check_view_size(channels, "cpp17::interleaved: channel count must not be zero")};
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_SPAN_VIEWS_HPP
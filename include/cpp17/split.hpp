@@ -0,0 +1,249 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_SPLIT_HPP
+#define LIBCPP17_SPLIT_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "detail/string_search.hpp"
+#include "string_view.hpp"
+
+namespace cpp17 {
+    namespace detail {
+        template <class S>
+        using view_of = decltype(as_string_view(std::declval<const S&>()));
+
+        namespace split {
+            // a delimiter finds its next occurrence at or after pos and reports its length;
+            // trim() post-processes every piece and drop_trailing_empty suppresses a final empty piece
+            template <class CharT, class Traits>
+            struct char_delimiter {
+                using view_type = basic_string_view<CharT, Traits>;
+                static constexpr bool drop_trailing_empty = false;
+
+                CharT c;
+
+                std::size_t find(view_type text, std::size_t pos) const noexcept {
+                    return text.find(c, pos);
+                }
+                std::size_t length() const noexcept {
+                    return 1;
+                }
+                static view_type trim(view_type piece) noexcept {
+                    return piece;
+                }
+            };
+
+            template <class CharT, class Traits>
+            struct string_delimiter {
+                using view_type = basic_string_view<CharT, Traits>;
+                static constexpr bool drop_trailing_empty = false;
+
+                view_type s;
+
+                std::size_t find(view_type text, std::size_t pos) const noexcept {
+                    return text.find(s, pos);
+                }
+                std::size_t length() const noexcept {
+                    return s.size();
+                }
+                static view_type trim(view_type piece) noexcept {
+                    return piece;
+                }
+            };
+
+            // the membership table is built once per range rather than once per field
+            template <class CharT, class Traits>
+            struct any_delimiter {
+                using view_type = basic_string_view<CharT, Traits>;
+                static constexpr bool drop_trailing_empty = false;
+
+                char_set<Traits> set;
+
+                std::size_t find(view_type text, std::size_t pos) const noexcept {
+                    const CharT* p = text.data();
+                    for (std::size_t i = pos, n = text.size(); i < n; ++i) {
+                        if (set.contains(p[i])) return i;
+                    }
+                    return view_type::npos;
+                }
+                std::size_t length() const noexcept {
+                    return 1;
+                }
+                static view_type trim(view_type piece) noexcept {
+                    return piece;
+                }
+            };
+
+            // '\n' separated lines with an optional '\r' before the '\n'; a final newline does not start an empty line
+            template <class CharT, class Traits>
+            struct line_delimiter {
+                using view_type = basic_string_view<CharT, Traits>;
+                static constexpr bool drop_trailing_empty = true;
+
+                std::size_t find(view_type text, std::size_t pos) const noexcept {
+                    return text.find(CharT('\n'), pos);
+                }
+                std::size_t length() const noexcept {
+                    return 1;
+                }
+                static view_type trim(view_type piece) noexcept {
+                    return piece.ends_with(CharT('\r')) ? piece.substr(0, piece.size() - 1) : piece;
+                }
+            };
+        } // namespace split
+    }     // namespace detail
+
+    template <class CharT, class Traits, class Delimiter>
+    class basic_split_range {
+    public:
+        using view_type = basic_string_view<CharT, Traits>;
+        using size_type = typename view_type::size_type;
+
+        static constexpr size_type npos = view_type::npos;
+
+    private:
+        view_type _text;
+        Delimiter _delimiter;
+        size_type _max_splits;
+        bool _skip_empty;
+
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = view_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const view_type*;
+            using reference = const view_type&;
+
+        private:
+            const basic_split_range* _range;
+            view_type _piece;
+            size_type _next;
+            size_type _splits;
+
+        public:
+            iterator() noexcept
+                    : _range(nullptr), _piece(), _next(npos), _splits(0) {
+            }
+            explicit iterator(const basic_split_range* range) noexcept
+                    : _range(range), _piece(), _next(0), _splits(0) {
+                _advance();
+            }
+
+        private:
+            void _advance() noexcept {
+                const view_type& text = _range->_text;
+                while (_next != npos) {
+                    size_type at = _splits < _range->_max_splits ? _range->_delimiter.find(text, _next) : npos;
+                    if (at == npos) {
+                        _piece = Delimiter::trim(text.substr(_next));
+                        _next = npos;
+                        if (_piece.empty() && (_range->_skip_empty || Delimiter::drop_trailing_empty)) break;
+                        return;
+                    }
+                    _piece = Delimiter::trim(text.substr(_next, at - _next));
+                    _next = at + _range->_delimiter.length();
+                    if (_piece.empty() && _range->_skip_empty) continue;
+                    ++_splits;
+                    return;
+                }
+                _range = nullptr;
+            }
+
+        public:
+            reference operator*() const noexcept {
+                return _piece;
+            }
+            pointer operator->() const noexcept {
+                return &_piece;
+            }
+
+            iterator& operator++() noexcept {
+                _advance();
+                return *this;
+            }
+            iterator operator++(int) noexcept {
+                auto tmp = *this;
+                _advance();
+                return tmp;
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept {
+                return lhs._range == rhs._range && (lhs._range == nullptr || (lhs._piece.data() == rhs._piece.data() && lhs._next == rhs._next));
+            }
+            friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept {
+                return !(lhs == rhs);
+            }
+        };
+
+    public:
+        basic_split_range(view_type text, Delimiter delimiter, size_type max_splits = npos, bool skip_empty = false) noexcept
+                : _text(text), _delimiter(delimiter), _max_splits(max_splits), _skip_empty(skip_empty) {
+        }
+
+    public:
+        iterator begin() const noexcept {
+            return iterator(this);
+        }
+        iterator end() const noexcept {
+            return iterator();
+        }
+
+    public:
+        // the returned range omits empty pieces; they do not count towards max_splits
+        basic_split_range skip_empty() const noexcept {
+            return basic_split_range(_text, _delimiter, _max_splits, true);
+        }
+        // at most n splits, so at most n + 1 pieces; the last piece is the unsplit remainder
+        basic_split_range max_splits(size_type n) const noexcept {
+            return basic_split_range(_text, _delimiter, n, _skip_empty);
+        }
+    };
+
+    template <class S, class V = detail::view_of<S>>
+    basic_split_range<typename V::value_type, typename V::traits_type, detail::split::char_delimiter<typename V::value_type, typename V::traits_type>>
+    split(const S& text, typename V::value_type delimiter) noexcept {
+        return {detail::as_string_view(text), {delimiter}};
+    }
+
+    template <class S, class V = detail::view_of<S>>
+    basic_split_range<typename V::value_type, typename V::traits_type, detail::split::string_delimiter<typename V::value_type, typename V::traits_type>>
+    split(const S& text, detail::view_of<S> delimiter) {
+        if (delimiter.empty()) throw std::invalid_argument("cpp17::split: empty delimiter");
+        return {detail::as_string_view(text), {delimiter}};
+    }
+
+    // splits at any character of the set
+    template <class S, class V = detail::view_of<S>>
+    basic_split_range<typename V::value_type, typename V::traits_type, detail::split::any_delimiter<typename V::value_type, typename V::traits_type>>
+    split_any(const S& text, detail::view_of<S> set) noexcept {
+        return {detail::as_string_view(text), {detail::char_set<typename V::traits_type>(set.data(), set.size())}};
+    }
+
+    template <class S, class V = detail::view_of<S>>
+    basic_split_range<typename V::value_type, typename V::traits_type, detail::split::line_delimiter<typename V::value_type, typename V::traits_type>>
+    lines(const S& text) noexcept {
+        return {detail::as_string_view(text), {}};
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_SPLIT_HPP
@@ -0,0 +1,478 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_STRING_POOL_HPP
+#define LIBCPP17_STRING_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#include "memory_resource.hpp"
+#include "optional.hpp"
+#include "string_view.hpp"
+
+namespace cpp17 {
+    class interned_string;
+
+    namespace detail {
+        // Every interned string is stored as [uint32 id][uint32 size][bytes]['\0'] in the pool's arena;
+        // an interned_string points at the bytes and finds its id and size just before them.
+        constexpr std::size_t interned_header_size = 8;
+
+        inline const char* empty_interned() noexcept {
+            alignas(4) static const char storage[interned_header_size + 1] = {};
+            return storage + interned_header_size;
+        }
+
+        inline std::uint32_t interned_field(const char* data, std::size_t offset) noexcept {
+            std::uint32_t v;
+            std::memcpy(&v, data - interned_header_size + offset, sizeof(v));
+            return v;
+        }
+
+        // passes everything to the upstream resource and keeps a running total of live bytes
+        class counting_resource final : public pmr::memory_resource {
+        private:
+            pmr::memory_resource* _upstream;
+            std::size_t _bytes;
+
+        public:
+            explicit counting_resource(pmr::memory_resource* upstream) noexcept
+                    : _upstream(upstream), _bytes(0) {
+            }
+
+        public:
+            std::size_t bytes() const noexcept {
+                return _bytes;
+            }
+            pmr::memory_resource* upstream_resource() const noexcept {
+                return _upstream;
+            }
+
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                void* p = _upstream->allocate(bytes, alignment);
+                _bytes += bytes;
+                return p;
+            }
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+                _upstream->deallocate(p, bytes, alignment);
+                _bytes -= bytes;
+            }
+            bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+        class intern_table;
+    } // namespace detail
+
+    // A string owned by a string_pool. Equal contents interned into the same pool share storage,
+    // so comparison and hashing only look at the pointer. The characters are NUL-terminated.
+    class interned_string {
+        friend class detail::intern_table;
+
+    private:
+        const char* _data;
+
+        explicit interned_string(const char* data) noexcept
+                : _data(data) {
+        }
+
+    public:
+        // the empty string, equal to the empty string interned into any pool
+        interned_string() noexcept
+                : _data(detail::empty_interned()) {
+        }
+
+    public:
+        const char* data() const noexcept {
+            return _data;
+        }
+        const char* c_str() const noexcept {
+            return _data;
+        }
+        std::size_t size() const noexcept {
+            return detail::interned_field(_data, 4);
+        }
+        std::size_t length() const noexcept {
+            return size();
+        }
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        // the symbol id handed out by the owning pool
+        std::uint32_t id() const noexcept {
+            return detail::interned_field(_data, 0);
+        }
+
+        string_view view() const noexcept {
+            return string_view(_data, size());
+        }
+        operator string_view() const noexcept {
+            return view();
+        }
+
+    public:
+        friend bool operator==(interned_string lhs, interned_string rhs) noexcept {
+            return lhs._data == rhs._data;
+        }
+        friend bool operator!=(interned_string lhs, interned_string rhs) noexcept {
+            return lhs._data != rhs._data;
+        }
+    };
+
+    struct string_pool_statistics {
+        std::size_t strings = 0;      // distinct non-empty strings stored
+        std::size_t string_bytes = 0; // their total length
+        std::size_t arena_bytes = 0;  // taken from the upstream resource for string storage and the id index
+        std::size_t table_bytes = 0;  // taken from the upstream resource for the hash table
+        std::size_t interns = 0;      // calls to intern and intern_id
+        std::size_t hits = 0;         // of those, answered with a string already in the pool
+    };
+
+    namespace detail {
+        // Open-addressing (linear probing) hash set of arena-stored strings plus an id -> string index.
+        // Local index 0 is the empty string; the id stored with a string is (index << shift) | tag so
+        // that sharded pools can hand out ids that are unique across shards.
+        class intern_table {
+        private:
+            struct _slot {
+                std::uint64_t hash;
+                const char* data;
+            };
+
+            // the id index grows by adding segments of doubling size, so entries never move and can be
+            // read without holding the lock that guards insertion
+            static constexpr int _first_segment_bits = 8;
+            static constexpr int _segment_count = 32;
+
+            counting_resource _counter;
+            pmr::monotonic_buffer_resource _arena;
+            _slot* _slots;
+            std::size_t _capacity;
+            const char** _segments[_segment_count];
+            std::uint32_t _count;
+            int _shift;
+            std::uint32_t _tag;
+            std::size_t _string_bytes;
+            std::size_t _interns;
+            std::size_t _hits;
+
+        public:
+            intern_table(pmr::memory_resource* upstream, int shift, std::uint32_t tag)
+                    : _counter(upstream), _arena(4096, &_counter), _slots(nullptr), _capacity(0), _segments(), _count(1), _shift(shift), _tag(tag), _string_bytes(0), _interns(0), _hits(0) {
+                _segments[0] = static_cast<const char**>(_arena.allocate(sizeof(const char*) << _first_segment_bits, alignof(const char*)));
+                _segments[0][0] = empty_interned();
+            }
+
+            intern_table(const intern_table&) = delete;
+            intern_table& operator=(const intern_table&) = delete;
+
+            ~intern_table() {
+                if (_slots != nullptr) {
+                    _counter.upstream_resource()->deallocate(_slots, _capacity * sizeof(_slot), alignof(_slot));
+                }
+            }
+
+        public:
+            static std::uint64_t hash(string_view s) noexcept {
+                return hash_bytes(s.data(), s.size());
+            }
+
+            interned_string intern(string_view s, std::uint64_t h) {
+                ++_interns;
+                if (s.empty()) {
+                    ++_hits;
+                    return interned_string();
+                }
+                if (_capacity != 0) {
+                    std::size_t i = _probe(s, h);
+                    if (_slots[i].data != nullptr) {
+                        ++_hits;
+                        return interned_string(_slots[i].data);
+                    }
+                    if ((_count + 1) * 2 <= _capacity) {
+                        _slots[i] = _slot{h, _insert(s)};
+                        return interned_string(_slots[i].data);
+                    }
+                }
+                _rehash(_capacity == 0 ? 64 : _capacity * 2);
+                const char* data = _insert(s);
+                _slots[_probe(s, h)] = _slot{h, data};
+                return interned_string(data);
+            }
+
+            cpp17::optional<interned_string> find(string_view s, std::uint64_t h) const noexcept {
+                if (s.empty()) return interned_string();
+                if (_capacity == 0) return nullopt;
+                const _slot& slot = _slots[_probe(s, h)];
+                if (slot.data == nullptr) return nullopt;
+                return interned_string(slot.data);
+            }
+
+            // requires index < size()
+            interned_string at(std::uint32_t index) const noexcept {
+                int k;
+                std::size_t offset = _locate(index, k);
+                return interned_string(_segments[k][offset]);
+            }
+
+            std::size_t size() const noexcept {
+                return _count;
+            }
+
+            void reserve(std::size_t n) {
+                std::size_t capacity = _capacity == 0 ? 64 : _capacity;
+                while (capacity < n * 2) capacity *= 2;
+                if (capacity != _capacity) _rehash(capacity);
+            }
+
+            void add_to(string_pool_statistics& stats) const noexcept {
+                stats.strings += _count - 1;
+                stats.string_bytes += _string_bytes;
+                stats.arena_bytes += _counter.bytes();
+                stats.table_bytes += _capacity * sizeof(_slot);
+                stats.interns += _interns;
+                stats.hits += _hits;
+            }
+
+        private:
+            // segment k holds indices [2^b (2^k - 1), 2^b (2^(k + 1) - 1)) for b = _first_segment_bits
+            static std::size_t _locate(std::uint32_t index, int& k) noexcept {
+                std::uint64_t v = std::uint64_t(index) + (std::uint64_t(1) << _first_segment_bits);
+                k = 0;
+                while ((v >> (k + _first_segment_bits + 1)) != 0) ++k;
+                return static_cast<std::size_t>(v - (std::uint64_t(1) << (k + _first_segment_bits)));
+            }
+
+            // the slot holding s, or the empty slot where it belongs
+            std::size_t _probe(string_view s, std::uint64_t h) const noexcept {
+                std::size_t mask = _capacity - 1;
+                for (std::size_t i = static_cast<std::size_t>(h) & mask;; i = (i + 1) & mask) {
+                    const _slot& slot = _slots[i];
+                    if (slot.data == nullptr) return i;
+                    if (slot.hash == h && interned_field(slot.data, 4) == s.size() && std::memcmp(slot.data, s.data(), s.size()) == 0) return i;
+                }
+            }
+
+            const char* _insert(string_view s) {
+                if (s.size() > UINT32_MAX) {
+                    throw std::length_error("string_pool: string too long to intern");
+                }
+                if (_count > (UINT32_MAX >> _shift)) {
+                    throw std::length_error("string_pool: symbol ids exhausted");
+                }
+                std::uint32_t index = _count;
+                int k;
+                std::size_t offset = _locate(index, k);
+                if (offset == 0) {
+                    _segments[k] = static_cast<const char**>(_arena.allocate(sizeof(const char*) << (k + _first_segment_bits), alignof(const char*)));
+                }
+
+                auto p = static_cast<char*>(_arena.allocate(interned_header_size + s.size() + 1, 4));
+                std::uint32_t header[2] = {(index << _shift) | _tag, static_cast<std::uint32_t>(s.size())};
+                std::memcpy(p, header, interned_header_size);
+                std::memcpy(p + interned_header_size, s.data(), s.size());
+                p[interned_header_size + s.size()] = '\0';
+
+                const char* data = p + interned_header_size;
+                _segments[k][offset] = data;
+                ++_count;
+                _string_bytes += s.size();
+                return data;
+            }
+
+            void _rehash(std::size_t capacity) {
+                pmr::memory_resource* upstream = _counter.upstream_resource();
+                auto slots = static_cast<_slot*>(upstream->allocate(capacity * sizeof(_slot), alignof(_slot)));
+                for (std::size_t i = 0; i < capacity; ++i) slots[i] = _slot{0, nullptr};
+                std::size_t mask = capacity - 1;
+                for (std::size_t j = 0; j < _capacity; ++j) {
+                    if (_slots[j].data == nullptr) continue;
+                    std::size_t i = static_cast<std::size_t>(_slots[j].hash) & mask;
+                    while (slots[i].data != nullptr) i = (i + 1) & mask;
+                    slots[i] = _slots[j];
+                }
+                if (_slots != nullptr) {
+                    upstream->deallocate(_slots, _capacity * sizeof(_slot), alignof(_slot));
+                }
+                _slots = slots;
+                _capacity = capacity;
+            }
+        };
+    } // namespace detail
+
+    // Deduplicating intern table: every distinct string is copied once into an arena and stays valid,
+    // at the same address, for the lifetime of the pool. Symbol ids are dense, starting with 0 for "".
+    class string_pool {
+    public:
+        using symbol = std::uint32_t;
+
+    private:
+        detail::intern_table _table;
+
+    public:
+        explicit string_pool(pmr::memory_resource* upstream)
+                : _table(upstream, 0, 0) {
+        }
+        string_pool()
+                : string_pool(pmr::get_default_resource()) {
+        }
+
+        string_pool(const string_pool&) = delete;
+        string_pool& operator=(const string_pool&) = delete;
+
+    public:
+        interned_string intern(string_view s) {
+            return _table.intern(s, detail::intern_table::hash(s));
+        }
+        symbol intern_id(string_view s) {
+            return intern(s).id();
+        }
+
+        optional<interned_string> find(string_view s) const noexcept {
+            return _table.find(s, detail::intern_table::hash(s));
+        }
+        bool contains(string_view s) const noexcept {
+            return find(s).has_value();
+        }
+
+        // requires id < size()
+        interned_string operator[](symbol id) const noexcept {
+            return _table.at(id);
+        }
+
+        // number of ids handed out, including 0 for the empty string
+        std::size_t size() const noexcept {
+            return _table.size();
+        }
+        // size the hash table for n distinct strings
+        void reserve(std::size_t n) {
+            _table.reserve(n);
+        }
+
+        string_pool_statistics stats() const noexcept {
+            string_pool_statistics s;
+            _table.add_to(s);
+            return s;
+        }
+    };
+
+    // string_pool for many producer threads: strings are spread over independently locked shards by
+    // hash. Ids are unique across the pool but not dense; operator[] takes no lock, so the id must have
+    // reached the reading thread through the intern call itself or some other synchronization.
+    class concurrent_string_pool {
+    public:
+        using symbol = std::uint32_t;
+
+    private:
+        static constexpr int _shard_bits = 4;
+        static constexpr std::size_t _shard_count = std::size_t(1) << _shard_bits;
+
+        struct _shard {
+            std::mutex mutex;
+            std::unique_ptr<detail::intern_table> table;
+            char padding[64];
+        };
+
+        std::unique_ptr<_shard[]> _shards;
+
+        // the top bits pick the shard, the low bits the slot within it
+        _shard& _select(std::uint64_t h) const noexcept {
+            return _shards[static_cast<std::size_t>(h >> (64 - _shard_bits))];
+        }
+
+    public:
+        explicit concurrent_string_pool(pmr::memory_resource* upstream)
+                : _shards(new _shard[_shard_count]) {
+            for (std::size_t i = 0; i < _shard_count; ++i) {
+                _shards[i].table.reset(new detail::intern_table(upstream, _shard_bits, static_cast<std::uint32_t>(i)));
+            }
+        }
+        concurrent_string_pool()
+                : concurrent_string_pool(pmr::get_default_resource()) {
+        }
+
+        concurrent_string_pool(const concurrent_string_pool&) = delete;
+        concurrent_string_pool& operator=(const concurrent_string_pool&) = delete;
+
+    public:
+        interned_string intern(string_view s) {
+            std::uint64_t h = detail::intern_table::hash(s);
+            _shard& shard = _select(h);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.table->intern(s, h);
+        }
+        symbol intern_id(string_view s) {
+            return intern(s).id();
+        }
+
+        optional<interned_string> find(string_view s) const {
+            std::uint64_t h = detail::intern_table::hash(s);
+            _shard& shard = _select(h);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.table->find(s, h);
+        }
+        bool contains(string_view s) const {
+            return find(s).has_value();
+        }
+
+        // requires an id handed out by this pool
+        interned_string operator[](symbol id) const noexcept {
+            return _shards[id & (_shard_count - 1)].table->at(id >> _shard_bits);
+        }
+
+        // number of distinct strings, including the empty string
+        std::size_t size() const {
+            return stats().strings + 1;
+        }
+        // size the hash tables for n distinct strings spread evenly over the shards
+        void reserve(std::size_t n) {
+            for (std::size_t i = 0; i < _shard_count; ++i) {
+                std::lock_guard<std::mutex> lock(_shards[i].mutex);
+                _shards[i].table->reserve(n / _shard_count + 1);
+            }
+        }
+
+        string_pool_statistics stats() const {
+            string_pool_statistics s;
+            for (std::size_t i = 0; i < _shard_count; ++i) {
+                std::lock_guard<std::mutex> lock(_shards[i].mutex);
+                _shards[i].table->add_to(s);
+            }
+            return s;
+        }
+    };
+} // namespace cpp17
+
+namespace std {
+    template <>
+    struct hash<cpp17::interned_string> {
+        std::size_t operator()(cpp17::interned_string s) const noexcept {
+            return std::hash<const char*>()(s.data());
+        }
+    };
+} // namespace std
+
+#endif //LIBCPP17_STRING_POOL_HPP
@@ -16,11 +16,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 
+#include <cpp17/detail/ascii.hpp>
+#include <cpp17/detail/hash.hpp>
 #include <cpp17/detail/only.hpp>
+#include <cpp17/detail/string_search.hpp>
 
 namespace cpp17 {
     template <class CharT, class Traits = std::char_traits<CharT>>
@@ -46,6 +52,16 @@ namespace cpp17 {
         const_pointer _first;
         size_type _length;
 
+        static constexpr size_type _constexpr_length(const_pointer str, size_type n) noexcept {
+            return traits_type::eq(str[n], CharT()) ? n : _constexpr_length(str, n + 1);
+        }
+        static constexpr size_type _length_of(const char* str, std::true_type) noexcept {
+            return __builtin_strlen(str);
+        }
+        static constexpr size_type _length_of(const_pointer str, std::false_type) noexcept {
+            return CPP17_IS_CONSTANT_EVALUATED() ? _constexpr_length(str, 0) : traits_type::length(str);
+        }
+
     public:
         constexpr basic_string_view() noexcept
                 : _first(nullptr), _length(0) {
@@ -53,7 +69,7 @@ namespace cpp17 {
         constexpr basic_string_view(const basic_string_view&) noexcept = default;
         constexpr basic_string_view(basic_string_view&&) noexcept = default;
         constexpr basic_string_view(const_pointer str) noexcept
-                : _first(str), _length(__builtin_strlen(str)) {
+                : _first(str), _length(_length_of(str, std::is_same<CharT, char>())) {
         }
         constexpr basic_string_view(const_pointer str, size_type len) noexcept
                 : _first(str), _length(len) {
@@ -217,12 +233,23 @@ namespace cpp17 {
             return ends_with(basic_string_view(x));
         }
 
+    private:
+        constexpr bool _constexpr_match(basic_string_view sv, size_type pos, size_type i) const noexcept {
+            return i == sv.size() || (traits_type::eq((*this)[pos + i], sv[i]) && _constexpr_match(sv, pos, i + 1));
+        }
+        constexpr size_type _constexpr_find(basic_string_view sv, size_type pos) const noexcept {
+            return sv.size() > size() || pos > size() - sv.size() ? npos : (_constexpr_match(sv, pos, 0) ? pos : _constexpr_find(sv, pos + 1));
+        }
+        constexpr size_type _constexpr_find(CharT c, size_type pos) const noexcept {
+            return pos >= size() ? npos : (traits_type::eq((*this)[pos], c) ? pos : _constexpr_find(c, pos + 1));
+        }
+
     public:
         constexpr size_type find(basic_string_view sv, size_type pos = 0) const noexcept {
-            return pos < size() ? (compare(pos, sv.size(), sv) == 0 ? pos : find(sv, ++pos)) : npos;
+            return CPP17_IS_CONSTANT_EVALUATED() ? _constexpr_find(sv, pos) : _search::find(data(), size(), sv.data(), sv.size(), pos);
         }
         constexpr size_type find(CharT c, size_type pos = 0) const noexcept {
-            return find(basic_string_view(&c, 1), pos);
+            return CPP17_IS_CONSTANT_EVALUATED() ? _constexpr_find(c, pos) : _search::find(data(), size(), c, pos);
         }
         constexpr size_type find(const CharT* s, size_type pos, size_type n) const {
             return find(basic_string_view(s, n), pos);
@@ -231,6 +258,98 @@ namespace cpp17 {
             return find(basic_string_view(s), pos);
         }
 
+    private:
+        constexpr size_type _constexpr_rfind(basic_string_view sv, size_type pos) const noexcept {
+            return _constexpr_match(sv, pos, 0) ? pos : (pos == 0 ? npos : _constexpr_rfind(sv, pos - 1));
+        }
+        constexpr size_type _constexpr_rfind_from(basic_string_view sv, size_type pos) const noexcept {
+            return sv.size() > size() ? npos : _constexpr_rfind(sv, size() - sv.size() < pos ? size() - sv.size() : pos);
+        }
+        static constexpr bool _constexpr_contains(basic_string_view set, CharT c, size_type i) noexcept {
+            return i < set.size() && (traits_type::eq(set[i], c) || _constexpr_contains(set, c, i + 1));
+        }
+        constexpr size_type _constexpr_find_first_of(basic_string_view set, size_type pos, bool member) const noexcept {
+            return pos >= size() ? npos : (_constexpr_contains(set, (*this)[pos], 0) == member ? pos : _constexpr_find_first_of(set, pos + 1, member));
+        }
+        constexpr size_type _constexpr_find_last_of(basic_string_view set, size_type pos, bool member) const noexcept {
+            return _constexpr_contains(set, (*this)[pos], 0) == member ? pos : (pos == 0 ? npos : _constexpr_find_last_of(set, pos - 1, member));
+        }
+        constexpr size_type _constexpr_find_last_of_from(basic_string_view set, size_type pos, bool member) const noexcept {
+            return empty() ? npos : _constexpr_find_last_of(set, pos < size() ? pos : size() - 1, member);
+        }
+
+        using _search = detail::string_search<traits_type>;
+
+    public:
+        constexpr size_type rfind(basic_string_view sv, size_type pos = npos) const noexcept {
+            return CPP17_IS_CONSTANT_EVALUATED() ? _constexpr_rfind_from(sv, pos) : _search::rfind(data(), size(), sv.data(), sv.size(), pos);
+        }
+        constexpr size_type rfind(CharT c, size_type pos = npos) const noexcept {
+            return CPP17_IS_CONSTANT_EVALUATED() ? _constexpr_find_last_of_from(basic_string_view(&c, 1), pos, true) : _search::rfind(data(), size(), c, pos);
+        }
+        constexpr size_type rfind(const CharT* s, size_type pos, size_type n) const {
+            return rfind(basic_string_view(s, n), pos);
+        }
+        constexpr size_type rfind(const CharT* s, size_type pos = npos) const {
+            return rfind(basic_string_view(s), pos);
+        }
+
+    public:
+        constexpr size_type find_first_of(basic_string_view sv, size_type pos = 0) const noexcept {
+            return CPP17_IS_CONSTANT_EVALUATED() ? _constexpr_find_first_of(sv, pos, true) : _search::find_first_of(data(), size(), sv.data(), sv.size(), pos, true);
+        }
+        constexpr size_type find_first_of(CharT c, size_type pos = 0) const noexcept {
+            return find(c, pos);
+        }
+        constexpr size_type find_first_of(const CharT* s, size_type pos, size_type n) const {
+            return find_first_of(basic_string_view(s, n), pos);
+        }
+        constexpr size_type find_first_of(const CharT* s, size_type pos = 0) const {
+            return find_first_of(basic_string_view(s), pos);
+        }
+
+    public:
+        constexpr size_type find_last_of(basic_string_view sv, size_type pos = npos) const noexcept {
+            return CPP17_IS_CONSTANT_EVALUATED() ? _constexpr_find_last_of_from(sv, pos, true) : _search::find_last_of(data(), size(), sv.data(), sv.size(), pos, true);
+        }
+        constexpr size_type find_last_of(CharT c, size_type pos = npos) const noexcept {
+            return rfind(c, pos);
+        }
+        constexpr size_type find_last_of(const CharT* s, size_type pos, size_type n) const {
+            return find_last_of(basic_string_view(s, n), pos);
+        }
+        constexpr size_type find_last_of(const CharT* s, size_type pos = npos) const {
+            return find_last_of(basic_string_view(s), pos);
+        }
+
+    public:
+        constexpr size_type find_first_not_of(basic_string_view sv, size_type pos = 0) const noexcept {
+            return CPP17_IS_CONSTANT_EVALUATED() ? _constexpr_find_first_of(sv, pos, false) : _search::find_first_of(data(), size(), sv.data(), sv.size(), pos, false);
+        }
+        constexpr size_type find_first_not_of(CharT c, size_type pos = 0) const noexcept {
+            return find_first_not_of(basic_string_view(&c, 1), pos);
+        }
+        constexpr size_type find_first_not_of(const CharT* s, size_type pos, size_type n) const {
+            return find_first_not_of(basic_string_view(s, n), pos);
+        }
+        constexpr size_type find_first_not_of(const CharT* s, size_type pos = 0) const {
+            return find_first_not_of(basic_string_view(s), pos);
+        }
+
+    public:
+        constexpr size_type find_last_not_of(basic_string_view sv, size_type pos = npos) const noexcept {
+            return CPP17_IS_CONSTANT_EVALUATED() ? _constexpr_find_last_of_from(sv, pos, false) : _search::find_last_of(data(), size(), sv.data(), sv.size(), pos, false);
+        }
+        constexpr size_type find_last_not_of(CharT c, size_type pos = npos) const noexcept {
+            return find_last_not_of(basic_string_view(&c, 1), pos);
+        }
+        constexpr size_type find_last_not_of(const CharT* s, size_type pos, size_type n) const {
+            return find_last_not_of(basic_string_view(s, n), pos);
+        }
+        constexpr size_type find_last_not_of(const CharT* s, size_type pos = npos) const {
+            return find_last_not_of(basic_string_view(s), pos);
+        }
+
     public:
         std::basic_string<CharT> str() const {
             return std::basic_string<CharT>(begin(), end());
@@ -239,7 +358,7 @@ namespace cpp17 {
 
     template <class CharT>
     constexpr bool operator==(basic_string_view<CharT> lhs, basic_string_view<CharT> rhs) {
-        return lhs.compare(rhs) == 0;
+        return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
     }
 
     template <class CharT>
@@ -297,4 +416,64 @@ namespace cpp17 {
     using wstring_view = basic_string_view<wchar_t>;
     using u16string_view = basic_string_view<char16_t>;
     using u32string_view = basic_string_view<char32_t>;
+
+    // ASCII case-insensitive comparisons, eight bytes per step; bytes outside ASCII compare exactly
+    inline bool iequals(string_view lhs, string_view rhs) noexcept {
+        return lhs.size() == rhs.size() && detail::ascii::equal(lhs.data(), rhs.data(), lhs.size());
+    }
+    inline bool istarts_with(string_view s, string_view prefix) noexcept {
+        return s.size() >= prefix.size() && detail::ascii::equal(s.data(), prefix.data(), prefix.size());
+    }
+    inline bool iends_with(string_view s, string_view suffix) noexcept {
+        return s.size() >= suffix.size() && detail::ascii::equal(s.data() + s.size() - suffix.size(), suffix.data(), suffix.size());
+    }
+    inline int icompare(string_view lhs, string_view rhs) noexcept {
+        int r = detail::ascii::compare(lhs.data(), rhs.data(), std::min(lhs.size(), rhs.size()));
+        return r != 0 ? r : (lhs.size() < rhs.size() ? -1 : (lhs.size() > rhs.size() ? 1 : 0));
+    }
+
+    namespace detail {
+        template <class CharT, class Traits>
+        constexpr basic_string_view<CharT, Traits> as_string_view(basic_string_view<CharT, Traits> s) noexcept {
+            return s;
+        }
+        template <class CharT, class Traits, class Alloc>
+        basic_string_view<CharT> as_string_view(const std::basic_string<CharT, Traits, Alloc>& s) noexcept {
+            return basic_string_view<CharT>(s.data(), s.size());
+        }
+        template <class CharT>
+        constexpr basic_string_view<CharT> as_string_view(const CharT* s) noexcept {
+            return basic_string_view<CharT>(s);
+        }
+    } // namespace detail
+
+    // Hashes the characters only, so a string, a view and a C string with equal contents hash equally.
+    // Both functors are transparent for containers that support heterogeneous lookup.
+    struct string_hash {
+        using is_transparent = void;
+
+        template <class S>
+        std::size_t operator()(const S& s) const noexcept {
+            auto v = detail::as_string_view(s);
+            return static_cast<std::size_t>(detail::hash_bytes(v.data(), v.size() * sizeof(*v.data())));
+        }
+    };
+
+    struct string_equal {
+        using is_transparent = void;
+
+        template <class L, class R>
+        bool operator()(const L& lhs, const R& rhs) const noexcept {
+            return detail::as_string_view(lhs) == detail::as_string_view(rhs);
+        }
+    };
 } // namespace cpp17
+
+namespace std {
+    template <class CharT, class Traits>
+    struct hash<cpp17::basic_string_view<CharT, Traits>> {
+        std::size_t operator()(cpp17::basic_string_view<CharT, Traits> s) const noexcept {
+            return cpp17::string_hash()(s);
+        }
+    };
+} // namespace std
@@ -0,0 +1,298 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_THREAD_POOL_HPP
+#define LIBCPP17_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cpp17 {
+    namespace detail {
+        struct pool_task {
+            void (*run)(void* context, std::size_t begin, std::size_t end);
+            void* context;
+            std::size_t begin, end;
+        };
+    } // namespace detail
+
+    // Work-stealing pool. Every worker owns a deque: it pushes and pops at the back and idle workers
+    // steal from the front, where the largest unsplit ranges are. Threads outside the pool share
+    // one extra deque and help with queued work while they wait for a parallel_for.
+    class thread_pool {
+    private:
+        struct _queue {
+            std::mutex mutex;
+            std::deque<detail::pool_task> tasks;
+            std::atomic<std::size_t> size;
+            char padding[64];
+
+            _queue()
+                    : size(0) {
+            }
+        };
+
+        struct _loop {
+            thread_pool* pool;
+            void (*body)(void* context, std::size_t begin, std::size_t end);
+            void* context;
+            std::atomic<std::size_t> remaining;
+            std::atomic<bool> failed;
+            std::mutex error_mutex;
+            std::exception_ptr error;
+        };
+
+        struct _current {
+            thread_pool* pool;
+            std::size_t index;
+        };
+
+        std::size_t _queue_count;
+        std::unique_ptr<_queue[]> _queues;
+        std::vector<std::thread> _threads;
+        std::atomic<std::size_t> _pending;
+        std::atomic<std::size_t> _sleeping;
+        std::mutex _sleep_mutex;
+        std::condition_variable _wake;
+        bool _stop;
+
+    public:
+        // one worker per hardware thread besides the caller
+        static std::size_t default_size() noexcept {
+            unsigned n = std::thread::hardware_concurrency();
+            return n > 1 ? n - 1 : 0;
+        }
+
+        // a pool without workers runs everything on the calling thread
+        explicit thread_pool(std::size_t threads = default_size())
+                : _queue_count(threads + 1), _queues(new _queue[threads + 1]), _pending(0), _sleeping(0), _stop(false) {
+            _threads.reserve(threads);
+            try {
+                for (std::size_t i = 0; i < threads; ++i) {
+                    _threads.emplace_back(&thread_pool::_work, this, i);
+                }
+            } catch (...) {
+                _shutdown();
+                throw;
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        // queued tasks are finished before the workers exit
+        ~thread_pool() {
+            _shutdown();
+        }
+
+        static thread_pool& default_pool() {
+            static thread_pool pool;
+            return pool;
+        }
+
+    public:
+        std::size_t size() const noexcept {
+            return _threads.size();
+        }
+        // workers plus the thread waiting for a parallel_for
+        std::size_t concurrency() const noexcept {
+            return _threads.size() + 1;
+        }
+
+    public:
+        template <class F>
+        auto submit(F f) -> std::future<decltype(f())> {
+            using task_type = std::packaged_task<decltype(f())()>;
+            std::unique_ptr<task_type> task(new task_type(std::move(f)));
+            auto future = task->get_future();
+            if (_threads.empty()) {
+                (*task)();
+                return future;
+            }
+            _push(_this_queue(), detail::pool_task{&_invoke<task_type>, task.get(), 0, 0});
+            task.release();
+            _notify(1);
+            return future;
+        }
+
+        // Calls body(begin, end) on disjoint subranges covering [0, count), one index at a time;
+        // the caller takes part and returns once every index is done. The first exception thrown
+        // by body cancels the ranges that have not started yet and is rethrown here.
+        // Index i first goes to the deque of worker i * concurrency() / count, so repeated loops
+        // over the same data touch the same memory from the same threads.
+        template <class F>
+        void parallel_for(std::size_t count, F&& body) {
+            if (count == 0) return;
+            if (count == 1 || _threads.empty()) {
+                body(std::size_t(0), count);
+                return;
+            }
+
+            _loop loop;
+            loop.pool = this;
+            loop.body = &_call<typename std::remove_reference<F>::type>;
+            loop.context = &body;
+            loop.remaining.store(count);
+            loop.failed.store(false);
+
+            std::size_t blocks = count < _queue_count ? count : _queue_count;
+            for (std::size_t b = 0; b < blocks; ++b) {
+                _push(b, detail::pool_task{&_run_range, &loop, count * b / blocks, count * (b + 1) / blocks});
+            }
+            _notify(blocks);
+
+            std::size_t queue = _this_queue();
+            while (loop.remaining.load(std::memory_order_acquire) != 0) {
+                if (!_run_one(queue)) std::this_thread::yield();
+            }
+            if (loop.error) std::rethrow_exception(loop.error);
+        }
+
+    private:
+        template <class F>
+        static void _call(void* context, std::size_t begin, std::size_t end) {
+            (*static_cast<F*>(context))(begin, end);
+        }
+
+        template <class Task>
+        static void _invoke(void* context, std::size_t, std::size_t) {
+            std::unique_ptr<Task> task(static_cast<Task*>(context));
+            (*task)();
+        }
+
+        // keeps the right half of the range for thieves until a single index is left
+        static void _run_range(void* context, std::size_t begin, std::size_t end) {
+            _loop& loop = *static_cast<_loop*>(context);
+            thread_pool& pool = *loop.pool;
+            std::size_t queue = pool._this_queue();
+            while (end - begin > 1) {
+                std::size_t middle = begin + (end - begin) / 2;
+                pool._push(queue, detail::pool_task{&_run_range, context, middle, end});
+                pool._notify(1);
+                end = middle;
+            }
+            if (!loop.failed.load(std::memory_order_relaxed)) {
+                try {
+                    loop.body(loop.context, begin, end);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(loop.error_mutex);
+                    if (!loop.error) loop.error = std::current_exception();
+                    loop.failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            // the loop may be gone as soon as the count reaches zero
+            loop.remaining.fetch_sub(end - begin, std::memory_order_acq_rel);
+        }
+
+        static _current& _this_thread() noexcept {
+            static thread_local _current current{nullptr, 0};
+            return current;
+        }
+
+        std::size_t _this_queue() noexcept {
+            const _current& current = _this_thread();
+            return current.pool == this ? current.index : _queue_count - 1;
+        }
+
+        void _push(std::size_t queue, const detail::pool_task& task) {
+            _queue& q = _queues[queue];
+            {
+                std::lock_guard<std::mutex> lock(q.mutex);
+                q.tasks.push_back(task);
+                q.size.store(q.tasks.size(), std::memory_order_relaxed);
+            }
+            _pending.fetch_add(1);
+        }
+
+        void _notify(std::size_t tasks) {
+            if (_sleeping.load() == 0) return;
+            {
+                std::lock_guard<std::mutex> lock(_sleep_mutex);
+            }
+            if (tasks == 1) {
+                _wake.notify_one();
+            } else {
+                _wake.notify_all();
+            }
+        }
+
+        bool _take(std::size_t queue, bool back, detail::pool_task& task) {
+            _queue& q = _queues[queue];
+            if (q.size.load(std::memory_order_relaxed) == 0) return false;
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) return false;
+            if (back) {
+                task = q.tasks.back();
+                q.tasks.pop_back();
+            } else {
+                task = q.tasks.front();
+                q.tasks.pop_front();
+            }
+            q.size.store(q.tasks.size(), std::memory_order_relaxed);
+            _pending.fetch_sub(1);
+            return true;
+        }
+
+        bool _run_one(std::size_t queue) {
+            detail::pool_task task;
+            bool found = _take(queue, true, task);
+            for (std::size_t i = 1; !found && i < _queue_count; ++i) {
+                found = _take((queue + i) % _queue_count, false, task);
+            }
+            if (!found) return false;
+            task.run(task.context, task.begin, task.end);
+            return true;
+        }
+
+        void _work(std::size_t index) {
+            _this_thread() = _current{this, index};
+            for (;;) {
+                if (_run_one(index)) continue;
+                std::unique_lock<std::mutex> lock(_sleep_mutex);
+                _sleeping.fetch_add(1);
+                _wake.wait(lock, [this] {
+                    return _stop || _pending.load() != 0;
+                });
+                _sleeping.fetch_sub(1);
+                if (_stop && _pending.load() == 0) return;
+            }
+        }
+
+        void _shutdown() {
+            {
+                std::lock_guard<std::mutex> lock(_sleep_mutex);
+                _stop = true;
+            }
+            _wake.notify_all();
+            for (auto& t : _threads) {
+                t.join();
+            }
+            _threads.clear();
+        }
+    };
+} // namespace cpp17
+
+#endif //LIBCPP17_THREAD_POOL_HPP
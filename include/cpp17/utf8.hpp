@@ -0,0 +1,224 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef LIBCPP17_UTF8_HPP
+#define LIBCPP17_UTF8_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "detail/unicode.hpp"
+#include "string_view.hpp"
+
+namespace cpp17 {
+    namespace utf8 {
+        constexpr char32_t replacement_character = 0xfffd;
+
+        // well-formed UTF-8 as defined by Unicode: no overlong forms, surrogates or code points above U+10FFFF
+        inline bool validate(string_view s) noexcept {
+            return detail::utf8::validate(s.data(), s.size());
+        }
+
+        // code points in valid UTF-8
+        inline std::size_t length(string_view s) noexcept {
+            std::size_t continuations, four_byte_leads;
+            detail::utf8::count_bytes(s.data(), s.size(), continuations, four_byte_leads);
+            return s.size() - continuations;
+        }
+
+        // UTF-16 code units needed for valid UTF-8; also enough for the valid prefix of any input
+        inline std::size_t utf16_length(string_view s) noexcept {
+            std::size_t continuations, four_byte_leads;
+            detail::utf8::count_bytes(s.data(), s.size(), continuations, four_byte_leads);
+            return s.size() - continuations + four_byte_leads;
+        }
+
+        // UTF-8 bytes needed to encode the input; an upper bound when it is ill-formed
+        inline std::size_t utf8_length(u16string_view s) noexcept {
+            std::size_t n = 0;
+            for (char16_t u : s) n += u < 0x80 ? 1 : u < 0x800 || (u >= 0xd800 && u <= 0xdfff) ? 2 : 3;
+            return n;
+        }
+        inline std::size_t utf8_length(u32string_view s) noexcept {
+            std::size_t n = 0;
+            for (char32_t c : s) n += c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+            return n;
+        }
+
+        // decodes on the fly; each ill-formed subsequence reads as one U+FFFD
+        class code_point_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = char32_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const char32_t*;
+            using reference = char32_t;
+
+        private:
+            const char* _p;
+            const char* _end;
+            char32_t _value;
+            std::size_t _length;
+
+        public:
+            code_point_iterator() noexcept
+                    : _p(nullptr), _end(nullptr), _value(0), _length(0) {
+            }
+            code_point_iterator(const char* p, const char* end) noexcept
+                    : _p(p), _end(end), _value(0), _length(0) {
+                _decode();
+            }
+
+        public:
+            char32_t operator*() const noexcept {
+                return _value;
+            }
+            // the encoded form of the current code point
+            string_view encoded() const noexcept {
+                return string_view(_p, _length);
+            }
+
+            code_point_iterator& operator++() noexcept {
+                _p += _length;
+                _decode();
+                return *this;
+            }
+            code_point_iterator operator++(int) noexcept {
+                code_point_iterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            friend bool operator==(const code_point_iterator& lhs, const code_point_iterator& rhs) noexcept {
+                return lhs._p == rhs._p;
+            }
+            friend bool operator!=(const code_point_iterator& lhs, const code_point_iterator& rhs) noexcept {
+                return lhs._p != rhs._p;
+            }
+
+        private:
+            void _decode() noexcept {
+                if (_p == _end) {
+                    _length = 0;
+                    return;
+                }
+                _length = detail::utf8::decode(_p, static_cast<std::size_t>(_end - _p), _value);
+                if (_value == detail::utf8::invalid) _value = replacement_character;
+            }
+        };
+
+        class code_point_range {
+        private:
+            string_view _text;
+
+        public:
+            explicit code_point_range(string_view text) noexcept
+                    : _text(text) {
+            }
+
+            code_point_iterator begin() const noexcept {
+                return code_point_iterator(_text.data(), _text.data() + _text.size());
+            }
+            code_point_iterator end() const noexcept {
+                return code_point_iterator(_text.data() + _text.size(), _text.data() + _text.size());
+            }
+        };
+
+        inline code_point_range code_points(string_view s) noexcept {
+            return code_point_range(s);
+        }
+
+        // `in` is where conversion stopped: the end of the input, or the first ill-formed sequence
+        template <class In, class Out>
+        struct transcode_result {
+            const In* in;
+            Out* out;
+            std::errc ec;
+        };
+
+        // `out` needs room for utf16_length(s) code units
+        inline transcode_result<char, char16_t> to_utf16(string_view s, char16_t* out) noexcept {
+            const char* end = s.data() + s.size();
+            const char* p = detail::utf8::decode_to(s.data(), end, out);
+            return {p, out, p == end ? std::errc() : std::errc::illegal_byte_sequence};
+        }
+        // `out` needs room for length(s) code points
+        inline transcode_result<char, char32_t> to_utf32(string_view s, char32_t* out) noexcept {
+            const char* end = s.data() + s.size();
+            const char* p = detail::utf8::decode_to(s.data(), end, out);
+            return {p, out, p == end ? std::errc() : std::errc::illegal_byte_sequence};
+        }
+
+        // `out` needs room for utf8_length(s) bytes; unpaired surrogates are ill-formed
+        inline transcode_result<char16_t, char> to_utf8(u16string_view s, char* out) noexcept {
+            const char16_t* p = s.data();
+            const char16_t* end = p + s.size();
+            while (p != end) {
+                char32_t cp = *p;
+                if (cp >= 0xd800 && cp <= 0xdfff) {
+                    if (cp >= 0xdc00 || end - p < 2 || p[1] < 0xdc00 || p[1] > 0xdfff) return {p, out, std::errc::illegal_byte_sequence};
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (p[1] - 0xdc00);
+                    ++p;
+                }
+                ++p;
+                out = detail::utf8::encode(cp, out);
+            }
+            return {p, out, std::errc()};
+        }
+        // `out` needs room for utf8_length(s) bytes; surrogates and values above U+10FFFF are ill-formed
+        inline transcode_result<char32_t, char> to_utf8(u32string_view s, char* out) noexcept {
+            const char32_t* p = s.data();
+            const char32_t* end = p + s.size();
+            for (; p != end; ++p) {
+                if (*p > 0x10ffff || (*p >= 0xd800 && *p <= 0xdfff)) return {p, out, std::errc::illegal_byte_sequence};
+                out = detail::utf8::encode(*p, out);
+            }
+            return {p, out, std::errc()};
+        }
+
+        // allocating forms; throw std::invalid_argument on ill-formed input
+        inline std::u16string to_u16string(string_view s) {
+            std::u16string result(utf16_length(s), u'\0');
+            auto r = to_utf16(s, &result[0]);
+            if (r.ec != std::errc()) throw std::invalid_argument("utf8: ill-formed UTF-8");
+            return result;
+        }
+        inline std::u32string to_u32string(string_view s) {
+            std::u32string result(length(s), U'\0');
+            auto r = to_utf32(s, &result[0]);
+            if (r.ec != std::errc()) throw std::invalid_argument("utf8: ill-formed UTF-8");
+            return result;
+        }
+        inline std::string to_string(u16string_view s) {
+            std::string result(utf8_length(s), '\0');
+            auto r = to_utf8(s, &result[0]);
+            if (r.ec != std::errc()) throw std::invalid_argument("utf8: ill-formed UTF-16");
+            return result;
+        }
+        inline std::string to_string(u32string_view s) {
+            std::string result(utf8_length(s), '\0');
+            auto r = to_utf8(s, &result[0]);
+            if (r.ec != std::errc()) throw std::invalid_argument("utf8: ill-formed UTF-32");
+            return result;
+        }
+    } // namespace utf8
+} // namespace cpp17
+
+#endif //LIBCPP17_UTF8_HPP
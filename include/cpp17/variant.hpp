@@ -0,0 +1,633 @@
+//
+// Copyright 2018-2019 SiLeader and Cerussite.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef LIBCPP17_VARIANT_HPP
+#define LIBCPP17_VARIANT_HPP
+
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "detail/only.hpp"
+#include "detail/special_members.hpp"
+#include "detail/utility.hpp"
+
+namespace cpp17 {
+    template <class T>
+    struct in_place_type_t {
+        explicit in_place_type_t() = default;
+    };
+    template <std::size_t I>
+    struct in_place_index_t {
+        explicit in_place_index_t() = default;
+    };
+
+#if OVER_CPP14
+    template <class T>
+    constexpr in_place_type_t<T> in_place_type{};
+    template <std::size_t I>
+    constexpr in_place_index_t<I> in_place_index{};
+#endif
+
+    constexpr std::size_t variant_npos = static_cast<std::size_t>(-1);
+
+    struct monostate {
+    };
+
+    constexpr bool operator==(monostate, monostate) noexcept {
+        return true;
+    }
+    constexpr bool operator!=(monostate, monostate) noexcept {
+        return false;
+    }
+    constexpr bool operator<(monostate, monostate) noexcept {
+        return false;
+    }
+    constexpr bool operator>(monostate, monostate) noexcept {
+        return false;
+    }
+    constexpr bool operator<=(monostate, monostate) noexcept {
+        return true;
+    }
+    constexpr bool operator>=(monostate, monostate) noexcept {
+        return true;
+    }
+
+    struct bad_variant_access : public std::exception {
+        const char* what() const noexcept override {
+            return "bad variant access";
+        }
+    };
+
+    template <class... Ts>
+    class variant;
+
+    template <class T>
+    struct variant_size;
+    template <class... Ts>
+    struct variant_size<variant<Ts...>> : std::integral_constant<std::size_t, sizeof...(Ts)> {
+    };
+    template <class T>
+    struct variant_size<const T> : variant_size<T> {
+    };
+
+    template <std::size_t I, class T>
+    struct variant_alternative;
+    template <std::size_t I, class T, class... Ts>
+    struct variant_alternative<I, variant<T, Ts...>> : variant_alternative<I - 1, variant<Ts...>> {
+    };
+    template <class T, class... Ts>
+    struct variant_alternative<0, variant<T, Ts...>> {
+        using type = T;
+    };
+    template <std::size_t I, class T>
+    struct variant_alternative<I, const T> {
+        using type = const typename variant_alternative<I, T>::type;
+    };
+
+    template <std::size_t I, class T>
+    using variant_alternative_t = typename variant_alternative<I, T>::type;
+
+    namespace detail {
+        namespace variant {
+            template <std::size_t N>
+            using index_type = typename std::conditional<
+                    N < std::numeric_limits<unsigned char>::max(), unsigned char,
+                    typename std::conditional<N < std::numeric_limits<unsigned short>::max(), unsigned short, std::size_t>::type>::type;
+
+            template <class T, class... Ts>
+            struct index_of;
+            template <class T>
+            struct index_of<T> : std::integral_constant<std::size_t, 0> {
+            };
+            template <class T, class U, class... Ts>
+            struct index_of<T, U, Ts...>
+                    : std::integral_constant<std::size_t, std::is_same<T, U>::value ? 0 : 1 + index_of<T, Ts...>::value> {
+            };
+
+            // overload resolution set used to pick the alternative for converting construction/assignment
+            template <std::size_t I, class... Ts>
+            struct overload_set;
+            template <std::size_t I>
+            struct overload_set<I> {
+                static void test();
+            };
+            template <std::size_t I, class T, class... Ts>
+            struct overload_set<I, T, Ts...> : overload_set<I + 1, Ts...> {
+                using overload_set<I + 1, Ts...>::test;
+                static std::integral_constant<std::size_t, I> test(T);
+            };
+
+            template <class U, class... Ts>
+            using select_index = decltype(overload_set<0, Ts...>::test(std::declval<U>()));
+
+            template <bool TriviallyDestructible, class... Ts>
+            union variadic_union;
+
+            template <bool TriviallyDestructible>
+            union variadic_union<TriviallyDestructible> {
+            };
+
+            template <class T, class... Ts>
+            union variadic_union<true, T, Ts...> {
+                char dummy;
+                T head;
+                variadic_union<true, Ts...> tail;
+
+                constexpr variadic_union() noexcept
+                        : dummy() {
+                }
+                template <class... Args>
+                constexpr variadic_union(in_place_index_t<0>, Args&&... args)
+                        : head(std::forward<Args>(args)...) {
+                }
+                template <std::size_t I, class... Args>
+                constexpr variadic_union(in_place_index_t<I>, Args&&... args)
+                        : tail(in_place_index_t<I - 1>(), std::forward<Args>(args)...) {
+                }
+            };
+
+            template <class T, class... Ts>
+            union variadic_union<false, T, Ts...> {
+                char dummy;
+                T head;
+                variadic_union<false, Ts...> tail;
+
+                constexpr variadic_union() noexcept
+                        : dummy() {
+                }
+                template <class... Args>
+                constexpr variadic_union(in_place_index_t<0>, Args&&... args)
+                        : head(std::forward<Args>(args)...) {
+                }
+                template <std::size_t I, class... Args>
+                constexpr variadic_union(in_place_index_t<I>, Args&&... args)
+                        : tail(in_place_index_t<I - 1>(), std::forward<Args>(args)...) {
+                }
+                ~variadic_union() {
+                }
+            };
+
+            template <std::size_t I>
+            struct union_get {
+                template <class U>
+                static constexpr auto get(const U& u) noexcept -> decltype(union_get<I - 1>::get(u.tail)) {
+                    return union_get<I - 1>::get(u.tail);
+                }
+                template <class U>
+                static auto get(U& u) noexcept -> decltype(union_get<I - 1>::get(u.tail)) {
+                    return union_get<I - 1>::get(u.tail);
+                }
+            };
+            template <>
+            struct union_get<0> {
+                template <class U>
+                static constexpr auto get(const U& u) noexcept -> decltype((u.head)) {
+                    return u.head;
+                }
+                template <class U>
+                static auto get(U& u) noexcept -> decltype((u.head)) {
+                    return u.head;
+                }
+            };
+
+            template <class R, template <std::size_t> class Op, class... Args, std::size_t... I>
+            R jump(index_sequence<I...>, std::size_t index, Args... args) {
+                static constexpr R (*table[])(Args...) = {&Op<I>::template apply<Args...>...};
+                return table[index](args...);
+            }
+
+            template <bool TriviallyDestructible, class... Ts>
+            class storage {
+            public:
+                using index_t = index_type<sizeof...(Ts)>;
+                static constexpr index_t npos = std::numeric_limits<index_t>::max();
+
+                variadic_union<TriviallyDestructible, Ts...> _u;
+                index_t _index;
+
+                template <std::size_t I>
+                using alternative = typename variant_alternative<I, cpp17::variant<Ts...>>::type;
+
+            public:
+                constexpr storage(uninitialized_t) noexcept
+                        : _u(), _index(npos) {
+                }
+                template <std::size_t I, class... Args>
+                constexpr storage(in_place_index_t<I>, Args&&... args)
+                        : _u(in_place_index_t<I>(), std::forward<Args>(args)...), _index(I) {
+                }
+
+            public:
+                constexpr bool _valid() const noexcept {
+                    return _index != npos;
+                }
+
+                template <std::size_t I>
+                alternative<I>& _get() noexcept {
+                    return union_get<I>::get(_u);
+                }
+                template <std::size_t I>
+                constexpr const alternative<I>& _get() const noexcept {
+                    return union_get<I>::get(_u);
+                }
+
+                template <std::size_t I, class... Args>
+                void _construct(Args&&... args) {
+                    ::new (static_cast<void*>(std::addressof(_get<I>()))) alternative<I>(std::forward<Args>(args)...);
+                    _index = static_cast<index_t>(I);
+                }
+
+            private:
+                template <std::size_t I>
+                struct destroy_op {
+                    template <class Self>
+                    static void apply(Self self) {
+                        using T = alternative<I>;
+                        self->template _get<I>().~T();
+                    }
+                };
+                template <std::size_t I>
+                struct copy_op {
+                    template <class Self, class Other>
+                    static void apply(Self self, Other other) {
+                        self->template _construct<I>(other->template _get<I>());
+                    }
+                };
+                template <std::size_t I>
+                struct move_op {
+                    template <class Self, class Other>
+                    static void apply(Self self, Other other) {
+                        self->template _construct<I>(std::move(other->template _get<I>()));
+                    }
+                };
+                template <std::size_t I>
+                struct copy_assign_op {
+                    template <class Self, class Other>
+                    static void apply(Self self, Other other) {
+                        self->template _get<I>() = other->template _get<I>();
+                    }
+                };
+                template <std::size_t I>
+                struct move_assign_op {
+                    template <class Self, class Other>
+                    static void apply(Self self, Other other) {
+                        self->template _get<I>() = std::move(other->template _get<I>());
+                    }
+                };
+
+            public:
+                void _reset() noexcept {
+                    if (!TriviallyDestructible && _valid()) {
+                        jump<void, destroy_op>(make_index_sequence<sizeof...(Ts)>(), _index, this);
+                    }
+                    _index = npos;
+                }
+                void _copy_construct(const storage& rhs) {
+                    if (rhs._valid()) {
+                        jump<void, copy_op>(make_index_sequence<sizeof...(Ts)>(), rhs._index, this, &rhs);
+                    }
+                }
+                void _move_construct(storage& rhs) {
+                    if (rhs._valid()) {
+                        jump<void, move_op>(make_index_sequence<sizeof...(Ts)>(), rhs._index, this, &rhs);
+                    }
+                }
+                void _copy_assign(const storage& rhs) {
+                    if (_index == rhs._index) {
+                        if (_valid()) {
+                            jump<void, copy_assign_op>(make_index_sequence<sizeof...(Ts)>(), _index, this, &rhs);
+                        }
+                    } else {
+                        _reset();
+                        _copy_construct(rhs);
+                    }
+                }
+                void _move_assign(storage& rhs) {
+                    if (_index == rhs._index) {
+                        if (_valid()) {
+                            jump<void, move_assign_op>(make_index_sequence<sizeof...(Ts)>(), _index, this, &rhs);
+                        }
+                    } else {
+                        _reset();
+                        _move_construct(rhs);
+                    }
+                }
+            };
+
+            template <bool TriviallyDestructible, class... Ts>
+            constexpr typename storage<TriviallyDestructible, Ts...>::index_t storage<TriviallyDestructible, Ts...>::npos;
+
+            template <class... Ts>
+            using base = special_member_base<storage<all_of<std::is_trivially_destructible<Ts>::value...>::value, Ts...>, Ts...>;
+
+            struct access {
+                template <std::size_t I, class V>
+                static constexpr auto get(V& v) noexcept -> decltype(v.template _get<I>()) {
+                    return v.template _get<I>();
+                }
+                template <std::size_t I, class V, class = typename std::enable_if<!std::is_reference<V>::value>::type>
+                static auto get(V&& v) noexcept -> decltype(std::move(v.template _get<I>())) {
+                    return std::move(v.template _get<I>());
+                }
+            };
+
+            template <class... Vs>
+            struct product : std::integral_constant<std::size_t, 1> {
+            };
+            template <class V, class... Vs>
+            struct product<V, Vs...>
+                    : std::integral_constant<std::size_t, variant_size<typename std::remove_reference<V>::type>::value * product<Vs...>::value> {
+            };
+
+            // flat index of a multi-variant visit: indices in row-major order, the last variant varying fastest
+            template <std::size_t K, std::size_t J, class... Vs>
+            struct alternative_index;
+            template <std::size_t K, std::size_t J, class V, class... Vs>
+            struct alternative_index<K, J, V, Vs...> : alternative_index<K, J - 1, Vs...> {
+            };
+            template <std::size_t K, class V, class... Vs>
+            struct alternative_index<K, 0, V, Vs...>
+                    : std::integral_constant<std::size_t, (K / product<Vs...>::value) % variant_size<typename std::remove_reference<V>::type>::value> {
+            };
+
+            template <class V>
+            using qualified_get_t = decltype(access::get<0>(std::declval<V>()));
+
+            inline std::size_t flat_index(std::size_t acc) noexcept {
+                return acc;
+            }
+            template <class V, class... Vs>
+            std::size_t flat_index(std::size_t acc, const V& v, const Vs&... vs) {
+                if (v.valueless_by_exception()) throw bad_variant_access();
+                return flat_index(acc * variant_size<V>::value + v.index(), vs...);
+            }
+
+            template <class R, class F, class... Vs>
+            struct visitor {
+                template <std::size_t K, std::size_t... J>
+                static R dispatch(index_sequence<J...>, F&& f, Vs&&... vs) {
+                    return std::forward<F>(f)(access::get<alternative_index<K, J, Vs...>::value>(std::forward<Vs>(vs))...);
+                }
+                template <std::size_t K>
+                static R thunk(F&& f, Vs&&... vs) {
+                    return dispatch<K>(make_index_sequence<sizeof...(Vs)>(), std::forward<F>(f), std::forward<Vs>(vs)...);
+                }
+
+                template <std::size_t... K>
+                static R visit(index_sequence<K...>, F&& f, Vs&&... vs) {
+                    static constexpr R (*table[])(F&&, Vs&&...) = {&thunk<K>...};
+                    return table[flat_index(0, vs...)](std::forward<F>(f), std::forward<Vs>(vs)...);
+                }
+            };
+        } // namespace variant
+    } // namespace detail
+
+    template <class F, class... Vs>
+    auto visit(F&& f, Vs&&... vs) -> decltype(std::forward<F>(f)(std::declval<detail::variant::qualified_get_t<Vs>>()...));
+
+    template <class... Ts>
+    class variant : private detail::variant::base<Ts...> {
+        static_assert(sizeof...(Ts) > 0, "variant must have at least one alternative");
+
+        using _base = detail::variant::base<Ts...>;
+        friend struct detail::variant::access;
+
+        template <std::size_t I>
+        using _alternative = typename variant_alternative<I, variant>::type;
+
+        template <class T>
+        using _enable_if_not_self = typename std::enable_if<!std::is_same<typename std::decay<T>::type, variant>::value>::type;
+
+    public:
+        template <class T0 = _alternative<0>, class = typename std::enable_if<std::is_default_constructible<T0>::value>::type>
+        constexpr variant() noexcept(std::is_nothrow_default_constructible<T0>::value)
+                : _base(in_place_index_t<0>()) {
+        }
+
+        variant(const variant&) = default;
+        variant(variant&&) = default;
+
+        template <class T, class = _enable_if_not_self<T>, class I = detail::variant::select_index<T, Ts...>>
+        constexpr variant(T&& v) noexcept(std::is_nothrow_constructible<_alternative<I::value>, T>::value)
+                : _base(in_place_index_t<I::value>(), std::forward<T>(v)) {
+        }
+
+        template <class T, class... Args>
+        constexpr explicit variant(in_place_type_t<T>, Args&&... args)
+                : _base(in_place_index_t<detail::variant::index_of<T, Ts...>::value>(), std::forward<Args>(args)...) {
+        }
+        template <std::size_t I, class... Args>
+        constexpr explicit variant(in_place_index_t<I>, Args&&... args)
+                : _base(in_place_index_t<I>(), std::forward<Args>(args)...) {
+        }
+
+        variant& operator=(const variant&) = default;
+        variant& operator=(variant&&) = default;
+
+        template <class T, class = _enable_if_not_self<T>, class I = detail::variant::select_index<T, Ts...>>
+        variant& operator=(T&& v) {
+            if (index() == I::value) {
+                this->template _get<I::value>() = std::forward<T>(v);
+            } else {
+                emplace<I::value>(std::forward<T>(v));
+            }
+            return *this;
+        }
+
+    public:
+        constexpr std::size_t index() const noexcept {
+            return this->_valid() ? static_cast<std::size_t>(this->_index) : variant_npos;
+        }
+        constexpr bool valueless_by_exception() const noexcept {
+            return !this->_valid();
+        }
+
+    public:
+        template <class T, class... Args>
+        T& emplace(Args&&... args) {
+            return emplace<detail::variant::index_of<T, Ts...>::value>(std::forward<Args>(args)...);
+        }
+        template <std::size_t I, class... Args>
+        _alternative<I>& emplace(Args&&... args) {
+            static_assert(I < sizeof...(Ts), "variant index out of range");
+            this->_reset();
+            this->template _construct<I>(std::forward<Args>(args)...);
+            return this->template _get<I>();
+        }
+
+    public:
+        void swap(variant& rhs) {
+            if (index() == rhs.index()) {
+                if (!valueless_by_exception()) {
+                    cpp17::visit(_swap_visitor{}, *this, rhs);
+                }
+            } else {
+                variant tmp(std::move(rhs));
+                rhs = std::move(*this);
+                *this = std::move(tmp);
+            }
+        }
+
+    private:
+        struct _swap_visitor {
+            template <class T, class U>
+            void operator()(T& lhs, U& rhs) const {
+                _swap(lhs, rhs, std::is_same<T, U>());
+            }
+            template <class T>
+            static void _swap(T& lhs, T& rhs, std::true_type) {
+                using std::swap;
+                swap(lhs, rhs);
+            }
+            template <class T, class U>
+            static void _swap(T&, U&, std::false_type) {
+            }
+        };
+    };
+
+    template <class F, class... Vs>
+    auto visit(F&& f, Vs&&... vs) -> decltype(std::forward<F>(f)(std::declval<detail::variant::qualified_get_t<Vs>>()...)) {
+        using result = decltype(std::forward<F>(f)(std::declval<detail::variant::qualified_get_t<Vs>>()...));
+        using visitor = detail::variant::visitor<result, F, Vs...>;
+        return visitor::visit(detail::make_index_sequence<detail::variant::product<Vs...>::value>(),
+                              std::forward<F>(f), std::forward<Vs>(vs)...);
+    }
+
+    template <class T, class... Ts>
+    constexpr bool holds_alternative(const variant<Ts...>& v) noexcept {
+        return v.index() == detail::variant::index_of<T, Ts...>::value;
+    }
+
+    template <std::size_t I, class... Ts>
+    variant_alternative_t<I, variant<Ts...>>& get(variant<Ts...>& v) {
+        if (v.index() != I) throw bad_variant_access();
+        return detail::variant::access::get<I>(v);
+    }
+    template <std::size_t I, class... Ts>
+    variant_alternative_t<I, variant<Ts...>>&& get(variant<Ts...>&& v) {
+        if (v.index() != I) throw bad_variant_access();
+        return detail::variant::access::get<I>(std::move(v));
+    }
+    template <std::size_t I, class... Ts>
+    constexpr const variant_alternative_t<I, variant<Ts...>>& get(const variant<Ts...>& v) {
+        return v.index() != I ? throw bad_variant_access() : detail::variant::access::get<I>(v);
+    }
+
+    template <class T, class... Ts>
+    T& get(variant<Ts...>& v) {
+        return get<detail::variant::index_of<T, Ts...>::value>(v);
+    }
+    template <class T, class... Ts>
+    T&& get(variant<Ts...>&& v) {
+        return get<detail::variant::index_of<T, Ts...>::value>(std::move(v));
+    }
+    template <class T, class... Ts>
+    constexpr const T& get(const variant<Ts...>& v) {
+        return get<detail::variant::index_of<T, Ts...>::value>(v);
+    }
+
+    template <std::size_t I, class... Ts>
+    typename std::add_pointer<variant_alternative_t<I, variant<Ts...>>>::type get_if(variant<Ts...>* v) noexcept {
+        return v != nullptr && v->index() == I ? std::addressof(detail::variant::access::get<I>(*v)) : nullptr;
+    }
+    template <std::size_t I, class... Ts>
+    typename std::add_pointer<const variant_alternative_t<I, variant<Ts...>>>::type get_if(const variant<Ts...>* v) noexcept {
+        return v != nullptr && v->index() == I ? std::addressof(detail::variant::access::get<I>(*v)) : nullptr;
+    }
+    template <class T, class... Ts>
+    typename std::add_pointer<T>::type get_if(variant<Ts...>* v) noexcept {
+        return get_if<detail::variant::index_of<T, Ts...>::value>(v);
+    }
+    template <class T, class... Ts>
+    typename std::add_pointer<const T>::type get_if(const variant<Ts...>* v) noexcept {
+        return get_if<detail::variant::index_of<T, Ts...>::value>(v);
+    }
+
+    namespace detail {
+        namespace variant {
+            template <class Compare>
+            struct compare_visitor {
+                template <class T, class U>
+                bool operator()(const T& lhs, const U& rhs) const {
+                    return _apply(lhs, rhs, std::is_same<T, U>());
+                }
+                template <class T>
+                static bool _apply(const T& lhs, const T& rhs, std::true_type) {
+                    return Compare()(lhs, rhs);
+                }
+                template <class T, class U>
+                static bool _apply(const T&, const U&, std::false_type) {
+                    return false;
+                }
+            };
+
+            struct equal_to {
+                template <class T>
+                bool operator()(const T& lhs, const T& rhs) const {
+                    return lhs == rhs;
+                }
+            };
+            struct less {
+                template <class T>
+                bool operator()(const T& lhs, const T& rhs) const {
+                    return lhs < rhs;
+                }
+            };
+        } // namespace variant
+    } // namespace detail
+
+    template <class... Ts>
+    bool operator==(const variant<Ts...>& lhs, const variant<Ts...>& rhs) {
+        if (lhs.index() != rhs.index()) return false;
+        if (lhs.valueless_by_exception()) return true;
+        return visit(detail::variant::compare_visitor<detail::variant::equal_to>(), lhs, rhs);
+    }
+    template <class... Ts>
+    bool operator!=(const variant<Ts...>& lhs, const variant<Ts...>& rhs) {
+        return !(lhs == rhs);
+    }
+    template <class... Ts>
+    bool operator<(const variant<Ts...>& lhs, const variant<Ts...>& rhs) {
+        if (rhs.valueless_by_exception()) return false;
+        if (lhs.valueless_by_exception()) return true;
+        if (lhs.index() != rhs.index()) return lhs.index() < rhs.index();
+        return visit(detail::variant::compare_visitor<detail::variant::less>(), lhs, rhs);
+    }
+    template <class... Ts>
+    bool operator>(const variant<Ts...>& lhs, const variant<Ts...>& rhs) {
+        return rhs < lhs;
+    }
+    template <class... Ts>
+    bool operator<=(const variant<Ts...>& lhs, const variant<Ts...>& rhs) {
+        return !(rhs < lhs);
+    }
+    template <class... Ts>
+    bool operator>=(const variant<Ts...>& lhs, const variant<Ts...>& rhs) {
+        return !(lhs < rhs);
+    }
+
+    template <class... Ts>
+    void swap(variant<Ts...>& lhs, variant<Ts...>& rhs) {
+        lhs.swap(rhs);
+    }
+} // namespace cpp17
+
+#endif //LIBCPP17_VARIANT_HPP
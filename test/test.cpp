@@ -14,10 +14,47 @@
 // limitations under the License.
 //
 
+#include <cpp17/algorithm.hpp>
 #include <cpp17/any.hpp>
+#include <cpp17/bit.hpp>
+#include <cpp17/charconv.hpp>
+#include <cpp17/compact_optional.hpp>
+#include <cpp17/cstddef.hpp>
+#include <cpp17/mapped_file.hpp>
+#include <cpp17/mdspan.hpp>
+#include <cpp17/memory_resource.hpp>
+#include <cpp17/numeric.hpp>
 #include <cpp17/optional.hpp>
+#include <cpp17/ring_buffer.hpp>
 #include <cpp17/span.hpp>
+#include <cpp17/span_io.hpp>
+#include <cpp17/span_views.hpp>
+#include <cpp17/split.hpp>
+#include <cpp17/string_pool.hpp>
 #include <cpp17/string_view.hpp>
+#include <cpp17/thread_pool.hpp>
+#include <cpp17/utf8.hpp>
+#include <cpp17/variant.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <thread>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "test.hpp"
 
@@ -27,6 +64,189 @@ int main() {
     TEST_NOTHROW("get as int", cpp17::any_cast<int>(any));
     TEST_THROW("get as short", cpp17::any_cast<short>(any));
     TEST_TRUE("compare with 1", cpp17::any_cast<int>(any) == 1);
+    {
+        cpp17::any copied(any);
+        TEST_TRUE("copy small", cpp17::any_cast<int>(copied) == 1);
+        cpp17::any big = std::string(64, 'x');
+        cpp17::any moved(std::move(big));
+        TEST_TRUE("moved-from is empty", !big.has_value());
+        TEST_TRUE("move big", cpp17::any_cast<std::string>(moved) == std::string(64, 'x'));
+        copied.swap(moved);
+        TEST_TRUE("swap small and big", cpp17::any_cast<std::string>(copied).size() == 64 && cpp17::any_cast<int>(moved) == 1);
+        moved = copied;
+        TEST_TRUE("copy assign big", cpp17::any_cast<std::string>(moved).size() == 64);
+    }
+    {
+        auto counted = std::make_shared<int>(7);
+        {
+            cpp17::any a(counted);
+            cpp17::any b(a);
+            cpp17::any c(std::move(a));
+            TEST_TRUE("inline non-trivial copy/move", counted.use_count() == 3);
+        }
+        TEST_TRUE("inline non-trivial destroy", counted.use_count() == 1);
+    }
+    {
+        cpp17::any a = std::vector<int>(100, 1);
+        TEST_TRUE("pointer cast", cpp17::any_cast<std::vector<int>>(&a) != nullptr);
+        TEST_TRUE("pointer cast mismatch", cpp17::any_cast<int>(&a) == nullptr);
+        TEST_TRUE("pointer cast null", cpp17::any_cast<int>(static_cast<cpp17::any*>(nullptr)) == nullptr);
+        cpp17::any_cast<std::vector<int>&>(a)[0] = 5;
+        TEST_TRUE("reference cast in place", cpp17::any_cast<const std::vector<int>&>(a)[0] == 5);
+        TEST_THROW("reference cast mismatch", cpp17::any_cast<int&>(a));
+        auto moved = cpp17::any_cast<std::vector<int>&&>(std::move(a));
+        TEST_TRUE("rvalue cast moves out", moved.size() == 100 && cpp17::any_cast<std::vector<int>&>(a).empty());
+    }
+
+    {
+        constexpr cpp17::detail::type_id_t int_id = cpp17::detail::type_id<int>();
+        TEST_TRUE("type ids are distinct", int_id != cpp17::detail::type_id<short>());
+        TEST_TRUE("type ids ignore cv and references", int_id == cpp17::detail::type_id<const int&>());
+
+        struct name_of {
+            std::string operator()(int) const {
+                return "int";
+            }
+            std::string operator()(short) const {
+                return "short";
+            }
+            std::string operator()(const std::string& s) const {
+                return s;
+            }
+        };
+        cpp17::any a = std::string("string");
+        TEST_TRUE("visit_any string", (cpp17::visit_any<int, short, std::string>(a, name_of()) == "string"));
+        a = static_cast<short>(1);
+        TEST_TRUE("visit_any short", (cpp17::visit_any<int, short, std::string>(a, name_of()) == "short"));
+        a = 1.0;
+        TEST_THROW("visit_any unlisted type", (cpp17::visit_any<int, short, std::string>(a, name_of())));
+        a.reset();
+        TEST_THROW("visit_any empty", (cpp17::visit_any<int, short, std::string>(a, name_of())));
+    }
+    {
+        char buffer[256];
+        cpp17::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), cpp17::pmr::null_memory_resource());
+        cpp17::any a(std::allocator_arg, &arena, std::vector<int>(3, 9));
+        TEST_TRUE("any on arena", cpp17::any_cast<const std::vector<int>&>(a)[2] == 9);
+        cpp17::any b(std::allocator_arg, &arena, a);
+        TEST_TRUE("any copy on arena", cpp17::any_cast<const std::vector<int>&>(b).size() == 3);
+        TEST_THROW("arena exhausted", cpp17::any(std::allocator_arg, &arena, std::array<char, 512>()));
+    }
+    {
+        cpp17::pmr::unsynchronized_pool_resource pool;
+        void* p1 = pool.allocate(24);
+        pool.deallocate(p1, 24);
+        void* p2 = pool.allocate(20);
+        TEST_TRUE("pool reuses freed block", p1 == p2);
+        void* large = pool.allocate(1 << 20, 64);
+        TEST_TRUE("pool large alignment", reinterpret_cast<std::uintptr_t>(large) % 64 == 0);
+        pool.deallocate(large, 1 << 20, 64);
+        pool.deallocate(p2, 20);
+
+        cpp17::pmr::string s(&pool);
+        s.assign(100, 'y');
+        TEST_TRUE("pmr string", s.size() == 100 && s.get_allocator().resource() == &pool);
+    }
+    {
+        char buffer[4096];
+        cpp17::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), cpp17::pmr::null_memory_resource());
+        std::vector<cpp17::pmr::string, cpp17::pmr::polymorphic_allocator<cpp17::pmr::string>> strings(&arena);
+        strings.emplace_back(100, 'x');
+        strings.push_back(cpp17::pmr::string(50, 'y'));
+        TEST_TRUE("nested pmr containers use the arena", (strings[0].get_allocator().resource() == &arena && strings[1].get_allocator().resource() == &arena && strings[1].size() == 50));
+
+        using entry = std::pair<const cpp17::pmr::string, cpp17::pmr::string>;
+        std::map<cpp17::pmr::string, cpp17::pmr::string, std::less<cpp17::pmr::string>, cpp17::pmr::polymorphic_allocator<entry>> map(&arena);
+        map.emplace(std::string(40, 'k').c_str(), std::string(40, 'v').c_str());
+        map[cpp17::pmr::string(1, 'a')];
+        TEST_TRUE("pmr pair members use the arena", (map.begin()->first.get_allocator().resource() == &arena && map.rbegin()->second.get_allocator().resource() == &arena && map.rbegin()->second.size() == 40));
+    }
+    {
+        struct counting_resource : cpp17::pmr::memory_resource {
+            std::atomic<std::size_t> in_use{0};
+
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                in_use += bytes;
+                return cpp17::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+                in_use -= bytes;
+                cpp17::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            }
+            bool do_is_equal(const cpp17::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        } upstream;
+
+        // blocks allocated on one thread and freed on another are reused rather than refilled from upstream
+        cpp17::pmr::synchronized_pool_resource pool(&upstream);
+        std::vector<void*> blocks(1024);
+        std::atomic<int> turn(0);
+        const int rounds = 200;
+        std::thread producer([&] {
+            for (int r = 0; r < rounds; ++r) {
+                while (turn.load() != 2 * r) std::this_thread::yield();
+                for (auto& b : blocks) b = pool.allocate(64);
+                turn.store(2 * r + 1);
+            }
+        });
+        for (int r = 0; r < rounds; ++r) {
+            while (turn.load() != 2 * r + 1) std::this_thread::yield();
+            for (auto b : blocks) pool.deallocate(b, 64);
+            turn.store(2 * r + 2);
+        }
+        producer.join();
+        TEST_TRUE("synchronized pool reuses blocks freed on another thread", upstream.in_use.load() < 4 * blocks.size() * 64);
+        pool.release();
+        TEST_TRUE("synchronized pool release", upstream.in_use.load() == 0);
+    }
+
+    {
+        using trivial = cpp17::variant<int, double>;
+        static_assert(std::is_trivially_copyable<trivial>::value, "variant of trivial types is trivially copyable");
+        static_assert(sizeof(cpp17::variant<char, short>) == 2 * sizeof(short), "variant uses the smallest index type");
+        static_assert(!std::is_copy_constructible<cpp17::variant<std::unique_ptr<int>>>::value, "copy follows the alternatives");
+
+        struct size_of {
+            std::size_t operator()(int) const {
+                return sizeof(int);
+            }
+            std::size_t operator()(double) const {
+                return sizeof(double);
+            }
+            std::size_t operator()(const std::string& s) const {
+                return s.size();
+            }
+        };
+        cpp17::variant<int, double, std::string> v = std::string("abcde");
+        TEST_TRUE("variant converting constructor", v.index() == 2 && cpp17::holds_alternative<std::string>(v));
+        TEST_TRUE("variant visit", cpp17::visit(size_of(), v) == 5);
+        cpp17::variant<int, double, std::string> copy = v;
+        TEST_TRUE("variant copy", copy == v);
+        v = 1.5;
+        TEST_TRUE("variant assign other alternative", cpp17::get<double>(v) == 1.5 && cpp17::get<2>(copy) == "abcde");
+        TEST_THROW("variant bad access", cpp17::get<int>(v));
+        TEST_TRUE("variant get_if", cpp17::get_if<int>(&v) == nullptr && cpp17::get_if<1>(&v) != nullptr);
+        v.swap(copy);
+        TEST_TRUE("variant swap", v.index() == 2 && copy.index() == 1);
+
+        struct sum {
+            double operator()(int a, double b) const {
+                return a + b;
+            }
+            double operator()(int, int) const {
+                return -1;
+            }
+            double operator()(double, int) const {
+                return -1;
+            }
+            double operator()(double, double) const {
+                return -1;
+            }
+        };
+        trivial lhs(2), rhs(0.5);
+        TEST_TRUE("variant multi visit", cpp17::visit(sum(), lhs, rhs) == 2.5);
+    }
 
     cpp17::optional<int> opt;
     TEST_TRUE("not has value", !opt.has_value());
@@ -35,6 +255,41 @@ int main() {
     TEST_TRUE("value is 3", opt.value() == 3);
     opt.reset();
     TEST_TRUE("not has value", !opt.has_value());
+    {
+        static_assert(sizeof(cpp17::optional<int>) == 2 * sizeof(int), "optional stores only the value and a flag");
+        static_assert(std::is_trivially_copyable<cpp17::optional<double>>::value, "optional of trivial type is trivially copyable");
+        static_assert(!std::is_trivially_destructible<cpp17::optional<std::string>>::value, "optional destroys non-trivial values");
+
+        cpp17::optional<std::string> a("abc"), b;
+        b = a;
+        TEST_TRUE("optional copy assign", b.has_value() && *b == "abc");
+        a = std::string("defgh");
+        TEST_TRUE("optional assign in place", a->size() == 5);
+        b.reset();
+        a.swap(b);
+        TEST_TRUE("optional swap with empty", !a.has_value() && b.value() == "defgh");
+        cpp17::optional<std::string> c(std::move(b));
+        TEST_TRUE("optional move", c.value_or("none") == "defgh");
+    }
+
+    {
+        using optional_double = cpp17::compact_optional<double, cpp17::nan_policy<double>>;
+        static_assert(sizeof(optional_double) == sizeof(double), "compact_optional has no overhead");
+        static_assert(std::is_trivially_copyable<optional_double>::value, "compact_optional of trivial type is trivially copyable");
+
+        optional_double d;
+        TEST_TRUE("compact_optional empty", !d.has_value() && d.value_or(2.0) == 2.0);
+        d = 1.5;
+        TEST_TRUE("compact_optional value", d.has_value() && *d == 1.5);
+        d.reset();
+        TEST_TRUE("compact_optional reset", !d);
+
+        using optional_index = cpp17::compact_optional<int, cpp17::minus_one_policy<int>>;
+        TEST_TRUE("compact_optional sentinel", optional_index(3).has_value() && !optional_index(-1).has_value());
+        cpp17::compact_optional<cpp17::string_view, cpp17::empty_string_view_policy<char>> name;
+        name.emplace("label", 5);
+        TEST_TRUE("compact_optional string_view", name.has_value() && name->size() == 5 && name.to_optional().has_value());
+    }
 
     cpp17::string_view sv;
     TEST_TRUE("empty", sv.empty());
@@ -45,6 +300,244 @@ int main() {
     TEST_TRUE("not starts_with 23", !sv.starts_with("23"));
     TEST_TRUE("not ends_with 12", !sv.ends_with("12"));
     TEST_TRUE("find 23 == 1", sv.find("23") == 1);
+    {
+#if CPP17_HAS_IS_CONSTANT_EVALUATED
+        constexpr cpp17::string_view constant("hello world");
+        static_assert(constant.find("world") == 6, "find is usable in constant expressions");
+        static_assert(constant.find('o', 5) == 7, "find(char) is usable in constant expressions");
+#endif
+        std::string text(1000, 'a');
+        text += "needle in a haystack";
+        cpp17::string_view haystack(text);
+        TEST_TRUE("find long needle", haystack.find(cpp17::string_view(std::string(20, 'a') + "needle")) == 980);
+        TEST_TRUE("find periodic needle", haystack.find(cpp17::string_view(std::string(40, 'a') + "b")) == cpp17::string_view::npos);
+        TEST_TRUE("find char", haystack.find('y') == 1014 && haystack.find('y', 1015) == cpp17::string_view::npos);
+        TEST_TRUE("find empty needle", haystack.find("", haystack.size()) == haystack.size());
+    }
+    {
+#if CPP17_HAS_IS_CONSTANT_EVALUATED
+        constexpr cpp17::string_view constant("  key = value  ");
+        static_assert(constant.rfind("e") == 12 && constant.find_first_not_of(' ') == 2, "search family is usable in constant expressions");
+        static_assert(constant.find_last_not_of(" ") == 12 && constant.find_first_of("=:") == 6, "search family is usable in constant expressions");
+#endif
+        cpp17::string_view line("  key = value  ");
+        TEST_TRUE("rfind", line.rfind("e") == 12 && line.rfind("e", 11) == 3 && line.rfind("zz") == cpp17::string_view::npos);
+        TEST_TRUE("rfind empty needle", line.rfind("") == line.size() && line.rfind("", 3) == 3);
+        TEST_TRUE("find_first_of", line.find_first_of("=:") == 6 && line.find_first_of("xyz", 5) == cpp17::string_view::npos);
+        TEST_TRUE("find_last_of", line.find_last_of("ky") == 4 && line.find_last_of("k", 1) == cpp17::string_view::npos);
+        TEST_TRUE("find_first_not_of", line.find_first_not_of(" \t") == 2 && cpp17::string_view("   ").find_first_not_of(' ') == cpp17::string_view::npos);
+        TEST_TRUE("find_last_not_of", line.find_last_not_of(" \t") == 12 && cpp17::string_view().find_last_not_of(' ') == cpp17::string_view::npos);
+        TEST_TRUE("find_first_of high bytes", cpp17::string_view("ab\xff").find_first_of("\xff\x80") == 2);
+        cpp17::wstring_view wide(L"a,b;c");
+        TEST_TRUE("wide find_last_of", wide.find_last_of(L";,") == 3 && wide.find_first_not_of(L"a,") == 2);
+    }
+    {
+        std::string owned = "a key longer than sixteen bytes, to cover the wide loop as well";
+        cpp17::string_view view(owned);
+        cpp17::string_hash h;
+        TEST_TRUE("string_hash matches across string types", h(owned) == h(view) && h(view) == h(owned.c_str()));
+        TEST_TRUE("std::hash agrees with string_hash", std::hash<cpp17::string_view>()(view) == h(owned));
+        TEST_TRUE("string_hash depends on contents", h(view.substr(1)) != h(view) && h(cpp17::string_view("ab")) != h(cpp17::string_view("ba")));
+        TEST_TRUE("string_equal is heterogeneous", cpp17::string_equal()(owned, view) && !cpp17::string_equal()(view, "other"));
+
+        std::unordered_map<cpp17::string_view, int> counts;
+        ++counts[view];
+        ++counts[cpp17::string_view(owned.data(), owned.size())];
+        TEST_TRUE("unordered_map keyed on string_view", counts.size() == 1 && counts[view] == 2);
+
+        std::unordered_set<std::string, cpp17::string_hash, cpp17::string_equal> names = {"alice", "bob"};
+        TEST_TRUE("string set with string_hash", names.count("bob") == 1 && names.count("carol") == 0);
+    }
+    {
+        TEST_TRUE("equality checks length", cpp17::string_view("abc") != cpp17::string_view("abcd") && cpp17::string_view("abc") == cpp17::string_view("abc"));
+        TEST_TRUE("iequals", cpp17::iequals("Content-Length", "content-length") && !cpp17::iequals("Content-Length", "content-lengt"));
+        TEST_TRUE("iequals long", cpp17::iequals("X-FORWARDED-FOR-ORIGINAL-CLIENT", "x-forwarded-for-original-client"));
+        TEST_TRUE("iequals leaves non-letters", !cpp17::iequals("[@`{", "{`@[") && !cpp17::iequals("\xc0\xc1\xc2\xc3\xc4\xc5\xc6\xc7", "\xe0\xe1\xe2\xe3\xe4\xe5\xe6\xe7"));
+        TEST_TRUE("istarts_with/iends_with", cpp17::istarts_with("Accept-Encoding", "ACCEPT-") && cpp17::iends_with("text/HTML", "/html") && !cpp17::iends_with("ml", "html"));
+        TEST_TRUE("icompare", cpp17::icompare("apple", "BANANA") < 0 && cpp17::icompare("Keep-Alive-Timeout", "keep-alive-TIMEOUT") == 0 && cpp17::icompare("keep-alive-timeouts", "KEEP-ALIVE-TIMEOUT") > 0);
+        TEST_TRUE("icompare orders by folded byte", cpp17::icompare("HEADER-Z", "header-a") > 0);
+    }
+    {
+        using pieces = std::vector<cpp17::string_view>;
+        auto collect = [](cpp17::string_view a, cpp17::string_view b, cpp17::string_view c, cpp17::string_view d) { return pieces{a, b, c, d}; };
+        pieces p;
+        for (auto piece : cpp17::split("a,b,,c", ',')) p.push_back(piece);
+        TEST_TRUE("split on char", p == collect("a", "b", "", "c"));
+        p.clear();
+        std::string fields = "a,b,,c,";
+        for (auto piece : cpp17::split(fields, ',').skip_empty()) p.push_back(piece);
+        TEST_TRUE("split skip empty", p.size() == 3 && p[2] == cpp17::string_view("c"));
+        p.clear();
+        for (auto piece : cpp17::split("k=v=w=x", '=').max_splits(2)) p.push_back(piece);
+        TEST_TRUE("split max splits", p.size() == 3 && p[0] == cpp17::string_view("k") && p[2] == cpp17::string_view("w=x"));
+        p.clear();
+        for (auto piece : cpp17::split("a::b:c::", "::")) p.push_back(piece);
+        TEST_TRUE("split on string", p.size() == 3 && p[1] == cpp17::string_view("b:c") && p[2].empty());
+        TEST_THROW("split on empty string", cpp17::split("abc", ""));
+        p.clear();
+        for (auto piece : cpp17::split_any("a b\tc;;d", " \t;").skip_empty()) p.push_back(piece);
+        TEST_TRUE("split_any", p == collect("a", "b", "c", "d"));
+        p.clear();
+        for (auto piece : cpp17::split("", ',')) p.push_back(piece);
+        TEST_TRUE("split empty text", p.size() == 1 && p[0].empty());
+        p.clear();
+        for (auto line : cpp17::lines("one\r\ntwo\n\nfour\r\n")) p.push_back(line);
+        TEST_TRUE("lines", p == collect("one", "two", "", "four"));
+        TEST_TRUE("lines of empty text", cpp17::lines("").begin() == cpp17::lines("").end());
+        auto range = cpp17::split("x|y", '|');
+        auto it = range.begin();
+        auto copy = it++;
+        TEST_TRUE("split iterator is forward", *copy == cpp17::string_view("x") && *it == cpp17::string_view("y") && copy == range.begin() && ++it == range.end());
+    }
+
+    {
+        const char text[] = "-128 300 7fz";
+        std::int8_t small = 0;
+        auto r = cpp17::from_chars(text, text + 4, small);
+        TEST_TRUE("from_chars int8 min", r.ec == std::errc() && r.ptr == text + 4 && small == -128);
+        r = cpp17::from_chars(text + 5, text + 8, small);
+        TEST_TRUE("from_chars out of range", r.ec == std::errc::result_out_of_range && r.ptr == text + 8 && small == -128);
+        unsigned hex = 0;
+        r = cpp17::from_chars(text + 9, text + 12, hex, 16);
+        TEST_TRUE("from_chars base 16 stops at non-digit", r.ec == std::errc() && r.ptr == text + 11 && hex == 0x7f);
+        r = cpp17::from_chars(text + 4, text + 5, hex);
+        TEST_TRUE("from_chars no digits", r.ec == std::errc::invalid_argument && r.ptr == text + 4);
+
+        char buffer[64];
+        auto w = cpp17::to_chars(buffer, buffer + sizeof(buffer), std::numeric_limits<long long>::min());
+        TEST_TRUE("to_chars int64 min", std::string(buffer, w.ptr) == "-9223372036854775808");
+        w = cpp17::to_chars(buffer, buffer + sizeof(buffer), 255u, 2);
+        TEST_TRUE("to_chars base 2", std::string(buffer, w.ptr) == "11111111");
+        w = cpp17::to_chars(buffer, buffer + 2, 1000);
+        TEST_TRUE("to_chars too small", w.ec == std::errc::value_too_large && w.ptr == buffer + 2);
+
+        auto shortest = [&](double v) { return std::string(buffer, cpp17::to_chars(buffer, buffer + sizeof(buffer), v).ptr); };
+        TEST_TRUE("to_chars shortest", shortest(0.1) == "0.1" && shortest(0.1 + 0.2) == "0.30000000000000004" && shortest(123456.0) == "123456");
+        TEST_TRUE("to_chars picks scientific when shorter", shortest(1e23) == "1e+23" && shortest(5e-324) == "5e-324" && shortest(1e-7) == "1e-07");
+        TEST_TRUE("to_chars specials", shortest(-0.0) == "-0" && shortest(-std::numeric_limits<double>::infinity()) == "-inf");
+        w = cpp17::to_chars(buffer, buffer + sizeof(buffer), 2.5, cpp17::chars_format::fixed, 0);
+        TEST_TRUE("to_chars fixed rounds half to even", std::string(buffer, w.ptr) == "2");
+        w = cpp17::to_chars(buffer, buffer + sizeof(buffer), 1234.5678, cpp17::chars_format::scientific, 3);
+        TEST_TRUE("to_chars scientific precision", std::string(buffer, w.ptr) == "1.235e+03");
+        w = cpp17::to_chars(buffer, buffer + sizeof(buffer), 3.0f, cpp17::chars_format::hex);
+        TEST_TRUE("to_chars hex", std::string(buffer, w.ptr) == "1.8p+1");
+
+        double d = 0;
+        const char number[] = "6.02214076e23 mol";
+        auto f = cpp17::from_chars(number, number + sizeof(number) - 1, d);
+        TEST_TRUE("from_chars double", f.ec == std::errc() && f.ptr == number + 13 && d == 6.02214076e23);
+        f = cpp17::from_chars(number, number + 13, d, cpp17::chars_format::fixed);
+        TEST_TRUE("from_chars fixed ignores exponent", f.ptr == number + 10 && d == 6.02214076);
+        f = cpp17::from_chars("1e400", "1e400" + 5, d);
+        TEST_TRUE("from_chars overflow", f.ec == std::errc::result_out_of_range && d == 6.02214076);
+        const char halfway[] = "9007199254740993";
+        cpp17::from_chars(halfway, halfway + 16, d);
+        TEST_TRUE("from_chars halfway rounds to even", d == 9007199254740992.0);
+        const char above[] = "9007199254740993.000000000000000000001";
+        cpp17::from_chars(above, above + sizeof(above) - 1, d);
+        TEST_TRUE("from_chars long input above halfway", d == 9007199254740994.0);
+        const char tiny[] = "2.2250738585072011e-308";
+        cpp17::from_chars(tiny, tiny + sizeof(tiny) - 1, d);
+        TEST_TRUE("from_chars largest subnormal boundary", d == 2.225073858507201e-308);
+        float hf = 0;
+        f = cpp17::from_chars("1.8p3", "1.8p3" + 5, hf, cpp17::chars_format::hex);
+        TEST_TRUE("from_chars hex float", f.ec == std::errc() && hf == 12.0f);
+        f = cpp17::from_chars("-nan(ind)", "-nan(ind)" + 9, d);
+        TEST_TRUE("from_chars nan", f.ec == std::errc() && d != d && std::signbit(d));
+
+        TEST_TRUE("from_chars string_view optional", cpp17::from_chars<int>("42").value() == 42 && !cpp17::from_chars<int>("42x") && !cpp17::from_chars<int>(""));
+        TEST_TRUE("from_chars string_view double", cpp17::from_chars<double>(cpp17::string_view("2.5")).value() == 2.5);
+        long value = 0;
+        TEST_TRUE("from_chars string_view errc", cpp17::from_chars(cpp17::string_view("-17"), value) == std::errc() && value == -17);
+        TEST_TRUE("from_chars string_view partial", cpp17::from_chars(cpp17::string_view("17 "), value) == std::errc::invalid_argument && value == -17);
+    }
+
+    {
+        const cpp17::string_view text("a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+        TEST_TRUE("utf8 validate", cpp17::utf8::validate(text) && cpp17::utf8::validate(std::string(100, 'x') + text.str()));
+        TEST_TRUE("utf8 rejects surrogate", !cpp17::utf8::validate(cpp17::string_view("\xed\xa0\x80")));
+        TEST_TRUE("utf8 rejects overlong", !cpp17::utf8::validate(cpp17::string_view("\xc0\xaf")) && !cpp17::utf8::validate(cpp17::string_view("\xe0\x80\xaf")));
+        TEST_TRUE("utf8 rejects truncated", !cpp17::utf8::validate(std::string(70, 'x') + "\xe2\x82"));
+        TEST_TRUE("utf8 length", cpp17::utf8::length(text) == 4 && cpp17::utf8::utf16_length(text) == 5);
+
+        std::u32string decoded;
+        for (char32_t c : cpp17::utf8::code_points(text)) decoded += c;
+        TEST_TRUE("utf8 code points", decoded == U"a\u00e9\u20ac\U0001F600");
+        decoded.clear();
+        for (char32_t c : cpp17::utf8::code_points(cpp17::string_view("\xe2\x82x\xff"))) decoded += c;
+        TEST_TRUE("utf8 ill-formed reads as U+FFFD", decoded == U"\ufffdx\ufffd");
+
+        TEST_TRUE("utf8 to UTF-16", cpp17::utf8::to_u16string(text) == u"a\u00e9\u20ac\U0001F600");
+        TEST_TRUE("utf8 from UTF-16", cpp17::utf8::to_string(cpp17::u16string_view(u"a\u00e9\u20ac\U0001F600")) == text.str());
+        TEST_TRUE("utf8 from UTF-32", cpp17::utf8::to_string(cpp17::u32string_view(U"\U0001F600")) == "\xf0\x9f\x98\x80");
+        TEST_THROW("utf8 unpaired surrogate", cpp17::utf8::to_string(cpp17::u16string_view(u"\xd800x")));
+        char16_t units[8];
+        auto r = cpp17::utf8::to_utf16(cpp17::string_view("ab\xc3"), units);
+        TEST_TRUE("utf8 transcode stops at error", r.ec == std::errc::illegal_byte_sequence && r.out == units + 2);
+    }
+
+    {
+        cpp17::string_pool pool;
+        std::string word = "alpha";
+        auto a = pool.intern(word);
+        word[0] = 'A';
+        auto b = pool.intern(cpp17::string_view("alpha"));
+        TEST_TRUE("string_pool deduplicates", a == b && a.data() == b.data() && a.view() == cpp17::string_view("alpha"));
+        TEST_TRUE("string_pool copies", a != pool.intern(word) && std::string(a.c_str()) == "alpha");
+        TEST_TRUE("string_pool empty string", pool.intern("") == cpp17::interned_string() && pool.intern_id("") == 0);
+        TEST_TRUE("string_pool dense ids", a.id() == 1 && pool.intern_id(word) == 2 && pool.size() == 3);
+        TEST_TRUE("string_pool lookup by id", pool[1] == a && pool[0].empty());
+        TEST_TRUE("string_pool find", pool.find("alpha").value() == a && !pool.contains("beta"));
+
+        std::vector<cpp17::interned_string> many;
+        for (int i = 0; i < 5000; ++i) many.push_back(pool.intern(std::to_string(i)));
+        bool stable = true;
+        for (int i = 0; i < 5000; ++i) stable = stable && pool.intern(std::to_string(i)) == many[i] && pool[many[i].id()] == many[i];
+        TEST_TRUE("string_pool stable across growth", stable && a.view() == cpp17::string_view("alpha"));
+        auto stats = pool.stats();
+        TEST_TRUE("string_pool statistics", stats.strings == 5002 && stats.hits == 5004 && stats.interns == 10006 && stats.arena_bytes >= stats.string_bytes);
+
+        cpp17::concurrent_string_pool shared;
+        auto x = shared.intern("x");
+        TEST_TRUE("concurrent_string_pool deduplicates", shared.intern(std::string("x")) == x && shared[x.id()] == x && shared.intern("y") != x);
+        TEST_TRUE("concurrent_string_pool size", shared.size() == 3 && shared.contains("y") && shared.intern("") == cpp17::interned_string());
+    }
+
+    {
+        const std::string path = "cpp17_mapped_file_test.txt";
+        std::string content;
+        for (int i = 0; i < 2000; ++i) content += "line " + std::to_string(i) + "\n";
+        std::ofstream(path, std::ios::binary) << content;
+
+        cpp17::mapped_file file(path);
+        TEST_TRUE("mapped_file contents", file.view() == cpp17::string_view(content) && file.file_size() == content.size());
+        TEST_TRUE("mapped_file bytes", file.bytes().size() == content.size() && file.bytes()[5] == '0');
+        TEST_TRUE("mapped_file byte_span", file.byte_span().size() == content.size() && cpp17::to_integer<char>(file.byte_span()[5]) == '0');
+        file.remap(4101, 10);
+        TEST_TRUE("mapped_file unaligned window", file.view() == cpp17::string_view(content).substr(4101, 10) && file.offset() == 4101);
+        file.remap(content.size() - 3);
+        TEST_TRUE("mapped_file window clipped to end", file.size() == 3);
+        TEST_NOTHROW("mapped_file advise", file.advise(cpp17::access_advice::willneed));
+        TEST_THROW("mapped_file offset past end", file.remap(content.size() + 1));
+
+        cpp17::mapped_file moved(std::move(file));
+        TEST_TRUE("mapped_file move", moved.size() == 3 && !file.is_open() && file.empty());
+
+        cpp17::mapping_options options;
+        options.advice = cpp17::access_advice::sequential;
+        std::string joined;
+        bool whole_lines = true;
+        cpp17::for_each_window(path, 1000, '\n', [&](cpp17::string_view w) {
+            whole_lines = whole_lines && w.size() <= 1000 && w.back() == '\n';
+            joined += w.str();
+        }, options);
+        TEST_TRUE("for_each_window", joined == content && whole_lines);
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc);
+        TEST_TRUE("mapped_file empty file", cpp17::mapped_file(path).empty());
+        std::remove(path.c_str());
+        TEST_THROW("mapped_file missing file", cpp17::mapped_file(path));
+    }
 
     {
         cpp17::span<int> spn;
@@ -53,4 +546,228 @@ int main() {
     std::array<int, 10> array = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
     cpp17::span<int> spn(array);
     TEST_TRUE("spn.size() == array.size()", spn.size() == array.size());
+
+    {
+        std::vector<int> values = {1, 2, 3, 4};
+        cpp17::span<int> writable(values);
+        writable[0] = 10;
+        writable.back() = 40;
+        for (int& v : writable.subspan(1, 2)) v *= 2;
+        TEST_TRUE("span writes through", values == std::vector<int>({10, 4, 6, 40}));
+        cpp17::span<const int> readonly = writable;
+        TEST_TRUE("span<T> to span<const T>", readonly.data() == values.data() && readonly.size() == 4);
+        TEST_TRUE("span of const container is read-only", (std::is_constructible<cpp17::span<const int>, const std::vector<int>&>::value && !std::is_constructible<cpp17::span<int>, const std::vector<int>&>::value));
+        TEST_TRUE("span<const T> does not convert back", (!std::is_convertible<cpp17::span<const int>, cpp17::span<int>>::value && !std::is_convertible<cpp17::span<int>, cpp17::span<long>>::value));
+        TEST_TRUE("span subspan count", writable.subspan(1, 2).size() == 2 && writable.subspan(3).size() == 1);
+    }
+
+    {
+        int block[16] = {};
+        cpp17::span<int, 16> fixed(block);
+        TEST_TRUE("static span stores only a pointer", sizeof(fixed) == sizeof(int*) && sizeof(cpp17::span<int>) == 2 * sizeof(int*));
+        auto middle = fixed.subspan<4, 8>();
+        middle[0] = 7;
+        TEST_TRUE("static subspan", decltype(middle)::extent == 8 && middle.size() == 8 && block[4] == 7);
+        TEST_TRUE("static subspan to end", decltype(fixed.subspan<4>())::extent == 12 && fixed.last<2>().data() == block + 14);
+        cpp17::span<const int> dynamic = fixed;
+        TEST_TRUE("static and dynamic extents convert", (dynamic.size() == 16 && cpp17::span<const int, 16>(dynamic).data() == block));
+        TEST_TRUE("static extent mismatch rejected", (!std::is_constructible<cpp17::span<int, 8>, int (&)[16]>::value && !std::is_constructible<cpp17::span<int, 8>, cpp17::span<int, 16>>::value));
+        TEST_TRUE("dynamic to static extent is explicit", (!std::is_convertible<cpp17::span<int>, cpp17::span<int, 16>>::value && std::is_constructible<cpp17::span<int, 16>, cpp17::span<int>>::value && !std::is_convertible<std::vector<int>&, cpp17::span<int, 16>>::value && std::is_convertible<std::array<int, 16>&, cpp17::span<int, 16>>::value));
+        TEST_TRUE("static span needs data", (!std::is_default_constructible<cpp17::span<int, 8>>::value && std::is_default_constructible<cpp17::span<int, 0>>::value));
+    }
+
+    {
+        cpp17::byte b = static_cast<cpp17::byte>(0x5a);
+        TEST_TRUE("byte to_integer", cpp17::to_integer<int>(b) == 0x5a && cpp17::to_integer<unsigned>(~b) == 0xa5);
+        TEST_TRUE("byte shifts", cpp17::to_integer<int>(b << 4) == 0xa0 && cpp17::to_integer<int>(b >> 4) == 0x05);
+        b |= static_cast<cpp17::byte>(0x01);
+        b &= static_cast<cpp17::byte>(0x0f);
+        b ^= static_cast<cpp17::byte>(0x03);
+        b <<= 1;
+        TEST_TRUE("byte compound operators", cpp17::to_integer<int>(b) == 0x10);
+        TEST_TRUE("byte has no arithmetic", (!std::is_convertible<cpp17::byte, int>::value && !std::is_convertible<int, cpp17::byte>::value));
+
+        std::uint32_t words[2] = {0x01020304, 0};
+        cpp17::span<std::uint32_t, 2> typed(words);
+        auto raw = cpp17::as_bytes(typed);
+        TEST_TRUE("as_bytes keeps static extent", decltype(raw)::extent == 8 && raw.size() == 8 && static_cast<const void*>(raw.data()) == words);
+        TEST_TRUE("as_bytes of dynamic span", cpp17::as_bytes(cpp17::span<std::uint32_t>(words)).size() == 8);
+        auto writable = cpp17::as_writable_bytes(typed);
+        for (auto& x : writable.subspan<4>()) x = static_cast<cpp17::byte>(0xff);
+        TEST_TRUE("as_writable_bytes", words[1] == 0xffffffffu && words[0] == 0x01020304);
+    }
+
+    {
+        int samples[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        cpp17::span<int> all(samples);
+        auto batches = cpp17::chunks(all, 4);
+        TEST_TRUE("chunks keeps a short last chunk", batches.size() == 3 && batches[2].size() == 2 && batches[2][1] == 9);
+        auto exact = cpp17::chunks<4>(all);
+        TEST_TRUE("static chunks are static spans", (decltype(exact)::value_type::extent == 4 && exact.size() == 2 && exact.remainder().size() == 2));
+        int visited = 0;
+        for (auto batch : exact) visited += static_cast<int>(batch.size());
+        TEST_TRUE("iterate static chunks", visited == 8 && exact.end() - exact.begin() == 2);
+        auto sliding = cpp17::windows(all, 3);
+        TEST_TRUE("windows", sliding.size() == 8 && sliding[7].front() == 7 && cpp17::windows<11>(all).empty());
+        TEST_THROW("zero chunk size", cpp17::chunks(all, 0));
+
+        auto channels = cpp17::interleaved(all, 3);
+        TEST_TRUE("interleaved channels", channels.size() == 3 && channels.frames() == 3 && channels[1][2] == 7 && channels.frame(1)[0] == 3);
+        cpp17::strided_span<int> second = channels[2];
+        for (auto& x : second) x = -x;
+        TEST_TRUE("strided_span writes through", samples[2] == -2 && samples[8] == -8 && samples[9] == 9);
+        cpp17::strided_span<const int> readonly = second.subspan(1);
+        TEST_TRUE("strided_span subspan", readonly.size() == 2 && readonly.stride() == 3 && readonly.back() == -8 && readonly.end() - readonly.begin() == 2);
+        TEST_TRUE("strided_span reverse and empty tail", (*second.rbegin() == -8 && second.subspan(3).empty() && second.last(0).data() == &samples[8] + 1));
+    }
+
+    {
+        std::vector<int> buffer(24);
+        for (int i = 0; i < 24; ++i) buffer[i] = i;
+        cpp17::mdspan<int, cpp17::extents<std::size_t, 2, cpp17::dynamic_extent, 4>> cube(buffer.data(), 3);
+        TEST_TRUE("mdspan mixed extents", (decltype(cube)::rank() == 3 && decltype(cube)::rank_dynamic() == 1 && cube.extent(1) == 3 && cube.size() == 24));
+        TEST_TRUE("mdspan layout_right", (cube(1, 2, 3) == 23 && cube(0, 1, 0) == 4 && cube.stride(0) == 12));
+        TEST_TRUE("extents store only dynamic extents", (sizeof(cpp17::extents<int, 3, cpp17::dynamic_extent>) == sizeof(int) && std::is_empty<cpp17::extents<int, 3, 4>>::value));
+        cpp17::mdspan<int, cpp17::dextents<int, 2>, cpp17::layout_left> columns(buffer.data(), 4, 6);
+        TEST_TRUE("mdspan layout_left", (columns(1, 0) == 1 && columns(0, 1) == 4 && columns.stride(1) == 4));
+        cpp17::layout_stride::mapping<cpp17::dextents<int, 2>> transposed(cpp17::dextents<int, 2>(4, 6), std::array<int, 2>{{1, 4}});
+        TEST_TRUE("mdspan layout_stride", (cpp17::mdspan<int, cpp17::dextents<int, 2>, cpp17::layout_stride>(buffer.data(), transposed)(1, 2) == 9 && transposed.is_exhaustive()));
+        cpp17::mdspan<const int, cpp17::dextents<std::size_t, 3>> readonly = cube;
+        TEST_TRUE("mdspan converts to const and dynamic extents", readonly(1, 2, 3) == 23);
+
+        auto row = cpp17::submdspan(cube, 1, 2, cpp17::full_extent);
+        TEST_TRUE("submdspan row keeps layout_right and static extent", (std::is_same<decltype(row)::layout_type, cpp17::layout_right>::value && decltype(row)::static_extent(0) == 4 && row(3) == 23));
+        auto column = cpp17::submdspan(cube, 1, cpp17::full_extent, 2);
+        TEST_TRUE("submdspan column is strided", (std::is_same<decltype(column)::layout_type, cpp17::layout_stride>::value && column.extent(0) == 3 && column(2) == 22));
+        auto block = cpp17::submdspan(cube, cpp17::full_extent, std::make_pair(1, 3), std::make_pair(1, 3));
+        TEST_TRUE("submdspan ranges", (block.extent(1) == 2 && block(0, 0, 0) == 5 && block(1, 1, 1) == 22));
+    }
+
+    {
+        cpp17::ring_buffer<int> ring(6);
+        TEST_TRUE("ring_buffer capacity is a power of two", ring.capacity() == 8 && ring.empty() && !ring.mirrored());
+        int in[6] = {0, 1, 2, 3, 4, 5}, out[5];
+        TEST_TRUE("ring_buffer push and pop", ring.push(in) == 6 && ring.pop(out) == 5 && out[4] == 4 && ring.size() == 1);
+        auto room = ring.writable();
+        TEST_TRUE("ring_buffer writable wraps into two spans", room.first.size() == 2 && room.second.size() == 5 && room.second.data() == room.first.data() - 6);
+        room.first[0] = 6;
+        room.first[1] = 7;
+        room.second[0] = 8;
+        ring.commit(3);
+        auto data = ring.readable();
+        TEST_TRUE("ring_buffer readable in two spans", data.size() == 4 && data.first.size() == 3 && data.first[0] == 5 && data.second[0] == 8);
+        ring.consume(3);
+        int v = 0;
+        TEST_TRUE("ring_buffer try_pop", ring.try_pop(v) && v == 8 && !ring.try_pop(v));
+        TEST_THROW("ring_buffer commit past free space", ring.commit(9));
+        TEST_THROW("ring_buffer consume past data", ring.consume(1));
+
+        cpp17::ring_buffer_options options;
+        options.mirrored = true;
+        cpp17::ring_buffer<char> mirror(100, options);
+        std::string filler(mirror.capacity() - 3, 'x');
+        mirror.push(cpp17::span<const char>(filler.data(), filler.size()));
+        mirror.consume(filler.size());
+        mirror.push(cpp17::span<const char>("abcdef", 6));
+        auto text = mirror.readable();
+        TEST_TRUE("mirrored ring_buffer reads across the wrap as one span", (mirror.mirrored() && text.second.empty() && std::string(text.first.data(), text.first.size()) == "abcdef"));
+
+        cpp17::spsc_ring_buffer<std::uint32_t> queue(64);
+        std::thread producer([&queue] {
+            for (std::uint32_t i = 0; i < 100000;) {
+                if (queue.try_push(i)) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        std::uint32_t expected = 0;
+        bool ordered = true;
+        while (expected < 100000) {
+            auto items = queue.readable();
+            for (auto x : items.first) ordered &= x == expected++;
+            for (auto x : items.second) ordered &= x == expected++;
+            queue.consume(items.size());
+            if (items.empty()) std::this_thread::yield();
+        }
+        producer.join();
+        TEST_TRUE("spsc_ring_buffer delivers in order", ordered && queue.empty());
+    }
+
+    {
+        cpp17::thread_pool pool(3);
+        TEST_TRUE("thread_pool concurrency", pool.size() == 3 && pool.concurrency() == 4);
+        TEST_TRUE("thread_pool submit", pool.submit([] { return 42; }).get() == 42);
+        auto par = cpp17::execution::par.on(pool).with_grain(100);
+        TEST_TRUE("execution policies", (cpp17::is_execution_policy<cpp17::execution::parallel_unsequenced_policy>::value && !cpp17::is_execution_policy<int>::value && par.grain() == 100));
+
+        std::vector<long> values(10000);
+        std::iota(values.begin(), values.end(), 1);
+        cpp17::for_each(par, cpp17::span<long>(values), [](long& v) { v *= 2; });
+        TEST_TRUE("parallel for_each", values.front() == 2 && values.back() == 20000);
+        TEST_TRUE("parallel reduce", cpp17::reduce(par, cpp17::span<const long>(values), 0L) == 10000L * 10001);
+        TEST_TRUE("reduce matches seq", cpp17::reduce(par, cpp17::span<const long>(values), 0L) == cpp17::reduce(cpp17::execution::seq, cpp17::span<const long>(values), 0L));
+        std::vector<long> halves(values.size());
+        cpp17::transform(par, cpp17::span<const long>(values), cpp17::span<long>(halves), [](long v) { return v / 2; });
+        TEST_TRUE("parallel transform_reduce", cpp17::transform_reduce(par, cpp17::span<const long>(halves), cpp17::span<const long>(halves), 0L) == 10000L * 10001 * 20001 / 6);
+        TEST_THROW("transform into a short span", cpp17::transform(par, cpp17::span<const long>(values), cpp17::span<long>(halves).first(10), [](long v) { return v; }));
+
+        cpp17::inclusive_scan(par, cpp17::span<long>(halves), cpp17::span<long>(halves));
+        TEST_TRUE("parallel in-place inclusive_scan", halves[99] == 5050 && halves.back() == 10000L * 10001 / 2);
+
+        // a grain at least as large as the input is a single chunk
+        auto whole = cpp17::execution::par.on(pool).with_grain(std::numeric_limits<std::size_t>::max());
+        std::vector<long> ones(1000, 1);
+        cpp17::for_each(whole, cpp17::span<long>(ones), [](long& v) { v += 1; });
+        TEST_TRUE("huge grain for_each", ones.front() == 2 && ones.back() == 2);
+        TEST_TRUE("huge grain reduce", (cpp17::reduce(whole, cpp17::span<const long>(ones), 0L) == 2000 && cpp17::reduce(par.with_grain(ones.size()), cpp17::span<const long>(ones), 0L) == 2000));
+        cpp17::inclusive_scan(whole, cpp17::span<long>(ones), cpp17::span<long>(ones));
+        TEST_TRUE("huge grain inclusive_scan", ones.back() == 2000);
+
+        std::vector<int> keys(5000);
+        for (std::size_t i = 0; i < keys.size(); ++i) keys[i] = static_cast<int>(i * 7919 % 5000);
+        cpp17::sort(par, cpp17::span<int>(keys));
+        TEST_TRUE("parallel sort", std::is_sorted(keys.begin(), keys.end()) && keys.back() == 4999);
+
+        std::atomic<int> calls(0);
+        TEST_THROW("parallel exceptions reach the caller", cpp17::for_each(par, cpp17::span<long>(values), [&](long&) {
+            if (++calls == 500) throw std::runtime_error("stop");
+        }));
+    }
+
+    {
+        TEST_TRUE("byteswap", cpp17::byteswap(std::uint32_t(0x01020304)) == 0x04030201 && cpp17::byteswap(std::int16_t(0x0102)) == 0x0201);
+
+        cpp17::byte buffer[64];
+        cpp17::span_writer writer{cpp17::span<cpp17::byte>(buffer)};
+        writer.write(std::uint32_t(0x01020304));
+        writer.write<cpp17::endian::big>(std::uint16_t(0x0506));
+        writer.write_fields(std::uint8_t(7), -1.5, std::int32_t(-3));
+        writer.write_varint(300);
+        writer.write_signed_varint(-65);
+        writer.write_string<std::uint16_t>("name");
+        auto length = writer.skip(1);
+        writer.write_varint_string("tail");
+        length[0] = static_cast<cpp17::byte>(5);
+        auto bytes = writer.written();
+        TEST_TRUE("span_writer byte order", cpp17::to_integer<int>(bytes[0]) == 4 && cpp17::to_integer<int>(bytes[4]) == 5 && cpp17::to_integer<int>(bytes[5]) == 6);
+        TEST_THROW("span_writer overflow", writer.write_string(std::string(64, 'x')));
+
+        cpp17::span_reader reader{cpp17::span<const cpp17::byte>(bytes)};
+        TEST_TRUE("span_reader integers", (reader.read<std::uint32_t>() == 0x01020304 && reader.read<std::uint16_t, cpp17::endian::big>() == 0x0506));
+        auto fields = reader.read_fields<std::uint8_t, double, std::int32_t>();
+        TEST_TRUE("span_reader fields", std::get<0>(fields) == 7 && std::get<1>(fields) == -1.5 && std::get<2>(fields) == -3);
+        TEST_TRUE("span_reader varints", reader.read_varint() == 300 && reader.read_signed_varint() == -65);
+        auto name = reader.read_string<std::uint16_t>();
+        TEST_TRUE("span_reader strings point into the buffer", name == cpp17::string_view("name") && reinterpret_cast<const cpp17::byte*>(name.data()) == bytes.data() + 25);
+        auto rest = reader.read_reader(reader.read<std::uint8_t>());
+        TEST_TRUE("span_reader sub-reader", rest.read_varint_string() == cpp17::string_view("tail") && rest.empty() && reader.empty());
+        TEST_THROW("span_reader past the end", reader.read<std::uint8_t>());
+
+        cpp17::byte overlong[11] = {};
+        for (int i = 0; i < 10; ++i) overlong[i] = static_cast<cpp17::byte>(0xff);
+        TEST_THROW("varint longer than 64 bits", cpp17::span_reader(cpp17::span<const cpp17::byte>(overlong)).read_varint());
+        TEST_THROW("truncated varint", cpp17::span_reader(cpp17::span<const cpp17::byte>(overlong, 3)).read_varint());
+    }
 }